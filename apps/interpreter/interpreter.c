@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sysbvm/orderedCollection.h>
 #include <sysbvm/context.h>
@@ -99,11 +100,22 @@ int doMain(int startArgumentIndex, int argc, const char *argv[])
             else if(!strcmp(argv[i], "-m32") ||
                 !strcmp(argv[i], "-m64") ||
                 !strcmp(argv[i], "-nojit") ||
-                !strcmp(argv[i], "-nogc")
+                !strcmp(argv[i], "-nogc") ||
+                !strcmp(argv[i], "-jit-perf-map") ||
+                !strcmp(argv[i], "-jit-perf-dump")
             )
             {
                 // These options are parsed before the context creation.
             }
+            else if(!strcmp(argv[i], "-jit-invocation-threshold") ||
+                !strcmp(argv[i], "-jit-back-edge-threshold") ||
+                !strcmp(argv[i], "-jit-debug-info") ||
+                !strcmp(argv[i], "-method-lookup-cache-size")
+            )
+            {
+                // These options are parsed before the context creation.
+                ++i;
+            }
         }
         else
         {
@@ -220,6 +232,26 @@ int main(int argc, const char *argv[])
                 contextOptions.gcType = SYSBVM_GC_TYPE_MOVING;
             else if(!strcmp(argv[i], "-non-moving-gc"))
                 contextOptions.gcType = SYSBVM_GC_TYPE_NON_MOVING;
+            else if(!strcmp(argv[i], "-jit-invocation-threshold") && i + 1 < argc)
+                contextOptions.jitInvocationThreshold = (uint32_t)atoi(argv[++i]);
+            else if(!strcmp(argv[i], "-jit-back-edge-threshold") && i + 1 < argc)
+                contextOptions.jitBackEdgeThreshold = (uint32_t)atoi(argv[++i]);
+            else if(!strcmp(argv[i], "-jit-debug-info") && i + 1 < argc)
+            {
+                const char *level = argv[++i];
+                if(!strcmp(level, "none"))
+                    contextOptions.jitDebugInfoLevel = SYSBVM_JIT_DEBUG_INFO_NONE;
+                else if(!strcmp(level, "unwind"))
+                    contextOptions.jitDebugInfoLevel = SYSBVM_JIT_DEBUG_INFO_UNWIND;
+                else if(!strcmp(level, "full"))
+                    contextOptions.jitDebugInfoLevel = SYSBVM_JIT_DEBUG_INFO_FULL;
+            }
+            else if(!strcmp(argv[i], "-jit-perf-map"))
+                contextOptions.jitPerfMap = true;
+            else if(!strcmp(argv[i], "-jit-perf-dump"))
+                contextOptions.jitPerfJitDump = true;
+            else if(!strcmp(argv[i], "-method-lookup-cache-size") && i + 1 < argc)
+                contextOptions.methodLookupCacheSize = (uint32_t)atoi(argv[++i]);
         }
 
         context = sysbvm_context_createWithOptions(&contextOptions);
@@ -55,6 +55,7 @@ typedef enum sysbvm_opcode_e
     SYSBVM_OPCODE_MAKE_CLOSURE_WITH_CAPTURES = 0xA0, /// <Result> := makeClosureWithCapture <FunctionDefinition> <Captures>..
     SYSBVM_OPCODE_MAKE_DICTIONARY_WITH_ELEMENTS = 0xB0, /// <Result> := makeDictionaryWithElements <Elements>...
     SYSBVM_OPCODE_MAKE_TUPLE_WITH_ELEMENTS = 0xC0, /// <Result> := makeTupleWithElements <Elements>...
+    SYSBVM_OPCODE_SEND_VIRTUAL = 0xD0, /// <Result> := sendVirtual <VirtualTableIndex> <Selector> <Receiver> <Arguments>...
 
     SYSBVM_OPCODE_CASE_JUMP = 0xE0, /// caseJump <Value> <Key>... <Destination>... <DefaultDestination>
 
@@ -98,6 +99,14 @@ typedef struct sysbvm_functionBytecode_s
     sysbvm_tuple_t jittedCodeTrampoline;
     sysbvm_tuple_t jittedCodeTrampolineWritePointer;
     sysbvm_tuple_t jittedCodeTrampolineSessionToken;
+
+    sysbvm_tuple_t jittedOsrEntryPoint;
+    sysbvm_tuple_t jittedOsrTargets;
+
+    sysbvm_tuple_t jittedRegisterArgumentsEntryPoint;
+
+    sysbvm_tuple_t invocationCount;
+    sysbvm_tuple_t backEdgeCount;
 } sysbvm_functionBytecode_t;
 
 typedef struct sysbvm_stackFrameBytecodeFunctionActivationRecord_s sysbvm_stackFrameBytecodeFunctionActivationRecord_t;
@@ -108,9 +117,21 @@ SYSBVM_API uint8_t sysbvm_bytecodeInterpreter_offsetOperandCountForOpcode(uint8_
 
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_apply(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitTrampolineDestination(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments);
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitUnlinkedTrampolineDestination(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments);
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination0(sysbvm_context_t *context, sysbvm_tuple_t function);
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination1(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0);
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination2(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1);
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination3(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1, sysbvm_tuple_t argument2);
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination4(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1, sysbvm_tuple_t argument2, sysbvm_tuple_t argument3);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_getSourcePositionForActivationRecord(sysbvm_context_t *context, sysbvm_stackFrameBytecodeFunctionActivationRecord_t *activationRecord);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_getSourcePositionForJitActivationRecord(sysbvm_context_t *context, sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t *activationRecord);
 
+/**
+ * Redirects the jitted call sites that are linked to a function bytecode into the generic function application, since the function no longer uses it.
+ */
+SYSBVM_API void sysbvm_functionBytecode_unlinkJittedCode(sysbvm_context_t *context, sysbvm_tuple_t functionBytecode);
+
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_functionApplyNoCopyArguments(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments, sysbvm_bitflags_t applicationFlags);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendNoCopyArguments(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t receiverType, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags);
@@ -282,6 +282,11 @@ SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_send(sysbvm_context_t
  */
 SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_sendWithLookupReceiverType(sysbvm_context_t *context, sysbvm_functionBytecodeAssembler_t *assembler, sysbvm_tuple_t result, sysbvm_tuple_t receiverLookupType, sysbvm_tuple_t selector, sysbvm_tuple_t receiver, sysbvm_tuple_t arguments);
 
+/**
+ * Send through a virtual table index instruction.
+ */
+SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_sendVirtual(sysbvm_context_t *context, sysbvm_functionBytecodeAssembler_t *assembler, sysbvm_tuple_t result, sysbvm_tuple_t virtualTableIndex, sysbvm_tuple_t selector, sysbvm_tuple_t receiver, sysbvm_tuple_t arguments);
+
 /**
  * Case jump instruction.
  */
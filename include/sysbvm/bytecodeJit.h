@@ -31,7 +31,11 @@
 #define SYSBVM_JIT_DWARF_LINE_INFO_EMISSION_STATE_MAX_DIRECTORIES 8
 #define SYSBVM_JIT_DWARF_LINE_INFO_EMISSION_STATE_MAX_FILES 8
 
+#define SYSBVM_JIT_MAX_CACHED_LOCAL_COUNT 5
+#define SYSBVM_JIT_CACHED_LOCAL_MIN_USE_COUNT 3
+
 typedef sysbvm_tuple_t (*sysbvm_bytecodeJit_entryPoint) (sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments);
+typedef sysbvm_tuple_t (*sysbvm_bytecodeJit_osrEntryPoint) (sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments, sysbvm_tuple_t *localVector, void *resumeAddress);
 
 typedef enum sysbvm_bytecodeJitRelocationType_e
 {
@@ -54,6 +58,32 @@ typedef struct sysbvm_bytecodeJitPCRelocation_s
     intptr_t addend;
 } sysbvm_bytecodeJitPCRelocation_t;
 
+typedef enum sysbvm_bytecodeJitIntegerOperation_e
+{
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_ADD,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_SUBTRACT,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_MULTIPLY,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_AND,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_OR,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_XOR,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_EQUALS,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_NOT_EQUALS,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_THAN,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_EQUALS,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_THAN,
+    SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_EQUALS,
+} sysbvm_bytecodeJitIntegerOperation_t;
+
+/**
+ * An integer primitive whose immediate operands can be handled inline in jitted code.
+ */
+typedef struct sysbvm_bytecodeJitIntegerPrimitive_s
+{
+    sysbvm_bytecodeJitIntegerOperation_t operation;
+    uint8_t tag;
+    bool isSigned;
+} sysbvm_bytecodeJitIntegerPrimitive_t;
+
 typedef struct sysbvm_bytecodeJitSourcePositionRecord_s
 {
     size_t pc;
@@ -104,6 +134,11 @@ typedef struct sysbvm_bytecodeJit_s
     int32_t stackCallReservationSize;
     int32_t cfiFrameOffset;
 
+    // The functions with few arguments also have an entry that receives them in registers. Their arguments are then kept in the frame.
+    bool hasRegisterArgumentsEntryPoint;
+    int32_t inlineArgumentVectorOffset;
+    size_t registerArgumentsEntryJoinOffset;
+
     sysbvm_dynarray_t objectFileHeader;
     sysbvm_dynarray_t instructions;
     sysbvm_dynarray_t constants;
@@ -118,11 +153,26 @@ typedef struct sysbvm_bytecodeJit_s
     size_t objectFileContentJittedFunctionNameOffset;
     size_t prologueSize;
 
+    // The secondary entry points repeat the prologue after the body. Each one gets its own Windows function table entry.
+    size_t secondaryPrologueOffsets[2];
+    size_t secondaryPrologueCount;
+
+    // The debug information level that is actually emitted for this function.
+    int debugInfoLevel;
+    bool emitsPerfMapSymbol;
+    bool emitsPerfJitDump;
+
     sysbvm_jit_dwarfLineInfoEmissionState_t dwarfLineEmissionState;
 
     intptr_t *pcDestinations;
 
+    // The most used locals, which are also kept in callee saved registers.
+    size_t cachedLocalCount;
+    int16_t cachedLocalIndices[SYSBVM_JIT_MAX_CACHED_LOCAL_COUNT];
+
+    struct sysbvm_heap_codeBlock_s *codeBlock;
     sysbvm_tuple_t *literalVectorGCRoot;
+    sysbvm_tuple_t *functionBytecodeGCRoot;
 } sysbvm_bytecodeJit_t;
 
 static inline size_t sysbvm_sizeAlignedTo(size_t pointer, size_t alignment)
@@ -152,6 +202,9 @@ SYSBVM_API void sysbvm_bytecodeJit_addRelocation(sysbvm_bytecodeJit_t *jit, sysb
 SYSBVM_API void sysbvm_bytecodeJit_jitFree(sysbvm_bytecodeJit_t *jit);
 SYSBVM_API bool sysbvm_bytecodeJit_getLiteralValueForOperand(sysbvm_bytecodeJit_t *jit, int16_t operand, sysbvm_tuple_t *outLiteralValue);
 
+SYSBVM_API bool sysbvm_bytecodeJit_getIntegerPrimitiveForFunction(sysbvm_bytecodeJit_t *jit, sysbvm_tuple_t function, sysbvm_bytecodeJitIntegerPrimitive_t *outPrimitive);
+SYSBVM_API bool sysbvm_bytecodeJit_getIntegerPrimitiveForSelector(sysbvm_bytecodeJit_t *jit, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_bytecodeJitIntegerPrimitive_t *outPrimitive);
+
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeJit_slotAt(sysbvm_context_t *context, sysbvm_tuple_t tuple, sysbvm_tuple_t typeSlot);
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeJit_slotReferenceAt(sysbvm_context_t *context, sysbvm_tuple_t tuple, sysbvm_tuple_t typeSlot);
 SYSBVM_API void sysbvm_bytecodeJit_slotAtPut(sysbvm_context_t *context, sysbvm_tuple_t tuple, sysbvm_tuple_t typeSlot, sysbvm_tuple_t value);
@@ -162,8 +215,15 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeJit_symbolValueBinding_getValue(sysbvm_
 
 SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functionBytecode_t *functionBytecode);
 
+/**
+ * Emits the full debug information for the functions that are compiled from now on, without waiting for a debugger to be attached.
+ */
+SYSBVM_API void sysbvm_bytecodeJit_requestFullDebugInfo(sysbvm_context_t *context);
+
 // Backend specific methods.
 SYSBVM_API void sysbvm_jit_prologue(sysbvm_bytecodeJit_t *jit);
+SYSBVM_API void sysbvm_jit_osrEntryPrologue(sysbvm_bytecodeJit_t *jit);
+SYSBVM_API void sysbvm_jit_registerArgumentsEntryPrologue(sysbvm_bytecodeJit_t *jit);
 SYSBVM_API bool sysbvm_jit_emitDebugLineInfo(sysbvm_bytecodeJit_t *jit);
 SYSBVM_API void sysbvm_jit_finish(sysbvm_bytecodeJit_t *jit);
 SYSBVM_API uint8_t *sysbvm_jit_installIn(sysbvm_bytecodeJit_t *jit, uint8_t *codeWriteablePointer, uint8_t *codeExecutablePointer);
@@ -178,13 +238,19 @@ SYSBVM_API void sysbvm_jit_callWithContext2(sysbvm_bytecodeJit_t *jit, void *fun
 SYSBVM_API void sysbvm_jit_callWithContextNoResult2(sysbvm_bytecodeJit_t *jit, void *functionPointer, int16_t argumentOperand0, int16_t argumentOperand1);
 SYSBVM_API void sysbvm_jit_callWithContextNoResult3(sysbvm_bytecodeJit_t *jit, void *functionPointer, int16_t argumentOperand0, int16_t argumentOperand1, int16_t argumentOperand2);
 
-SYSBVM_API void sysbvm_jit_patchTrampolineWithRealEntryPoint(sysbvm_bytecodeJit_t *jit, sysbvm_functionBytecode_t *bytecode);
+SYSBVM_API void sysbvm_jit_slotAt(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t tupleOperand, int16_t typeSlotOperand, bool isReference);
+SYSBVM_API void sysbvm_jit_slotAtPut(sysbvm_bytecodeJit_t *jit, int16_t tupleOperand, int16_t typeSlotOperand, int16_t valueOperand, bool isReference);
+
+SYSBVM_API void sysbvm_jit_patchTrampolineWithRealEntryPoint(sysbvm_context_t *context, sysbvm_functionBytecode_t *bytecode);
+SYSBVM_API void sysbvm_jit_unlinkTrampoline(sysbvm_context_t *context, sysbvm_functionBytecode_t *bytecode);
 SYSBVM_API void sysbvm_jit_functionApply(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags);
 SYSBVM_API void sysbvm_jit_send(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags);
 SYSBVM_API void sysbvm_jit_sendWithReceiverType(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t receiverTypeOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags);
+SYSBVM_API void sysbvm_jit_sendVirtual(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t virtualTableIndexOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags);
 SYSBVM_API void sysbvm_jit_makeArray(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, size_t elementCount, int16_t *elementOperands);
 SYSBVM_API void sysbvm_jit_makeByteArray(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, size_t elementCount, int16_t *elementOperands);
 SYSBVM_API void sysbvm_jit_makeDictionary(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, size_t elementCount, int16_t *elementOperands);
+SYSBVM_API void sysbvm_jit_makeAssociation(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t keyOperand, int16_t valueOperand);
 SYSBVM_API void sysbvm_jit_makeClosureWithCaptures(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionDefinitionOperand, size_t captureCount, int16_t *elementOperands);
 SYSBVM_API void sysbvm_jit_jumpRelative(sysbvm_bytecodeJit_t *jit, size_t targetPC);
 SYSBVM_API void sysbvm_jit_jumpRelativeIfTrue(sysbvm_bytecodeJit_t *jit, int16_t conditionOperand, size_t targetPC);
@@ -17,6 +17,16 @@ typedef sysbvm_tuple_t (*sysbvm_functionEntryPoint_t)(sysbvm_context_t *context,
 #define SYSBVM_GC_TYPE_NON_MOVING 2
 #define SYSBVM_GC_TYPE_DISABLED 3
 
+#define SYSBVM_JIT_DEFAULT_INVOCATION_THRESHOLD 2
+#define SYSBVM_JIT_DEFAULT_BACK_EDGE_THRESHOLD 64
+
+#define SYSBVM_DEFAULT_METHOD_LOOKUP_CACHE_SIZE 4096
+
+#define SYSBVM_JIT_DEBUG_INFO_DEFAULT 0
+#define SYSBVM_JIT_DEBUG_INFO_NONE 1
+#define SYSBVM_JIT_DEBUG_INFO_UNWIND 2
+#define SYSBVM_JIT_DEBUG_INFO_FULL 3
+
 typedef struct sysbvm_contextCreationOptions_s
 {
     uint32_t targetWordSize;
@@ -43,6 +53,12 @@ typedef struct sysbvm_contextCreationOptions_s
     const char *targetExceptionHandlingTableFormatName;
     bool nojit;
     int gcType;
+    uint32_t jitInvocationThreshold;
+    uint32_t jitBackEdgeThreshold;
+    int jitDebugInfoLevel;
+    bool jitPerfMap;
+    bool jitPerfJitDump;
+    uint32_t methodLookupCacheSize;
 } sysbvm_contextCreationOptions_t;
 
 /**
@@ -86,6 +102,16 @@ SYSBVM_API sysbvm_object_tuple_t *sysbvm_context_allocateByteTuple(sysbvm_contex
  */
 SYSBVM_API sysbvm_object_tuple_t *sysbvm_context_allocatePointerTuple(sysbvm_context_t *context, sysbvm_tuple_t type, size_t slotCount);
 
+/**
+ * Allocates a byte tuple with the specified size in the bump pointer allocation buffer.
+ */
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_context_allocateByteTupleInAllocationBuffer(sysbvm_context_t *context, sysbvm_tuple_t type, size_t byteSize);
+
+/**
+ * Allocates a pointer tuple with the specified slot count in the bump pointer allocation buffer.
+ */
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_context_allocatePointerTupleInAllocationBuffer(sysbvm_context_t *context, sysbvm_tuple_t type, size_t slotCount);
+
 /**
  * Performs a shallow copy of a tuple
  */
@@ -14,8 +14,20 @@ typedef struct sysbvm_dictionary_s
     sysbvm_tuple_t storage;
 } sysbvm_dictionary_t;
 
-typedef sysbvm_dictionary_t sysbvm_identityDictionary_t;
-typedef sysbvm_dictionary_t sysbvm_methodDictionary_t;
+typedef struct sysbvm_identityDictionary_s
+{
+    sysbvm_dictionary_t super;
+    sysbvm_tuple_t controlBytes;
+} sysbvm_identityDictionary_t;
+
+typedef struct sysbvm_methodDictionary_s
+{
+    sysbvm_tuple_header_t header;
+    sysbvm_tuple_t size;
+    sysbvm_tuple_t storage;
+    sysbvm_tuple_t controlBytes;
+} sysbvm_methodDictionary_t;
+
 typedef sysbvm_dictionary_t sysbvm_weakValueDictionary_t;
 
 typedef size_t (*sysbvm_dictionary_explicitHashFunction_t)(void *element);
@@ -459,6 +459,12 @@ typedef struct sysbvm_dwarf_cfi_builder_s {
     bool hasFramePointerRegister;
 
     bool isInPrologue;
+
+    // The body state that is saved while describing a secondary prologue.
+    size_t rememberedStackFrameSize;
+    size_t rememberedFramePointerRegister;
+    size_t rememberedStackFrameSizeAtFramePointer;
+    bool rememberedHasFramePointerRegister;
 } sysbvm_dwarf_cfi_builder_t;
 
 typedef struct sysbvm_dwarf_lineProgramHeader_s {
@@ -534,6 +540,9 @@ SYSBVM_API void sysbvm_dwarf_cfi_pushRegister(sysbvm_dwarf_cfi_builder_t *cfi, u
 SYSBVM_API void sysbvm_dwarf_cfi_saveFramePointerInRegister(sysbvm_dwarf_cfi_builder_t *cfi, uintptr_t reg, intptr_t offset);
 SYSBVM_API void sysbvm_dwarf_cfi_stackSizeAdvance(sysbvm_dwarf_cfi_builder_t *cfi, size_t pc, size_t increment);
 SYSBVM_API void sysbvm_dwarf_cfi_endPrologue(sysbvm_dwarf_cfi_builder_t *cfi);
+SYSBVM_API void sysbvm_dwarf_cfi_restoreRegister(sysbvm_dwarf_cfi_builder_t *cfi, uintptr_t reg);
+SYSBVM_API void sysbvm_dwarf_cfi_beginSecondaryPrologue(sysbvm_dwarf_cfi_builder_t *cfi, size_t pc);
+SYSBVM_API void sysbvm_dwarf_cfi_endSecondaryPrologue(sysbvm_dwarf_cfi_builder_t *cfi, size_t pc);
 
 SYSBVM_API void sysbvm_dwarf_debugInfo_create(sysbvm_dwarf_debugInfo_builder_t *builder);
 SYSBVM_API void sysbvm_dwarf_debugInfo_finish(sysbvm_dwarf_debugInfo_builder_t *builder);
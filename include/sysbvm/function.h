@@ -276,6 +276,11 @@ SYSBVM_INLINE bool sysbvm_function_isCorePrimitive(sysbvm_context_t *context, sy
  */
 SYSBVM_API sysbvm_tuple_t sysbvm_function_apply(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments, sysbvm_bitflags_t applicationFlags);
 
+/**
+ * Applies an ordinary function directly through its primitive or bytecode, skipping the lazy analysis and memoization checks.
+ */
+SYSBVM_API sysbvm_tuple_t sysbvm_ordinaryFunction_directApply(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments, sysbvm_bitflags_t applicationFlags);
+
 SYSBVM_INLINE sysbvm_tuple_t sysbvm_function_apply0(sysbvm_context_t *context, sysbvm_tuple_t function)
 {
     return sysbvm_function_apply(context, function, 0, 0, 0);
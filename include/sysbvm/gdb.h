@@ -2,6 +2,7 @@
 #define SYSBVM_GDB_H
 
 #include "common.h"
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -33,4 +34,9 @@ typedef struct sysbvm_gdb_jit_descriptor_s
 SYSBVM_API void sysbvm_gdb_registerObjectFile(sysbvm_gdb_jit_code_entry_t *entry, const void *objectFileAddress, size_t objectFileSize);
 SYSBVM_API void sysbvm_gdb_unregisterObjectFile(sysbvm_gdb_jit_code_entry_t *entry);
 
+/**
+ * Is a debugger currently tracing this process?
+ */
+SYSBVM_API bool sysbvm_gdb_isDebuggerAttached(void);
+
 #endif //SYSBVM_GDB_H
@@ -17,6 +17,16 @@ SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocateByteTuple(sysbvm_heap_t *h
  */
 SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocatePointerTuple(sysbvm_heap_t *heap, size_t slotCount);
 
+/**
+ * Allocates a byte tuple with the specified size in the bump pointer allocation buffer.
+ */
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocateByteTupleInAllocationBuffer(sysbvm_heap_t *heap, size_t byteSize);
+
+/**
+ * Allocates a pointer tuple with the specified slot count in the bump pointer allocation buffer.
+ */
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocatePointerTupleInAllocationBuffer(sysbvm_heap_t *heap, size_t slotCount);
+
 /**
  * Performs a shallow copy of the specified tuple.
  */
@@ -19,6 +19,11 @@ typedef struct sysbvm_orderedCollection_s
  */
 SYSBVM_API sysbvm_tuple_t sysbvm_orderedCollection_create(sysbvm_context_t *context);
 
+/**
+ * Creates an array list whose elements are weak references.
+ */
+SYSBVM_API sysbvm_tuple_t sysbvm_weakOrderedCollection_create(sysbvm_context_t *context);
+
 /**
  * Adds an element to the array slice.
  */
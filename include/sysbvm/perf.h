@@ -0,0 +1,44 @@
+#ifndef SYSBVM_PERF_H
+#define SYSBVM_PERF_H
+
+#include "common.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct sysbvm_perf_jitDumpLineEntry_s
+{
+    uint64_t address;
+    uint32_t line;
+    const char *fileName;
+} sysbvm_perf_jitDumpLineEntry_t;
+
+typedef struct sysbvm_perf_jitDumpCodeLoad_s
+{
+    uint32_t elfMachine;
+    const char *name;
+    uint64_t codeAddress;
+    const uint8_t *code;
+    size_t codeSize;
+
+    size_t lineEntryCount;
+    const sysbvm_perf_jitDumpLineEntry_t *lineEntries;
+
+    // The eh_frame section of the function, with a single CIE and FDE.
+    const uint8_t *ehFrame;
+    size_t ehFrameSize;
+    size_t ehFrameFdeOffset;
+    size_t ehFrameFdeInitialLocationOffset;
+} sysbvm_perf_jitDumpCodeLoad_t;
+
+/**
+ * Appends a jitted function symbol into /tmp/perf-<pid>.map
+ */
+SYSBVM_API void sysbvm_perf_writeMapEntry(uint64_t codeAddress, size_t codeSize, const char *name);
+
+/**
+ * Appends the line, unwinding and code load records of a jitted function into the /tmp/jit-<pid>.dump file that is read by perf inject --jit.
+ */
+SYSBVM_API void sysbvm_perf_writeJitDumpCodeLoad(const sysbvm_perf_jitDumpCodeLoad_t *codeLoad);
+
+#endif //SYSBVM_PERF_H
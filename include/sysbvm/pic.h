@@ -8,6 +8,8 @@
 
 #define SYSBVM_PIC_ENTRY_COUNT 4
 
+typedef struct sysbvm_context_s sysbvm_context_t;
+
 typedef struct sysbvm_picEntry_s
 {
     sysbvm_tuple_t selector;
@@ -20,11 +22,29 @@ typedef struct sysbvm_pic_s
     atomic_uint preSequence;
     atomic_uint postSequence;
     sysbvm_picEntry_t entries[SYSBVM_PIC_ENTRY_COUNT];
+
+    // Monomorphic inline cache that is checked directly by the jitted code.
+    sysbvm_picEntry_t inlineCacheEntry;
+    void *inlineCacheEntryPoint;
+
+    // Keeps the code of the inline cache entry point alive.
+    sysbvm_tuple_t inlineCacheEntryPointOwner;
+
+    // The selector under which this PIC is registered for invalidation, and the next PIC in the same registry bucket.
+    sysbvm_context_t *dependencyContext;
+    sysbvm_tuple_t dependencySelector;
+    bool hasMultipleSelectorDependencies;
+    struct sysbvm_pic_s *nextDependency;
 } sysbvm_pic_t;
 
 SYSBVM_API bool sysbvm_pic_lookupTypeAndSelector(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t *outMethod);
-SYSBVM_API void sysbvm_pic_addSelectorTypeAndMethod(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method);
+SYSBVM_API void sysbvm_pic_addSelectorTypeAndMethod(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method);
 SYSBVM_API void sysbvm_pic_flushSelector(sysbvm_pic_t *pic, sysbvm_tuple_t selector);
+SYSBVM_API void sysbvm_pic_flushSelectorDependencies(sysbvm_context_t *context, sysbvm_tuple_t selector);
+SYSBVM_API void sysbvm_pic_flush(sysbvm_pic_t *pic);
+SYSBVM_API void sysbvm_pic_flushAllDependencies(sysbvm_context_t *context);
+SYSBVM_API void sysbvm_pic_unregisterDependencies(sysbvm_pic_t *pic);
+SYSBVM_API void sysbvm_pic_setInlineCache(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method, void *entryPoint, sysbvm_tuple_t entryPointOwner);
 SYSBVM_API unsigned int sysbvm_pic_writeLock(sysbvm_pic_t *pic);
 SYSBVM_API void sysbvm_pic_writeUnlock(sysbvm_pic_t *pic, unsigned int sequence);
 
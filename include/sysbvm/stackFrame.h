@@ -47,7 +47,7 @@ typedef struct sysbvm_stackFrameFunctionActivationRecord_s
 } sysbvm_stackFrameFunctionActivationRecord_t;
 
 #define SYSBVM_BYTECODE_FUNCTION_OPERAND_REGISTER_FILE_SIZE 64
-#define SYSBVM_BYTECODE_FUNCTION_MAX_CALL_ARGUMENTS 16
+#define SYSBVM_BYTECODE_FUNCTION_MAX_CALL_ARGUMENTS SYSBVM_BYTECODE_FUNCTION_OPERAND_REGISTER_FILE_SIZE
 
 typedef struct sysbvm_stackFrameBytecodeFunctionActivationRecord_s
 {
@@ -85,6 +85,7 @@ typedef struct sysbvm_stackFrameBytecodeFunctionJitActivationRecord_s
     sysbvm_tuple_t literalVector;
     sysbvm_tuple_t captureVector;
     sysbvm_tuple_t function;
+    sysbvm_tuple_t functionBytecode;
     size_t argumentCount;
     sysbvm_tuple_t *arguments;
 
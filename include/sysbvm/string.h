@@ -72,6 +72,11 @@ SYSBVM_API size_t sysbvm_string_computeHashWithBytes(size_t size, const uint8_t
  */
 SYSBVM_API size_t sysbvm_string_hash(sysbvm_tuple_t string);
 
+/**
+ * The hash for string, which is remembered for the immutable strings.
+ */
+SYSBVM_API size_t sysbvm_string_hashWithCache(sysbvm_context_t *context, sysbvm_tuple_t string);
+
 /**
  * The equals comparison for a string.
  */
@@ -87,6 +92,51 @@ SYSBVM_API bool sysbvm_string_equalsCString(sysbvm_tuple_t string, const char *c
  */
 SYSBVM_API bool sysbvm_string_endsWithCString(sysbvm_tuple_t string, const char *cstring);
 
+/**
+ * Finds the first occurrence of a byte, starting at the specified index. Returns -1 when it is not found.
+ */
+SYSBVM_API intptr_t sysbvm_string_indexOfByte(size_t size, const uint8_t *bytes, uint8_t byte, size_t startIndex);
+
+/**
+ * Finds the last occurrence of a byte. Returns -1 when it is not found.
+ */
+SYSBVM_API intptr_t sysbvm_string_lastIndexOfByte(size_t size, const uint8_t *bytes, uint8_t byte);
+
+/**
+ * Counts the occurrences of a byte.
+ */
+SYSBVM_API size_t sysbvm_string_countByte(size_t size, const uint8_t *bytes, uint8_t byte);
+
+/**
+ * Finds the first occurrence of a substring, starting at the specified index. Returns -1 when it is not found.
+ */
+SYSBVM_API intptr_t sysbvm_string_indexOfSubstring(size_t size, const uint8_t *bytes, size_t substringSize, const uint8_t *substring, size_t startIndex);
+
+/**
+ * Finds the last occurrence of a substring. Returns -1 when it is not found.
+ */
+SYSBVM_API intptr_t sysbvm_string_lastIndexOfSubstring(size_t size, const uint8_t *bytes, size_t substringSize, const uint8_t *substring);
+
+/**
+ * Gets the index of the first different byte in two byte sequences, or their size when they are equal.
+ */
+SYSBVM_API size_t sysbvm_string_mismatchIndex(size_t size, const uint8_t *first, const uint8_t *second);
+
+/**
+ * Compares two byte sequences lexicographically. Returns -1, 0 or 1.
+ */
+SYSBVM_API int32_t sysbvm_string_compareBytes(size_t firstSize, const uint8_t *first, size_t secondSize, const uint8_t *second);
+
+/**
+ * Compares two byte sequences of the same size, ignoring the case of the ASCII letters.
+ */
+SYSBVM_API bool sysbvm_string_equalsIgnoringCase(size_t size, const uint8_t *first, const uint8_t *second);
+
+/**
+ * Finds the first byte that is (or is not) one of the class bytes, starting at the specified index. Returns -1 when it is not found.
+ */
+SYSBVM_API intptr_t sysbvm_string_indexOfByteInClass(size_t size, const uint8_t *bytes, size_t classSize, const uint8_t *classBytes, bool isMember, size_t startIndex);
+
 /**
  * The primitive string hash function.
  */ 
@@ -7,11 +7,17 @@
 
 typedef struct sysbvm_context_s sysbvm_context_t;
 
+/**
+ * A string stream is a list of chunks that is flattened once when the final string is requested.
+ * The chunks in the chunk list are always full, and storage is the chunk that is being filled.
+ */
 typedef struct sysbvm_stringStream_s
 {
     sysbvm_tuple_header_t header;
     sysbvm_tuple_t size;
     sysbvm_tuple_t storage;
+    sysbvm_tuple_t chunks;
+    sysbvm_tuple_t chunkedSize;
 } sysbvm_stringStream_t;
 
 /**
@@ -39,6 +45,16 @@ SYSBVM_API void sysbvm_stringStream_nextPutStringWithSize(sysbvm_context_t *cont
  */
 SYSBVM_API void sysbvm_stringStream_nextPutCString(sysbvm_context_t *context, sysbvm_tuple_t stringStream, const char *cstring);
 
+/**
+ * Adds a string to a generic stream. String streams receive the string directly, without creating an intermediate string.
+ */
+SYSBVM_API void sysbvm_stream_nextPutStringWithSize(sysbvm_context_t *context, sysbvm_tuple_t stream, size_t stringSize, const char *string);
+
+/**
+ * Adds a string to a generic stream.
+ */
+SYSBVM_API void sysbvm_stream_nextPutString(sysbvm_context_t *context, sysbvm_tuple_t stream, sysbvm_tuple_t string);
+
 /**
  * Construct a byte array with the contents from the string stream.
  */
@@ -208,6 +208,15 @@ SYSBVM_INLINE bool sysbvm_tuple_isImmediate(sysbvm_tuple_t tuple)
     return (tuple & SYSBVM_TUPLE_TAG_BIT_MASK) != SYSBVM_TUPLE_TAG_POINTER;
 }
 
+/**
+ * Is this an immediate tuple that is only equal to the immediates with the same tag when they are identical?
+ */
+SYSBVM_INLINE bool sysbvm_tuple_isIdentityComparableImmediate(sysbvm_tuple_t tuple)
+{
+    sysbvm_tuple_t tag = tuple & SYSBVM_TUPLE_TAG_BIT_MASK;
+    return tag != SYSBVM_TUPLE_TAG_POINTER && tag != SYSBVM_TUPLE_TAG_FLOAT32 && tag != SYSBVM_TUPLE_TAG_FLOAT64;
+}
+
 /**
  * Gets the size in bytes of the specified tuple.
  */
@@ -1034,6 +1043,31 @@ SYSBVM_INLINE size_t sysbvm_tuple_anySize_decode(sysbvm_tuple_t tuple)
     return 0;
 }
 
+/**
+ * The comparison performed by a hash or equality function.
+ */
+typedef enum sysbvm_tuple_comparisonKind_e
+{
+    SYSBVM_TUPLE_COMPARISON_KIND_GENERIC = 0,
+    SYSBVM_TUPLE_COMPARISON_KIND_IDENTITY,
+    SYSBVM_TUPLE_COMPARISON_KIND_BYTES,
+} sysbvm_tuple_comparisonKind_t;
+
+/**
+ * Classifies a hash or equality function by its primitive, so that callers can perform the comparison without applying it.
+ */
+SYSBVM_API sysbvm_tuple_comparisonKind_t sysbvm_tuple_getComparisonKindOfFunction(sysbvm_context_t *context, sysbvm_tuple_t function);
+
+/**
+ * Computes the hash of a tuple with an already resolved hash function.
+ */
+SYSBVM_API size_t sysbvm_tuple_hashWith(sysbvm_context_t *context, sysbvm_tuple_t hashFunction, sysbvm_tuple_comparisonKind_t hashKind, sysbvm_tuple_t tuple);
+
+/**
+ * Compares two tuples with an already resolved equality function.
+ */
+SYSBVM_API bool sysbvm_tuple_equalsWith(sysbvm_context_t *context, sysbvm_tuple_t equalsFunction, sysbvm_tuple_comparisonKind_t equalsKind, sysbvm_tuple_t a, sysbvm_tuple_t b);
+
 /**
  * Computes the hash of a tuple
  */
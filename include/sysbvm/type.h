@@ -19,6 +19,17 @@ typedef struct sysbvm_variableValueBox_s
     sysbvm_tuple_t binding;
 } sysbvm_variableValueBox_t;
 
+typedef struct sysbvm_virtualTableLayout_s
+{
+    sysbvm_tuple_header_t header;
+    sysbvm_tuple_t supertypeLayout;
+    sysbvm_tuple_t type;
+    sysbvm_tuple_t size;
+    sysbvm_tuple_t baseIndex;
+    sysbvm_tuple_t selectorToIndexTable;
+    sysbvm_tuple_t newSelectors;
+} sysbvm_virtualTableLayout_t;
+
 typedef struct sysbvm_type_tuple_s
 {
     sysbvm_programEntity_t super;
@@ -40,7 +51,7 @@ typedef struct sysbvm_type_tuple_s
     sysbvm_tuple_t fallbackMethodDictionary;
 
     sysbvm_tuple_t virtualMethodSelectorList;
-    sysbvm_tuple_t virtualTableSelectorDictionary;
+    sysbvm_tuple_t virtualTableLayout;
     sysbvm_tuple_t virtualTable;
     sysbvm_tuple_t gcLayout;
     sysbvm_tuple_t variableDataGCLayout;
@@ -48,6 +59,12 @@ typedef struct sysbvm_type_tuple_s
     sysbvm_tuple_t pendingSlots;
     sysbvm_tuple_t subtypes;
     sysbvm_tuple_t children;
+
+    // Array with the supertype chain from the root down to this type, indexed by depth.
+    sysbvm_tuple_t supertypeDisplay;
+
+    // Array with the method dispatch epoch followed by the selector and method pairs, indexed by virtual table slot.
+    sysbvm_tuple_t dispatchTable;
 } sysbvm_type_tuple_t;
 
 typedef enum sysbvm_typeFlags_e
@@ -445,6 +462,16 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelector(sysbvm_context_t *context,
  */
 SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelectorWithPIC(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector, sysbvm_pic_t *inlineCache);
 
+/**
+ * Performs the lookup of the given selector through the dispatch table slot of its virtual table index.
+ */
+SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector, size_t virtualTableIndex);
+
+/**
+ * Finds the virtual table index of a selector in the virtual table layout computed for a type.
+ */
+SYSBVM_API bool sysbvm_type_findVirtualTableIndexOfSelector(sysbvm_tuple_t type, sysbvm_tuple_t selector, size_t *outVirtualTableIndex);
+
 /**
  * Performs the lookup of the given macro fallback selector.
  */
@@ -461,24 +488,24 @@ SYSBVM_API void sysbvm_type_setMethodWithSelector(sysbvm_context_t *context, sys
 SYSBVM_API void sysbvm_type_buildSlotDictionary(sysbvm_context_t *context, sysbvm_tuple_t type);
 
 /**
- * Is this type a subtype of?
+ * Is the supertype display of this type consistent with its ancestors?
  */
-SYSBVM_INLINE bool sysbvm_type_isDirectSubtypeOf(sysbvm_tuple_t type, sysbvm_tuple_t supertype)
-{
-    if(!sysbvm_tuple_isNonNullPointer(supertype)) return false;
-    if(!sysbvm_tuple_isNonNullPointer(type)) return false;
-    if(sysbvm_tuple_isDummyValue(type)) return false;
+SYSBVM_API bool sysbvm_type_hasValidSupertypeDisplay(sysbvm_tuple_t type);
 
-    while(type)
-    {
-        if(type == supertype)
-            return true;
+/**
+ * Is this type a subtype of?
+ */
+SYSBVM_API bool sysbvm_type_isDirectSubtypeOf(sysbvm_tuple_t type, sysbvm_tuple_t supertype);
 
-        type = ((sysbvm_type_tuple_t *)type)->supertype;
-    }
+/**
+ * Computes the supertype display of a type, if it is missing or out of date.
+ */
+SYSBVM_API void sysbvm_type_ensureSupertypeDisplay(sysbvm_context_t *context, sysbvm_tuple_t type);
 
-    return false;
-}
+/**
+ * Is this type a subtype of? This computes the supertype displays that are used by the constant time check.
+ */
+SYSBVM_API bool sysbvm_type_isSubtypeOf(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t supertype);
 
 /**
  * Gets the name of a type
@@ -511,15 +538,9 @@ SYSBVM_INLINE sysbvm_tuple_t sysbvm_type_getSupertype(sysbvm_tuple_t type)
 }
 
 /**
- * Sets the supertype
+ * Sets the supertype, and discards the method lookups that may depend on the previous one.
  */
-SYSBVM_INLINE void sysbvm_type_setSupertype(sysbvm_tuple_t type, sysbvm_tuple_t supertype)
-{
-    if(!sysbvm_tuple_isNonNullPointer(type)) return;
-    if(sysbvm_tuple_isDummyValue(type)) return;
-    
-    ((sysbvm_type_tuple_t*)type)->supertype = supertype;
-}
+SYSBVM_API void sysbvm_type_setSupertype(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t supertype);
 
 /**
  * Gets the slot names
@@ -673,14 +694,9 @@ SYSBVM_INLINE sysbvm_tuple_t sysbvm_type_getFallbackMethodDictionary(sysbvm_tupl
 }
 
 /**
- * Sets the method dictionary.
+ * Sets the method dictionary, and discards the method lookups that may depend on the previous one.
  */
-SYSBVM_INLINE void sysbvm_type_setMethodDictionary(sysbvm_tuple_t type, sysbvm_tuple_t methodDictionary)
-{
-    if(!sysbvm_tuple_isNonNullPointer(type)) return;
-    if(sysbvm_tuple_isDummyValue(type)) return;
-    ((sysbvm_type_tuple_t*)type)->methodDictionary = methodDictionary;
-}
+SYSBVM_API void sysbvm_type_setMethodDictionary(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t methodDictionary);
 
 /**
  * Gets the equals function of a type
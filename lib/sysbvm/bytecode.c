@@ -36,6 +36,7 @@ void sysbvm_bytecodeInterpreter_ensureTablesAreFilled(void)
     sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_UNCHECKED_CALL >> 4] = 2;
     sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_SEND >> 4] = 3;
     sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_SEND_WITH_LOOKUP >> 4] = 4;
+    sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_SEND_VIRTUAL >> 4] = 4;
 
     sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_MAKE_ARRAY_WITH_ELEMENTS >> 4] = 1;
     sysbvm_implicitVariableBytecodeOperandCountTable[SYSBVM_OPCODE_MAKE_BYTE_ARRAY_WITH_ELEMENTS >> 4] = 1;
@@ -69,6 +70,7 @@ SYSBVM_API uint8_t sysbvm_bytecodeInterpreter_destinationOperandCountForOpcode(u
     case SYSBVM_OPCODE_UNCHECKED_CALL:
     case SYSBVM_OPCODE_SEND:
     case SYSBVM_OPCODE_SEND_WITH_LOOKUP:
+    case SYSBVM_OPCODE_SEND_VIRTUAL:
     case SYSBVM_OPCODE_MAKE_ARRAY_WITH_ELEMENTS:
     case SYSBVM_OPCODE_MAKE_BYTE_ARRAY_WITH_ELEMENTS:
     case SYSBVM_OPCODE_MAKE_CLOSURE_WITH_CAPTURES:
@@ -123,12 +125,36 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_functionApplyNoCopyArgument
 
 static sysbvm_tuple_t sysbvm_bytecodeInterpreter_functionApply(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments, sysbvm_bitflags_t applicationFlags)
 {
-    sysbvm_tuple_t argumentsBuffer[16];
+    sysbvm_tuple_t argumentsBuffer[SYSBVM_BYTECODE_FUNCTION_MAX_CALL_ARGUMENTS];
     memcpy(argumentsBuffer, arguments, argumentCount * sizeof(sysbvm_tuple_t));
 
     return sysbvm_bytecodeInterpreter_functionApplyNoCopyArguments(context, function, argumentCount, argumentsBuffer, applicationFlags);
 }
 
+static sysbvm_tuple_t sysbvm_bytecodeInterpreter_literalFunctionApply(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    // Mirror the direct call that the JIT emits for literal primitives and already compiled functions.
+    if(sysbvm_tuple_isFunction(context, function)
+        && !sysbvm_function_isMemoized(context, function)
+        && !sysbvm_function_isVariadic(context, function))
+    {
+        sysbvm_function_t *functionObject = (sysbvm_function_t*)function;
+        sysbvm_functionDefinition_t *functionDefinitionObject = (sysbvm_functionDefinition_t*)functionObject->definition;
+        bool hasPrimitive = functionObject->primitiveTableIndex
+            && sysbvm_function_getNumberedPrimitiveEntryPoint(context, sysbvm_tuple_uint32_decode(functionObject->primitiveTableIndex));
+        bool hasBytecode = functionDefinitionObject
+            && functionDefinitionObject->bytecode && functionDefinitionObject->bytecode != SYSBVM_PENDING_MEMOIZATION_VALUE;
+        if(hasPrimitive || hasBytecode)
+        {
+            sysbvm_tuple_t argumentsBuffer[SYSBVM_BYTECODE_FUNCTION_MAX_CALL_ARGUMENTS];
+            memcpy(argumentsBuffer, arguments, argumentCount * sizeof(sysbvm_tuple_t));
+            return sysbvm_ordinaryFunction_directApply(context, function, argumentCount, argumentsBuffer, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
+        }
+    }
+
+    return sysbvm_bytecodeInterpreter_functionApply(context, function, argumentCount, arguments, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
+}
+
 static sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSend(sysbvm_context_t *context, sysbvm_tuple_t receiverType, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments)
 {
     sysbvm_tuple_t method = sysbvm_type_lookupSelector(context, receiverType, selector);
@@ -150,6 +176,16 @@ static sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSend(sysbvm_context_t
     return sysbvm_function_apply2(context, method, receiverAndArguments[0], message);
 }
 
+static sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendVirtual(sysbvm_context_t *context, size_t virtualTableIndex, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments)
+{
+    sysbvm_tuple_t receiverType = sysbvm_tuple_getType(context, receiverAndArguments[0]);
+    sysbvm_tuple_t method = sysbvm_type_lookupSelectorWithVirtualTableIndex(context, receiverType, selector, virtualTableIndex);
+    if(method)
+        return sysbvm_bytecodeInterpreter_functionApply(context, method, argumentCount + 1, receiverAndArguments, 0);
+
+    return sysbvm_bytecodeInterpreter_interpretSend(context, receiverType, selector, argumentCount, receiverAndArguments);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t receiverType, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags)
 {
     SYSBVM_ASSERT(pic);
@@ -157,7 +193,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendWithReceiverTy
     if(!sysbvm_pic_lookupTypeAndSelector(pic, selector, receiverType, &method))
     {
         method = sysbvm_type_lookupSelector(context, receiverType, selector);
-        sysbvm_pic_addSelectorTypeAndMethod(pic, selector, receiverType, method);
+        sysbvm_pic_addSelectorTypeAndMethod(context, pic, selector, receiverType, method);
     }
 
     if(method)
@@ -183,6 +219,65 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_interpretSendNoCopyArgument
     return sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(context, pic, sysbvm_tuple_getType(context, receiverAndArguments[0]), selector, argumentCount, receiverAndArguments, applicationFlags);
 }
 
+#ifdef SYSBVM_JIT_SUPPORTED
+static bool sysbvm_bytecodeInterpreter_isHot(sysbvm_context_t *context, sysbvm_functionBytecode_t *functionBytecode)
+{
+    return sysbvm_tuple_uint32_decode(functionBytecode->invocationCount) >= context->jitInvocationThreshold
+        || sysbvm_tuple_uint32_decode(functionBytecode->backEdgeCount) >= context->jitBackEdgeThreshold;
+}
+
+static void sysbvm_bytecodeInterpreter_countInvocation(sysbvm_context_t *context, sysbvm_functionBytecode_t *functionBytecode)
+{
+    // Saturate at the threshold, so that the counter always stays as an immediate.
+    uint32_t invocationCount = sysbvm_tuple_uint32_decode(functionBytecode->invocationCount);
+    if(invocationCount < context->jitInvocationThreshold)
+        functionBytecode->invocationCount = sysbvm_tuple_uint32_encode(context, invocationCount + 1);
+}
+#endif
+
+#ifdef SYSBVM_JIT_SUPPORTED
+static bool sysbvm_bytecodeInterpreter_onStackReplacement(sysbvm_context_t *context, sysbvm_stackFrameBytecodeFunctionActivationRecord_t *activationRecord)
+{
+    sysbvm_functionBytecode_t *functionBytecode = (sysbvm_functionBytecode_t*)activationRecord->functionBytecode;
+    if(!sysbvm_bytecodeInterpreter_isHot(context, functionBytecode))
+        return false;
+
+    if(!functionBytecode->jittedCode || functionBytecode->jittedCodeSessionToken != context->roots.sessionToken)
+    {
+        sysbvm_bytecodeJit_jit(context, functionBytecode);
+        functionBytecode = (sysbvm_functionBytecode_t*)activationRecord->functionBytecode;
+    }
+
+    uint8_t *osrEntryPoint = (uint8_t*)sysbvm_tuple_systemHandle_decode(functionBytecode->jittedOsrEntryPoint);
+    if(!osrEntryPoint || functionBytecode->jittedCodeSessionToken != context->roots.sessionToken)
+        return false;
+
+    // Find the loop header in the jitted code.
+    size_t osrTargetCount = sysbvm_tuple_getSizeInSlots(functionBytecode->jittedOsrTargets) / 2;
+    sysbvm_tuple_t *osrTargets = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(functionBytecode->jittedOsrTargets)->pointers;
+    for(size_t i = 0; i < osrTargetCount; ++i)
+    {
+        if(sysbvm_tuple_size_decode(osrTargets[i*2]) != activationRecord->pc)
+            continue;
+
+        // Transfer the rest of the activation into a jitted frame.
+        void *resumeAddress = osrEntryPoint + sysbvm_tuple_intptr_decode(osrTargets[i*2 + 1]);
+        sysbvm_bytecodeJit_osrEntryPoint entryPoint = (sysbvm_bytecodeJit_osrEntryPoint)osrEntryPoint;
+        activationRecord->result = entryPoint(context, activationRecord->function, activationRecord->argumentCount, activationRecord->arguments, activationRecord->inlineLocalVector, resumeAddress);
+        return true;
+    }
+
+    return false;
+}
+#endif
+
+static void sysbvm_bytecodeInterpreter_countBackEdge(sysbvm_context_t *context, sysbvm_functionBytecode_t *functionBytecode)
+{
+    uint32_t backEdgeCount = sysbvm_tuple_uint32_decode(functionBytecode->backEdgeCount);
+    if(backEdgeCount < context->jitBackEdgeThreshold)
+        functionBytecode->backEdgeCount = sysbvm_tuple_uint32_encode(context, backEdgeCount + 1);
+}
+
 SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_context_t *context, sysbvm_stackFrameBytecodeFunctionActivationRecord_t *activationRecord)
 {
     sysbvm_bytecodeInterpreter_ensureTablesAreFilled();
@@ -207,15 +302,18 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             uint8_t lowByte = instructions[pc++];
             uint8_t highByte = instructions[pc++];
             countExtension = (countExtension << 16) | (highByte << 8) | lowByte;
+            activationRecord->pc = pc;
             continue;
         }
 
         uint8_t standardOpcode = opcode;
         size_t operandCount = 0;
+        size_t variableOperandCount = 0;
         size_t caseCount = 0;
         if(opcode >= SYSBVM_OPCODE_FIRST_VARIABLE)
         {
-            operandCount = (countExtension << 4) + (opcode & 0x0F);
+            variableOperandCount = (countExtension << 4) + (opcode & 0x0F);
+            operandCount = variableOperandCount;
             standardOpcode = opcode & 0xF0;
             if(standardOpcode == SYSBVM_OPCODE_CASE_JUMP)
             {
@@ -341,7 +439,7 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             if(!sysbvm_tuple_boolean_decode(operandRegisterFile[0]))
             {
                 pc += decodedOperands[1];
-                isBackwardBranch = decodedOperands[1 < 0];
+                isBackwardBranch = decodedOperands[1] < 0;
             }
             break;
         case SYSBVM_OPCODE_SET_DEBUG_VALUE:
@@ -405,21 +503,27 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
 
         // Variable operand.
         case SYSBVM_OPCODE_CALL:
-            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_functionApply(context, operandRegisterFile[1], opcode & 0xF, operandRegisterFile + 2, 0);
+            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_functionApply(context, operandRegisterFile[1], variableOperandCount, operandRegisterFile + 2, 0);
             break;
         case SYSBVM_OPCODE_UNCHECKED_CALL:
-            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_functionApply(context, operandRegisterFile[1], opcode & 0xF, operandRegisterFile + 2, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
+            if((decodedOperands[1] & SYSBVM_OPERAND_VECTOR_BITMASK) == SYSBVM_OPERAND_VECTOR_LITERAL)
+                operandRegisterFile[0] = sysbvm_bytecodeInterpreter_literalFunctionApply(context, operandRegisterFile[1], variableOperandCount, operandRegisterFile + 2);
+            else
+                operandRegisterFile[0] = sysbvm_bytecodeInterpreter_functionApply(context, operandRegisterFile[1], variableOperandCount, operandRegisterFile + 2, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
             break;
         case SYSBVM_OPCODE_SEND:
-            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_interpretSend(context, sysbvm_tuple_getType(context, operandRegisterFile[2]), operandRegisterFile[1], opcode & 0xF, operandRegisterFile + 2);
+            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_interpretSend(context, sysbvm_tuple_getType(context, operandRegisterFile[2]), operandRegisterFile[1], variableOperandCount, operandRegisterFile + 2);
             break;
         case SYSBVM_OPCODE_SEND_WITH_LOOKUP:
-            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_interpretSend(context, operandRegisterFile[1], operandRegisterFile[2], opcode & 0xF, operandRegisterFile + 3);
+            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_interpretSend(context, operandRegisterFile[1], operandRegisterFile[2], variableOperandCount, operandRegisterFile + 3);
+            break;
+        case SYSBVM_OPCODE_SEND_VIRTUAL:
+            operandRegisterFile[0] = sysbvm_bytecodeInterpreter_interpretSendVirtual(context, sysbvm_tuple_size_decode(operandRegisterFile[1]), operandRegisterFile[2], variableOperandCount, operandRegisterFile + 3);
             break;
 
         case SYSBVM_OPCODE_MAKE_ARRAY_WITH_ELEMENTS:
             {
-                size_t arraySize = opcode & 0xF;
+                size_t arraySize = variableOperandCount;
                 operandRegisterFile[0] = sysbvm_array_create(context, arraySize);
                 sysbvm_tuple_t *arraySlots = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(operandRegisterFile[0])->pointers;
                 for(size_t i = 0; i < arraySize; ++i)
@@ -428,7 +532,7 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             break;
         case SYSBVM_OPCODE_MAKE_BYTE_ARRAY_WITH_ELEMENTS:
             {
-                size_t arraySize = opcode & 0xF;
+                size_t arraySize = variableOperandCount;
                 operandRegisterFile[0] = sysbvm_byteArray_create(context, arraySize);
                 uint8_t *bytes = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(operandRegisterFile[0])->bytes;
                 for(size_t i = 0; i < arraySize; ++i)
@@ -437,7 +541,7 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             break;
         case SYSBVM_OPCODE_MAKE_CLOSURE_WITH_CAPTURES:
             {
-                size_t captureVectorSize = opcode & 0xF;
+                size_t captureVectorSize = variableOperandCount;
                 sysbvm_functionDefinition_t *functionDefinition = (sysbvm_functionDefinition_t*)operandRegisterFile[1];
                 operandRegisterFile[0] = sysbvm_sequenceTuple_create(context, functionDefinition->captureVectorType);
                 sysbvm_tuple_t *captureVectorSlots = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(operandRegisterFile[0])->pointers;
@@ -448,7 +552,7 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             break;
         case SYSBVM_OPCODE_MAKE_DICTIONARY_WITH_ELEMENTS:
             {
-                size_t dictionarySize = opcode & 0xF;
+                size_t dictionarySize = variableOperandCount;
                 operandRegisterFile[0] = sysbvm_dictionary_createWithCapacity(context, dictionarySize);
                 for(size_t i = 0; i < dictionarySize; ++i)
                     sysbvm_dictionary_add(context, operandRegisterFile[0], operandRegisterFile[1 + i]);
@@ -457,10 +561,18 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
             
         case SYSBVM_OPCODE_CASE_JUMP:
             {
+                // Keys with the same immediate tag as the value do not need the generic equality.
+                sysbvm_tuple_t caseValue = operandRegisterFile[0];
+                sysbvm_tuple_t caseValueImmediateTag = sysbvm_tuple_isIdentityComparableImmediate(caseValue) ? (caseValue & SYSBVM_TUPLE_TAG_BIT_MASK) : SYSBVM_TUPLE_TAG_POINTER;
                 bool hasFoundCase = false;
                 for(size_t i = 0; i < caseCount; ++i)
                 {
-                    if(operandRegisterFile[0] == operandRegisterFile[i + 1] || sysbvm_tuple_equals(context, operandRegisterFile[0], operandRegisterFile[i + 1]))
+                    sysbvm_tuple_t caseKey = operandRegisterFile[i + 1];
+                    bool isCaseMatching = caseValue == caseKey;
+                    if(!isCaseMatching && (caseValueImmediateTag == SYSBVM_TUPLE_TAG_POINTER || (caseKey & SYSBVM_TUPLE_TAG_BIT_MASK) != caseValueImmediateTag))
+                        isCaseMatching = sysbvm_tuple_equals(context, caseValue, caseKey);
+
+                    if(isCaseMatching)
                     {
                         // Found the case.
                         hasFoundCase = true;
@@ -490,9 +602,18 @@ SYSBVM_API void sysbvm_bytecodeInterpreter_interpretWithActivationRecord(sysbvm_
         }
         activationRecord->pc = pc;
 
-        // Safepoint in backward branches.
+        // Profile and safepoint in backward branches.
         if(isBackwardBranch)
+        {
+            if(context->jitEnabled)
+                sysbvm_bytecodeInterpreter_countBackEdge(context, (sysbvm_functionBytecode_t*)activationRecord->functionBytecode);
             sysbvm_gc_safepoint(context);
+
+#ifdef SYSBVM_JIT_SUPPORTED
+            if(context->jitEnabled && sysbvm_bytecodeInterpreter_onStackReplacement(context, activationRecord))
+                return;
+#endif
+        }
     }
 
     SYSBVM_ASSERT(activationRecord->pc < sysbvm_tuple_getSizeInBytes(activationRecord->instructions));
@@ -519,9 +640,8 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_getSourcePositionForActivat
 
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_getSourcePositionForJitActivationRecord(sysbvm_context_t *context, sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t *activationRecord)
 {
-    sysbvm_function_t *functionObject = (sysbvm_function_t*)activationRecord->function;
-    sysbvm_functionDefinition_t *functionDefinitionObject = (sysbvm_functionDefinition_t*)functionObject->definition;
-    sysbvm_functionBytecode_t *functionBytecodeObject = (sysbvm_functionBytecode_t *)functionDefinitionObject->bytecode;
+    sysbvm_functionBytecode_t *functionBytecodeObject = (sysbvm_functionBytecode_t *)activationRecord->functionBytecode;
+    sysbvm_functionDefinition_t *functionDefinitionObject = (sysbvm_functionDefinition_t*)functionBytecodeObject->definition;
     sysbvm_tuple_t actualSourcePosition = sysbvm_bytecodeInterpreter_getSourcePositionForPC(context, functionBytecodeObject, activationRecord->pc);
     if(actualSourcePosition)
         return actualSourcePosition;
@@ -584,7 +704,12 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_apply(sysbvm_context_t *con
         sysbvm_functionDefinition_t *functionDefinitionObject = (sysbvm_functionDefinition_t*)functionObject->definition;
         sysbvm_functionBytecode_t *functionBytecodeObject = (sysbvm_functionBytecode_t *)functionDefinitionObject->bytecode;
         if(!functionBytecodeObject->jittedCode || functionBytecodeObject->jittedCodeSessionToken != context->roots.sessionToken)
-            sysbvm_bytecodeJit_jit(context, functionBytecodeObject);
+        {
+            // Only spend time in the JIT for functions that are hot.
+            sysbvm_bytecodeInterpreter_countInvocation(context, functionBytecodeObject);
+            if(sysbvm_bytecodeInterpreter_isHot(context, functionBytecodeObject))
+                sysbvm_bytecodeJit_jit(context, functionBytecodeObject);
+        }
 
         if(functionBytecodeObject->jittedCode && functionBytecodeObject->jittedCodeSessionToken == context->roots.sessionToken)
         {
@@ -602,6 +727,49 @@ SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitTrampolineDestinati
     return sysbvm_bytecodeInterpreter_apply(context, function, argumentCount, arguments);
 }
 
+SYSBVM_API void sysbvm_functionBytecode_unlinkJittedCode(sysbvm_context_t *context, sysbvm_tuple_t functionBytecode)
+{
+#ifdef SYSBVM_JIT_SUPPORTED
+    if(sysbvm_tuple_isNonNullPointer(functionBytecode))
+        sysbvm_jit_unlinkTrampoline(context, (sysbvm_functionBytecode_t*)functionBytecode);
+#else
+    (void)context;
+    (void)functionBytecode;
+#endif
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitUnlinkedTrampolineDestination(sysbvm_context_t *context, sysbvm_tuple_t function, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    // The function no longer uses the bytecode of the trampoline, so its current definition has to be looked up again.
+    return sysbvm_function_apply(context, function, argumentCount, arguments, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
+}
+
+// The adapters from the register arguments entry into the generic application. They are correct in every linking state.
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination0(sysbvm_context_t *context, sysbvm_tuple_t function)
+{
+    return sysbvm_function_applyNoCheck0(context, function);
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination1(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0)
+{
+    return sysbvm_function_applyNoCheck1(context, function, argument0);
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination2(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1)
+{
+    return sysbvm_function_applyNoCheck2(context, function, argument0, argument1);
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination3(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1, sysbvm_tuple_t argument2)
+{
+    return sysbvm_function_applyNoCheck3(context, function, argument0, argument1, argument2);
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination4(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, sysbvm_tuple_t argument1, sysbvm_tuple_t argument2, sysbvm_tuple_t argument3)
+{
+    return sysbvm_function_applyNoCheck4(context, function, argument0, argument1, argument2, argument3);
+}
+
 void sysbvm_bytecode_registerPrimitives(void)
 {
 }
@@ -648,6 +816,7 @@ void sysbvm_bytecode_setupPrimitives(sysbvm_context_t *context)
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::UncheckedCall", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_UNCHECKED_CALL));
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::Send", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_SEND));
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::SendWithLookup", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_SEND_WITH_LOOKUP));
+    sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::SendVirtual", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_SEND_VIRTUAL));
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::MakeArrayWithElements", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_MAKE_ARRAY_WITH_ELEMENTS));
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::MakeByteArrayWithElements", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_MAKE_BYTE_ARRAY_WITH_ELEMENTS));
     sysbvm_context_setIntrinsicSymbolBindingNamedWithValue(context, "FunctionBytecode::Opcode::MakeClosureWithCaptures", sysbvm_tuple_uint8_encode(SYSBVM_OPCODE_MAKE_CLOSURE_WITH_CAPTURES));
@@ -570,6 +570,24 @@ SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_sendWithLookupReceive
     return instruction;
 }
 
+SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_sendVirtual(sysbvm_context_t *context, sysbvm_functionBytecodeAssembler_t *assembler, sysbvm_tuple_t result, sysbvm_tuple_t virtualTableIndex, sysbvm_tuple_t selector, sysbvm_tuple_t receiver, sysbvm_tuple_t arguments)
+{
+    size_t argumentCount = sysbvm_array_getSize(arguments);
+    sysbvm_functionBytecodeAssembler_countExtension(context, assembler, argumentCount>>4);
+
+    sysbvm_tuple_t operands = sysbvm_array_create(context, 4 + argumentCount);
+    sysbvm_array_atPut(operands, 0, result);
+    sysbvm_array_atPut(operands, 1, virtualTableIndex);
+    sysbvm_array_atPut(operands, 2, selector);
+    sysbvm_array_atPut(operands, 3, receiver);
+    for(size_t i = 0; i < argumentCount; ++i)
+        sysbvm_array_atPut(operands, 4 + i, sysbvm_array_at(arguments, i));
+    
+    sysbvm_tuple_t instruction = sysbvm_functionBytecodeAssemblerInstruction_create(context, SYSBVM_OPCODE_SEND_VIRTUAL, operands);
+    sysbvm_functionBytecodeAssembler_addInstruction(assembler, instruction);
+    return instruction;
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_functionBytecodeAssembler_caseJump(sysbvm_context_t *context, sysbvm_functionBytecodeAssembler_t *assembler, sysbvm_tuple_t value, sysbvm_tuple_t caseKeys, sysbvm_tuple_t caseDestinations, sysbvm_tuple_t defaultDestination)
 {
     size_t caseCount = sysbvm_array_getSize(caseKeys);
@@ -1105,6 +1123,9 @@ SYSBVM_API void sysbvm_functionBytecodeDirectCompiler_compileFunctionDefinition(
     gcFrame.bytecode->jittedCodeTrampolineWritePointer = sysbvm_tuple_systemHandle_encode(context, 0);
     gcFrame.bytecode->jittedCodeTrampolineSessionToken = sysbvm_tuple_systemHandle_encode(context, 0);
 
+    gcFrame.bytecode->jittedOsrEntryPoint = sysbvm_tuple_systemHandle_encode(context, 0);
+    gcFrame.bytecode->jittedRegisterArgumentsEntryPoint = sysbvm_tuple_systemHandle_encode(context, 0);
+
     // Tables for the debug information.
     gcFrame.bytecode->sourcePosition = gcFrame.sourceAnalyzedDefinition->sourcePosition;
     gcFrame.debugSourcePositions = sysbvm_orderedOffsetTableBuilder_create(context);
@@ -1131,11 +1152,13 @@ SYSBVM_API void sysbvm_functionBytecodeDirectCompiler_compileFunctionDefinition(
         instructionsOffset += sysbvm_functionBytecodeAssemblerInstruction_assembleInto(context, gcFrame.instruction, destInstructions + instructionsOffset);
 
     // Finish by installing it on the definition.
+    sysbvm_functionBytecode_unlinkJittedCode(context, gcFrame.definition->bytecode);
     gcFrame.definition->bytecode = (sysbvm_tuple_t)gcFrame.bytecode;
     gcFrame.definition->sourceAnalyzedDefinition = SYSBVM_NULL_TUPLE;
 
     gcFrame.bytecode->debugSourcePositions = sysbvm_orderedOffsetTableBuilder_finish(context, gcFrame.debugSourcePositions);
     gcFrame.bytecode->debugSourceEnvironments = sysbvm_orderedOffsetTableBuilder_finish(context, gcFrame.debugSourceEnvironments);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
 }
 
 static sysbvm_tuple_t sysbvm_astNode_primitiveCompileIntoBytecode(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
@@ -1470,6 +1493,7 @@ static sysbvm_tuple_t sysbvm_astIfNode_primitiveCompileIntoBytecode(sysbvm_conte
     sysbvm_functionBytecodeAssembler_move(context, (*compiler)->assembler, gcFrame.result, gcFrame.falseResult);
 
     sysbvm_functionBytecodeAssembler_addInstruction((*compiler)->assembler, gcFrame.mergeLabel);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
     return gcFrame.result;
 }
 
@@ -1540,6 +1564,7 @@ static sysbvm_tuple_t sysbvm_astSwitchNode_primitiveCompileIntoBytecode(sysbvm_c
     sysbvm_functionBytecodeAssembler_move(context, (*compiler)->assembler, gcFrame.result, gcFrame.defaultResult);
 
     sysbvm_functionBytecodeAssembler_addInstruction((*compiler)->assembler, gcFrame.mergeLabel);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
     return gcFrame.result;
 }
 
@@ -1831,8 +1856,15 @@ static sysbvm_tuple_t sysbvm_astMessageSendNode_primitiveCompileIntoBytecode(sys
         gcFrame.result = gcFrame.resultTemporary;
     }
 
+    // Sends of a bound virtual method carry the virtual table index of its selector.
+    size_t virtualTableIndex = 0;
+    bool hasVirtualTableIndex = (*sendNode)->boundMethod && sysbvm_astNode_isLiteralNode(context, (*sendNode)->selector)
+        && sysbvm_type_findVirtualTableIndexOfSelector((*sendNode)->boundMethodOwner, sysbvm_astLiteralNode_getValue((*sendNode)->selector), &virtualTableIndex);
+
     if((*sendNode)->receiverLookupType)
         sysbvm_functionBytecodeAssembler_sendWithLookupReceiverType(context, (*compiler)->assembler, gcFrame.resultTemporary, gcFrame.receiverLookupType, gcFrame.selector, gcFrame.receiver, gcFrame.arguments);
+    else if(hasVirtualTableIndex)
+        sysbvm_functionBytecodeAssembler_sendVirtual(context, (*compiler)->assembler, gcFrame.resultTemporary, sysbvm_functionBytecodeAssembler_addLiteral(context, (*compiler)->assembler, sysbvm_tuple_size_encode(context, virtualTableIndex)), gcFrame.selector, gcFrame.receiver, gcFrame.arguments);
     else
         sysbvm_functionBytecodeAssembler_send(context, (*compiler)->assembler, gcFrame.resultTemporary, gcFrame.selector, gcFrame.receiver, gcFrame.arguments);
 
@@ -1,4 +1,5 @@
 #include "sysbvm/bytecodeJit.h"
+#include "sysbvm/array.h"
 #include "sysbvm/assert.h"
 #include "sysbvm/association.h"
 #include "sysbvm/dwarf.h"
@@ -358,6 +359,117 @@ SYSBVM_API bool sysbvm_bytecodeJit_getLiteralValueForOperand(sysbvm_bytecodeJit_
     return false;   
 }
 
+typedef struct sysbvm_bytecodeJitIntegerPrimitiveType_s
+{
+    const char *name;
+    uint8_t tag;
+    bool isSigned;
+    bool hasInlineArithmetic;
+} sysbvm_bytecodeJitIntegerPrimitiveType_t;
+
+// Only the types whose immediate range overflow matches the machine overflow get inline arithmetic.
+static const sysbvm_bytecodeJitIntegerPrimitiveType_t sysbvm_bytecodeJit_integerPrimitiveTypes[] = {
+    {"Integer", SYSBVM_TUPLE_TAG_INTEGER, true, true},
+    {"Int64", SYSBVM_TUPLE_TAG_INT64, true, true},
+    {"Int32", SYSBVM_TUPLE_TAG_INT32, true, false},
+    {"Int16", SYSBVM_TUPLE_TAG_INT16, true, false},
+    {"Int8", SYSBVM_TUPLE_TAG_INT8, true, false},
+    {"UInt64", SYSBVM_TUPLE_TAG_UINT64, false, false},
+    {"UInt32", SYSBVM_TUPLE_TAG_UINT32, false, false},
+    {"UInt16", SYSBVM_TUPLE_TAG_UINT16, false, false},
+    {"UInt8", SYSBVM_TUPLE_TAG_UINT8, false, false},
+    {"Char32", SYSBVM_TUPLE_TAG_CHAR32, false, false},
+    {"Char16", SYSBVM_TUPLE_TAG_CHAR16, false, false},
+    {"Char8", SYSBVM_TUPLE_TAG_CHAR8, false, false},
+};
+
+typedef struct sysbvm_bytecodeJitIntegerPrimitiveOperation_s
+{
+    const char *name;
+    sysbvm_bytecodeJitIntegerOperation_t operation;
+} sysbvm_bytecodeJitIntegerPrimitiveOperation_t;
+
+static const sysbvm_bytecodeJitIntegerPrimitiveOperation_t sysbvm_bytecodeJit_integerPrimitiveOperations[] = {
+    {"+", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_ADD},
+    {"-", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_SUBTRACT},
+    {"*", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_MULTIPLY},
+    {"&", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_AND},
+    {"|", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_OR},
+    {"^", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_XOR},
+    {"=", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_EQUALS},
+    {"~=", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_NOT_EQUALS},
+    {"<", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_THAN},
+    {"<=", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_EQUALS},
+    {">", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_THAN},
+    {">=", SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_EQUALS},
+};
+
+SYSBVM_API bool sysbvm_bytecodeJit_getIntegerPrimitiveForFunction(sysbvm_bytecodeJit_t *jit, sysbvm_tuple_t function, sysbvm_bytecodeJitIntegerPrimitive_t *outPrimitive)
+{
+    if(!sysbvm_tuple_isFunction(jit->context, function) || !sysbvm_function_isCorePrimitive(jit->context, function))
+        return false;
+
+    // The primitive names have the form Type::operation
+    sysbvm_tuple_t primitiveName = ((sysbvm_function_t*)function)->primitiveName;
+    if(!sysbvm_tuple_isNonNullPointer(primitiveName))
+        return false;
+
+    size_t primitiveNameSize = sysbvm_tuple_getSizeInBytes(primitiveName);
+    const char *primitiveNameData = (const char*)SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(primitiveName)->bytes;
+    for(size_t i = 0; i < sizeof(sysbvm_bytecodeJit_integerPrimitiveTypes) / sizeof(sysbvm_bytecodeJit_integerPrimitiveTypes[0]); ++i)
+    {
+        const sysbvm_bytecodeJitIntegerPrimitiveType_t *primitiveType = sysbvm_bytecodeJit_integerPrimitiveTypes + i;
+        size_t typeNameSize = strlen(primitiveType->name);
+        if(primitiveNameSize < typeNameSize + 2
+            || memcmp(primitiveNameData, primitiveType->name, typeNameSize)
+            || memcmp(primitiveNameData + typeNameSize, "::", 2))
+            continue;
+
+        const char *operationName = primitiveNameData + typeNameSize + 2;
+        size_t operationNameSize = primitiveNameSize - typeNameSize - 2;
+        for(size_t j = 0; j < sizeof(sysbvm_bytecodeJit_integerPrimitiveOperations) / sizeof(sysbvm_bytecodeJit_integerPrimitiveOperations[0]); ++j)
+        {
+            const sysbvm_bytecodeJitIntegerPrimitiveOperation_t *primitiveOperation = sysbvm_bytecodeJit_integerPrimitiveOperations + j;
+            if(strlen(primitiveOperation->name) != operationNameSize || memcmp(operationName, primitiveOperation->name, operationNameSize))
+                continue;
+
+            if(primitiveOperation->operation <= SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_MULTIPLY && !primitiveType->hasInlineArithmetic)
+                return false;
+
+            outPrimitive->operation = primitiveOperation->operation;
+            outPrimitive->tag = primitiveType->tag;
+            outPrimitive->isSigned = primitiveType->isSigned;
+            return true;
+        }
+
+        return false;
+    }
+
+    return false;
+}
+
+SYSBVM_API bool sysbvm_bytecodeJit_getIntegerPrimitiveForSelector(sysbvm_bytecodeJit_t *jit, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_bytecodeJitIntegerPrimitive_t *outPrimitive)
+{
+    // Only the final methods of Integer can be assumed for any receiver with the integer tag.
+    if(argumentCount != 1 || !sysbvm_tuple_isNonNullPointer(selector))
+        return false;
+
+    sysbvm_tuple_t method = sysbvm_type_lookupSelector(jit->context, jit->context->roots.immediateTypeTable[SYSBVM_TUPLE_TAG_INTEGER], selector);
+    if(!sysbvm_tuple_isFunction(jit->context, method)
+        || (sysbvm_function_getFlags(jit->context, method) & SYSBVM_FUNCTION_FLAGS_FINAL) == 0)
+        return false;
+
+    return sysbvm_bytecodeJit_getIntegerPrimitiveForFunction(jit, method, outPrimitive)
+        && outPrimitive->tag == SYSBVM_TUPLE_TAG_INTEGER;
+}
+
+static bool sysbvm_bytecodeJit_isLiteralTypeSlot(sysbvm_bytecodeJit_t *jit, int16_t operand)
+{
+    sysbvm_tuple_t literalValue;
+    return sysbvm_bytecodeJit_getLiteralValueForOperand(jit, operand, &literalValue)
+        && sysbvm_tuple_isKindOf(jit->context, literalValue, jit->context->roots.typeSlotType);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_bytecodeJit_slotAt(sysbvm_context_t *context, sysbvm_tuple_t tuple, sysbvm_tuple_t typeSlot)
 {
     size_t slotIndex = sysbvm_typeSlot_getIndex(typeSlot);
@@ -415,6 +527,106 @@ SYSBVM_API void sysbvm_jit_dumpCodeToFileNamed(const void *code, size_t codeSize
     fclose(file);
 }
 
+static void sysbvm_bytecodeJit_addOsrTargetPC(sysbvm_dynarray_t *osrTargetPCs, size_t targetPC)
+{
+    for(size_t i = 0; i < osrTargetPCs->size; ++i)
+    {
+        if(*sysbvm_dynarray_entryOfTypeAt(*osrTargetPCs, size_t, i) == targetPC)
+            return;
+    }
+
+    sysbvm_dynarray_add(osrTargetPCs, &targetPC);
+}
+
+static void sysbvm_bytecodeJit_selectCachedLocals(sysbvm_bytecodeJit_t *jit, uint8_t *instructions, size_t instructionsSize)
+{
+    if(jit->localVectorSize == 0)
+        return;
+
+    // Count the local operand uses. The offset operands of the jumps are not locals.
+    uint32_t *localUseCounts = (uint32_t*)calloc(jit->localVectorSize, sizeof(uint32_t));
+    size_t pc = 0;
+    size_t countExtension = 0;
+    while(pc < instructionsSize)
+    {
+        uint8_t opcode = instructions[pc++];
+        if(opcode == SYSBVM_OPCODE_COUNT_EXTENSION)
+        {
+            if(pc + 2 > instructionsSize)
+                break;
+            uint8_t lowByte = instructions[pc++];
+            uint8_t highByte = instructions[pc++];
+            countExtension = (countExtension << 16) | (highByte << 8) | lowByte;
+            continue;
+        }
+
+        uint8_t standardOpcode = opcode;
+        size_t operandCount = 0;
+        size_t caseCount = 0;
+        if(opcode >= SYSBVM_OPCODE_FIRST_VARIABLE)
+        {
+            operandCount = (countExtension << 4) + (opcode & 0x0F);
+            standardOpcode = opcode & 0xF0;
+            if(standardOpcode == SYSBVM_OPCODE_CASE_JUMP)
+            {
+                caseCount = operandCount;
+                operandCount *= 2;
+            }
+
+            operandCount += sysbvm_implicitVariableBytecodeOperandCountTable[opcode >> 4];
+        }
+        else
+        {
+            operandCount = opcode >> 4;
+        }
+        countExtension = 0;
+
+        if(pc + operandCount*2 > instructionsSize)
+            break;
+
+        size_t offsetOperandCount = caseCount + sysbvm_bytecodeInterpreter_offsetOperandCountForOpcode(standardOpcode);
+        for(size_t i = 0; i < operandCount; ++i)
+        {
+            int16_t operand = (int16_t)(instructions[pc] | (instructions[pc + 1] << 8));
+            pc += 2;
+
+            int16_t vectorIndex = operand >> SYSBVM_OPERAND_VECTOR_BITS;
+            if(i < operandCount - offsetOperandCount
+                && (operand & SYSBVM_OPERAND_VECTOR_BITMASK) == SYSBVM_OPERAND_VECTOR_LOCAL
+                && vectorIndex >= 0 && (size_t)vectorIndex < jit->localVectorSize)
+                ++localUseCounts[vectorIndex];
+        }
+    }
+
+    // Keep the most used locals.
+    while(jit->cachedLocalCount < SYSBVM_JIT_MAX_CACHED_LOCAL_COUNT)
+    {
+        size_t bestLocalIndex = 0;
+        for(size_t i = 1; i < jit->localVectorSize; ++i)
+        {
+            if(localUseCounts[i] > localUseCounts[bestLocalIndex])
+                bestLocalIndex = i;
+        }
+
+        if(localUseCounts[bestLocalIndex] < SYSBVM_JIT_CACHED_LOCAL_MIN_USE_COUNT)
+            break;
+
+        jit->cachedLocalIndices[jit->cachedLocalCount++] = (int16_t)bestLocalIndex;
+        localUseCounts[bestLocalIndex] = 0;
+    }
+
+    free(localUseCounts);
+}
+
+static int sysbvm_bytecodeJit_selectDebugInfoLevel(sysbvm_context_t *context)
+{
+    if(context->jitDebugInfoLevel != SYSBVM_JIT_DEBUG_INFO_FULL)
+        return context->jitDebugInfoLevel;
+
+    // The full debug information is only built once it is requested, or when a debugger was attached at startup.
+    return context->jitFullDebugInfoRequested ? SYSBVM_JIT_DEBUG_INFO_FULL : SYSBVM_JIT_DEBUG_INFO_UNWIND;
+}
+
 SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functionBytecode_t *functionBytecode)
 {
     (void)context;
@@ -425,9 +637,15 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
 
     jit.sourcePosition = functionBytecode->sourcePosition;
     jit.compiledProgramEntity = functionBytecode->definition;
+    jit.debugInfoLevel = sysbvm_bytecodeJit_selectDebugInfoLevel(context);
+    jit.emitsPerfMapSymbol = context->jitPerfMap;
+    jit.emitsPerfJitDump = context->jitPerfJitDump;
 
-    jit.literalVectorGCRoot = sysbvm_heap_allocateGCRootTableEntry(&context->heap);
+    // The code block keeps the literal vector alive only while the function bytecode is alive, so that the code can be reclaimed.
+    jit.codeBlock = sysbvm_heap_createCodeBlock(&context->heap, (sysbvm_tuple_t)functionBytecode);
+    jit.literalVectorGCRoot = &jit.codeBlock->literalVector;
     *jit.literalVectorGCRoot = functionBytecode->literalVector;
+    jit.functionBytecodeGCRoot = &jit.codeBlock->owner;
 
     size_t instructionsSize = sysbvm_tuple_getSizeInBytes(functionBytecode->instructions);
     uint8_t *instructions = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(functionBytecode->instructions)->bytes;
@@ -441,6 +659,11 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
     jit.pcDestinations = (intptr_t*)malloc(sizeof(intptr_t)*instructionsSize);
     memset(jit.pcDestinations, -1, sizeof(intptr_t)*instructionsSize);
 
+    // Loop headers, where the interpreter may transfer its activation into the jitted code.
+    sysbvm_dynarray_t osrTargetPCs;
+    sysbvm_dynarray_initialize(&osrTargetPCs, sizeof(size_t), 4);
+
+    sysbvm_bytecodeJit_selectCachedLocals(&jit, instructions, instructionsSize);
     sysbvm_jit_prologue(&jit);
 
     size_t pc = 0;
@@ -463,10 +686,12 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
 
         uint8_t standardOpcode = opcode;
         size_t operandCount = 0;
+        size_t variableOperandCount = 0;
         size_t caseCount = 0;
         if(opcode >= SYSBVM_OPCODE_FIRST_VARIABLE)
         {
-            operandCount = (countExtension << 4) + (opcode & 0x0F);
+            variableOperandCount = (countExtension << 4) + (opcode & 0x0F);
+            operandCount = variableOperandCount;
             standardOpcode = opcode & 0xF0;
             if(standardOpcode == SYSBVM_OPCODE_CASE_JUMP)
             {
@@ -559,7 +784,10 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
             break;
         case SYSBVM_OPCODE_JUMP:
             if(decodedOperands[0] < 0)
+            {
+                sysbvm_bytecodeJit_addOsrTargetPC(&osrTargetPCs, pc + decodedOperands[0]);
                 sysbvm_jit_callWithContextNoResult0(&jit, &sysbvm_gc_safepoint);
+            }
             sysbvm_jit_jumpRelative(&jit, pc + decodedOperands[0]);
             break;
         // Two operands.
@@ -580,12 +808,18 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
             break;
         case SYSBVM_OPCODE_JUMP_IF_TRUE:
             if(decodedOperands[1] < 0)
+            {
+                sysbvm_bytecodeJit_addOsrTargetPC(&osrTargetPCs, pc + decodedOperands[1]);
                 sysbvm_jit_callWithContextNoResult0(&jit, &sysbvm_gc_safepoint);
+            }
             sysbvm_jit_jumpRelativeIfTrue(&jit, decodedOperands[0], pc + decodedOperands[1]);
             break;
         case SYSBVM_OPCODE_JUMP_IF_FALSE:
             if(decodedOperands[1] < 0)
+            {
+                sysbvm_bytecodeJit_addOsrTargetPC(&osrTargetPCs, pc + decodedOperands[1]);
                 sysbvm_jit_callWithContextNoResult0(&jit, &sysbvm_gc_safepoint);
+            }
             sysbvm_jit_jumpRelativeIfFalse(&jit, decodedOperands[0], pc + decodedOperands[1]);
             break;
         case SYSBVM_OPCODE_SET_DEBUG_VALUE:
@@ -606,22 +840,34 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
             sysbvm_jit_moveOperandToOperand(&jit, decodedOperands[0], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_MAKE_ASSOCIATION:
-            sysbvm_jit_callWithContext2(&jit, &sysbvm_association_create, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
+            sysbvm_jit_makeAssociation(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_SLOT_AT:
-            sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_slotAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
+            if(sysbvm_bytecodeJit_isLiteralTypeSlot(&jit, decodedOperands[2]))
+                sysbvm_jit_slotAt(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], false);
+            else
+                sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_slotAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_SLOT_AT_PUT:
-            sysbvm_jit_callWithContextNoResult3(&jit, &sysbvm_bytecodeJit_slotAtPut, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
+            if(sysbvm_bytecodeJit_isLiteralTypeSlot(&jit, decodedOperands[1]))
+                sysbvm_jit_slotAtPut(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], false);
+            else
+                sysbvm_jit_callWithContextNoResult3(&jit, &sysbvm_bytecodeJit_slotAtPut, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_SLOT_REFERENCE_AT:
             sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_slotReferenceAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_REF_SLOT_AT:
-            sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_refSlotAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
+            if(sysbvm_bytecodeJit_isLiteralTypeSlot(&jit, decodedOperands[2]))
+                sysbvm_jit_slotAt(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], true);
+            else
+                sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_refSlotAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_REF_SLOT_AT_PUT:
-            sysbvm_jit_callWithContextNoResult3(&jit, &sysbvm_bytecodeJit_refSlotAtPut, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
+            if(sysbvm_bytecodeJit_isLiteralTypeSlot(&jit, decodedOperands[1]))
+                sysbvm_jit_slotAtPut(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], true);
+            else
+                sysbvm_jit_callWithContextNoResult3(&jit, &sysbvm_bytecodeJit_refSlotAtPut, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
             break;
         case SYSBVM_OPCODE_REF_SLOT_REFERENCE_AT:
             sysbvm_jit_callWithContext2(&jit, &sysbvm_bytecodeJit_refSlotReferenceAt, decodedOperands[0], decodedOperands[1], decodedOperands[2]);
@@ -629,28 +875,31 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
 
         // Variable operand.
         case SYSBVM_OPCODE_CALL:
-            sysbvm_jit_functionApply(&jit, decodedOperands[0], decodedOperands[1], opcode & 0xF, decodedOperands + 2, 0);
+            sysbvm_jit_functionApply(&jit, decodedOperands[0], decodedOperands[1], variableOperandCount, decodedOperands + 2, 0);
             break;
         case SYSBVM_OPCODE_UNCHECKED_CALL:
-            sysbvm_jit_functionApply(&jit, decodedOperands[0], decodedOperands[1], opcode & 0xF, decodedOperands + 2, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
+            sysbvm_jit_functionApply(&jit, decodedOperands[0], decodedOperands[1], variableOperandCount, decodedOperands + 2, SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK);
             break;
         case SYSBVM_OPCODE_SEND:
-            sysbvm_jit_send(&jit, decodedOperands[0], decodedOperands[1], opcode & 0xF, decodedOperands + 2, 0);
+            sysbvm_jit_send(&jit, decodedOperands[0], decodedOperands[1], variableOperandCount, decodedOperands + 2, 0);
             break;
         case SYSBVM_OPCODE_SEND_WITH_LOOKUP:
-            sysbvm_jit_sendWithReceiverType(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], opcode & 0xF, decodedOperands + 3, 0);
+            sysbvm_jit_sendWithReceiverType(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], variableOperandCount, decodedOperands + 3, 0);
+            break;
+        case SYSBVM_OPCODE_SEND_VIRTUAL:
+            sysbvm_jit_sendVirtual(&jit, decodedOperands[0], decodedOperands[1], decodedOperands[2], variableOperandCount, decodedOperands + 3, 0);
             break;
         case SYSBVM_OPCODE_MAKE_ARRAY_WITH_ELEMENTS:
-            sysbvm_jit_makeArray(&jit, decodedOperands[0], opcode & 0xF, decodedOperands + 1);
+            sysbvm_jit_makeArray(&jit, decodedOperands[0], variableOperandCount, decodedOperands + 1);
             break;
         case SYSBVM_OPCODE_MAKE_BYTE_ARRAY_WITH_ELEMENTS:
-            sysbvm_jit_makeByteArray(&jit, decodedOperands[0], opcode & 0xF, decodedOperands + 1);
+            sysbvm_jit_makeByteArray(&jit, decodedOperands[0], variableOperandCount, decodedOperands + 1);
             break;
         case SYSBVM_OPCODE_MAKE_CLOSURE_WITH_CAPTURES:
-            sysbvm_jit_makeClosureWithCaptures(&jit, decodedOperands[0], decodedOperands[1], opcode & 0xF, decodedOperands + 2);
+            sysbvm_jit_makeClosureWithCaptures(&jit, decodedOperands[0], decodedOperands[1], variableOperandCount, decodedOperands + 2);
             break;
         case SYSBVM_OPCODE_MAKE_DICTIONARY_WITH_ELEMENTS:
-            sysbvm_jit_makeDictionary(&jit, decodedOperands[0], opcode & 0xF, decodedOperands + 1);
+            sysbvm_jit_makeDictionary(&jit, decodedOperands[0], variableOperandCount, decodedOperands + 1);
             break;
 
         case SYSBVM_OPCODE_CASE_JUMP:
@@ -662,6 +911,20 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
         }
     }
 
+    size_t osrEntryPointOffset = 0;
+    if(osrTargetPCs.size > 0)
+    {
+        osrEntryPointOffset = jit.instructions.size;
+        sysbvm_jit_osrEntryPrologue(&jit);
+    }
+
+    size_t registerArgumentsEntryPointOffset = 0;
+    if(jit.hasRegisterArgumentsEntryPoint)
+    {
+        registerArgumentsEntryPointOffset = jit.instructions.size;
+        sysbvm_jit_registerArgumentsEntryPrologue(&jit);
+    }
+
     sysbvm_jit_finish(&jit);
 
     size_t objectFileHeaderSize = sysbvm_sizeAlignedTo(jit.objectFileHeader.size, 16);
@@ -675,9 +938,9 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
     size_t objectFileContentSize = sysbvm_sizeAlignedTo(jit.objectFileContent.size, 16);
 
     size_t requiredCodeSize = objectFileHeaderSize + textSectionSize + rodataSectionSize + unwindInfoSize + debugInfoSize + objectFileContentSize;
-    uint8_t *codeWriteablePointer = NULL;
-    uint8_t *codeExecutablePointer = NULL;
-    sysbvm_chunkedAllocator_allocateWithDualMapping(&context->heap.codeAllocator, requiredCodeSize, 16, (void**)&codeWriteablePointer, (void**)&codeExecutablePointer);
+    sysbvm_heap_allocateCodeBlockMemory(&context->heap, jit.codeBlock, requiredCodeSize);
+    uint8_t *codeWriteablePointer = jit.codeBlock->writeableMapping;
+    uint8_t *codeExecutablePointer = jit.codeBlock->executableMapping;
 
     memset(codeWriteablePointer + objectFileHeaderSize, 0xcc, textSectionSize); // int3;
     memset(codeWriteablePointer + objectFileHeaderSize + textSectionSize, 0, rodataSectionSize); // int3;
@@ -687,17 +950,40 @@ SYSBVM_API void sysbvm_bytecodeJit_jit(sysbvm_context_t *context, sysbvm_functio
     if(jit.objectFileHeader.size > 0 && jit.objectFileContent.size > 0)
     {
         sysbvm_gdb_jit_code_entry_t *entry = (sysbvm_gdb_jit_code_entry_t*)calloc(1, sizeof(sysbvm_gdb_jit_code_entry_t));
-        sysbvm_dynarray_add(&context->jittedObjectFileEntries, &entry);
+        jit.codeBlock->gdbEntry = entry;
         sysbvm_gdb_registerObjectFile(entry, codeExecutablePointer, requiredCodeSize);
     }
 
     functionBytecode->jittedCode = sysbvm_tuple_systemHandle_encode(context, (sysbvm_systemHandle_t)(uintptr_t)entryPointPointer);
     functionBytecode->jittedCodeSessionToken = context->roots.sessionToken;
+    functionBytecode->jittedRegisterArgumentsEntryPoint = sysbvm_tuple_systemHandle_encode(context, jit.hasRegisterArgumentsEntryPoint
+        ? (sysbvm_systemHandle_t)(uintptr_t)(entryPointPointer + registerArgumentsEntryPointOffset)
+        : 0);
+
+    // Record the on-stack replacement entry, and the loop header offsets relative to it.
+    if(osrTargetPCs.size > 0)
+    {
+        functionBytecode->jittedOsrEntryPoint = sysbvm_tuple_systemHandle_encode(context, (sysbvm_systemHandle_t)(uintptr_t)(entryPointPointer + osrEntryPointOffset));
+        functionBytecode->jittedOsrTargets = sysbvm_array_create(context, osrTargetPCs.size * 2);
+        sysbvm_tuple_t *osrTargets = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(functionBytecode->jittedOsrTargets)->pointers;
+        for(size_t i = 0; i < osrTargetPCs.size; ++i)
+        {
+            size_t targetPC = *sysbvm_dynarray_entryOfTypeAt(osrTargetPCs, size_t, i);
+            osrTargets[i*2] = sysbvm_tuple_size_encode(context, targetPC);
+            osrTargets[i*2 + 1] = sysbvm_tuple_intptr_encode(context, jit.pcDestinations[targetPC] - (intptr_t)osrEntryPointOffset);
+        }
+    }
+    sysbvm_dynarray_destroy(&osrTargetPCs);
 
     // Patch the trampoline.
-    sysbvm_jit_patchTrampolineWithRealEntryPoint(&jit, functionBytecode);
+    sysbvm_jit_patchTrampolineWithRealEntryPoint(context, functionBytecode);
 
     sysbvm_bytecodeJit_jitFree(&jit);
 }
 
-#endif
\ No newline at end of file
+#endif
+
+SYSBVM_API void sysbvm_bytecodeJit_requestFullDebugInfo(sysbvm_context_t *context)
+{
+    context->jitFullDebugInfoRequested = true;
+}
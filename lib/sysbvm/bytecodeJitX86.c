@@ -1,34 +1,40 @@
 #include "sysbvm/bytecodeJit.h"
 #include "sysbvm/array.h"
+#include "sysbvm/association.h"
 #include "sysbvm/assert.h"
 #include "sysbvm/dictionary.h"
 #include "sysbvm/function.h"
 #include "sysbvm/environment.h"
 #include "sysbvm/programEntity.h"
 #include "sysbvm/elf.h"
+#include "sysbvm/perf.h"
 #include "sysbvm/pic.h"
 #include "sysbvm/stackFrame.h"
+#include "sysbvm/type.h"
 #include "sysbvm/sourcePosition.h"
 #include "sysbvm/sourceCode.h"
 #include "internal/context.h"
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
-#ifdef __linux__
-#include <unistd.h>
-#include <fcntl.h>
-
-#endif
-
 #ifndef _WIN32
 extern void __register_frame(const void*);
 #endif
 
-//define SYSBVM_EMIT_PERF_STACK_MAP
-
 #if defined(SYSBVM_JIT_SUPPORTED) && defined(SYSBVM_ARCH_X86_64)
 #define USE_OLD_STACK_LAYOUT 0
 
+// The trampolines jump through an aligned target address, which is also called by the linked call sites.
+// The linked call sites that pass their arguments in registers call through the second target.
+#define SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET 16
+#define SYSBVM_JIT_TRAMPOLINE_REGISTER_ARGUMENTS_TARGET_OFFSET 24
+#define SYSBVM_JIT_TRAMPOLINE_SIZE 32
+
+#define SYSBVM_JIT_CASE_JUMP_LINEAR_SEARCH_COUNT 4
+#define SYSBVM_JIT_CASE_JUMP_TABLE_MIN_COUNT 4
+#define SYSBVM_JIT_CASE_JUMP_TABLE_MAX_SPARSENESS 3
+
 typedef enum sysbvm_x86_register_e
 {
 #if defined(SYSBVM_ARCH_X86_64) 
@@ -92,6 +98,62 @@ typedef enum sysbvm_x86_register_e
 #endif
 } sysbvm_x86_register_t;
 
+typedef enum sysbvm_x86_condition_e
+{
+    SYSBVM_X86_CONDITION_O = 0x0,
+    SYSBVM_X86_CONDITION_B = 0x2,
+    SYSBVM_X86_CONDITION_AE = 0x3,
+    SYSBVM_X86_CONDITION_E = 0x4,
+    SYSBVM_X86_CONDITION_NE = 0x5,
+    SYSBVM_X86_CONDITION_BE = 0x6,
+    SYSBVM_X86_CONDITION_A = 0x7,
+    SYSBVM_X86_CONDITION_L = 0xC,
+    SYSBVM_X86_CONDITION_GE = 0xD,
+    SYSBVM_X86_CONDITION_LE = 0xE,
+    SYSBVM_X86_CONDITION_G = 0xF,
+} sysbvm_x86_condition_t;
+
+typedef struct sysbvm_x86_calleeSavedRegister_s
+{
+    sysbvm_x86_register_t reg;
+    uintptr_t dwarfRegister;
+} sysbvm_x86_calleeSavedRegister_t;
+
+// The registers that hold the cached locals. They are callee saved in both the SysV and the Win64 ABI.
+static const sysbvm_x86_calleeSavedRegister_t sysbvm_jit_x86_cachedLocalRegisters[SYSBVM_JIT_MAX_CACHED_LOCAL_COUNT] = {
+    {SYSBVM_X86_RBX, DW_X64_REG_RBX},
+    {SYSBVM_X86_R12, DW_X64_REG_R12},
+    {SYSBVM_X86_R13, DW_X64_REG_R13},
+    {SYSBVM_X86_R14, DW_X64_REG_R14},
+    {SYSBVM_X86_R15, DW_X64_REG_R15},
+};
+
+// The calls between jitted functions pass the first arguments in the registers that follow the context and the function.
+#ifdef _WIN32
+#define SYSBVM_JIT_REGISTER_ARGUMENT_COUNT 2
+#else
+#define SYSBVM_JIT_REGISTER_ARGUMENT_COUNT 4
+#endif
+
+static const sysbvm_x86_register_t sysbvm_jit_x86_argumentRegisters[SYSBVM_JIT_REGISTER_ARGUMENT_COUNT] = {
+#ifdef _WIN32
+    SYSBVM_X86_WIN64_ARG2, SYSBVM_X86_WIN64_ARG3,
+#else
+    SYSBVM_X86_SYSV_ARG2, SYSBVM_X86_SYSV_ARG3, SYSBVM_X86_SYSV_ARG4, SYSBVM_X86_SYSV_ARG5,
+#endif
+};
+
+// The register arguments entry of the functions that are not yet (or no longer) directly linked.
+static void *const sysbvm_jit_x86_registerArgumentsTrampolineDestinations[SYSBVM_JIT_REGISTER_ARGUMENT_COUNT + 1] = {
+    (void*)&sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination0,
+    (void*)&sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination1,
+    (void*)&sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination2,
+#ifndef _WIN32
+    (void*)&sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination3,
+    (void*)&sysbvm_bytecodeInterpreter_applyJitRegisterArgumentsTrampolineDestination4,
+#endif
+};
+
 static void sysbvm_jit_x86_mov64Absolute(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, uint64_t value);
 static void sysbvm_jit_moveRegisterToOperand(sysbvm_bytecodeJit_t *jit, int16_t operand, sysbvm_x86_register_t reg);
 static void sysbvm_jit_moveOperandToRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t reg, int16_t operand);
@@ -222,6 +284,19 @@ static void sysbvm_jit_x86_ret(sysbvm_bytecodeJit_t *jit)
     sysbvm_bytecodeJit_addByte(jit, 0xc3);
 }
 
+static void sysbvm_jit_x86_jmpRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t reg)
+{
+    if(reg > SYSBVM_X86_REG_HALF_MASK)
+        sysbvm_bytecodeJit_addByte(jit, sysbvm_jit_x86_rex(false, false, false, true));
+
+    uint8_t instruction[] = {
+        0xFF,
+        sysbvm_jit_x86_modRMRegister(reg, 4),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
 static void sysbvm_jit_x86_mov64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
 {
     uint8_t instruction[] = {
@@ -477,6 +552,18 @@ static void sysbvm_jit_x86_logicalShiftRightImmediate(sysbvm_bytecodeJit_t *jit,
     sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
 }
 
+static void sysbvm_jit_x86_logicalShiftLeftImmediate(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, uint8_t shiftAmount)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, false, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0xC1,
+        sysbvm_jit_x86_modRMRegister(destination, 4),
+        shiftAmount
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
 static void sysbvm_jit_x86_mov8IntoMemoryWithOffset(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, int32_t offset, sysbvm_x86_register_t source)
 {
     if(offset == 0 && destination != SYSBVM_X86_RBP)
@@ -527,6 +614,282 @@ static void sysbvm_jit_x86_xorRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_reg
     sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
 }
 
+static void sysbvm_jit_x86_testRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, source > SYSBVM_X86_REG_HALF_MASK, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0x85,
+        sysbvm_jit_x86_modRMRegister(destination, source),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_andImmediate8(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, int8_t immediate)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, false, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0x83,
+        sysbvm_jit_x86_modRMRegister(destination, 4),
+        (uint8_t)immediate,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_cmpImmediate8(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, int8_t immediate)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, false, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0x83,
+        sysbvm_jit_x86_modRMRegister(destination, 7),
+        (uint8_t)immediate,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_cmp64WithMemoryWithOffset(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t left, sysbvm_x86_register_t base, int32_t offset)
+{
+    SYSBVM_ASSERT((base & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, left > SYSBVM_X86_REG_HALF_MASK, false, base > SYSBVM_X86_REG_HALF_MASK),
+        0x3B,
+        sysbvm_jit_x86_modRM(base, left, 2),
+        offset & 0xFF, (offset >> 8) & 0xFF, (offset >> 16) & 0xFF, (offset >> 24) & 0xFF,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_mov64FromMemoryIndexedScaled8(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t base, sysbvm_x86_register_t index)
+{
+    SYSBVM_ASSERT((base & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RBP);
+    SYSBVM_ASSERT(index != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, index > SYSBVM_X86_REG_HALF_MASK, base > SYSBVM_X86_REG_HALF_MASK),
+        0x8B,
+        sysbvm_jit_x86_modRM(4, destination, 0),
+        (base & SYSBVM_X86_REG_HALF_MASK) | ((index & SYSBVM_X86_REG_HALF_MASK) << 3) | (3 << 6),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_add64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x03,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_sub64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x2B,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_and64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x23,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_or64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x0B,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_imul64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x0F, 0xAF,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_cmov64Register(sysbvm_bytecodeJit_t *jit, sysbvm_x86_condition_t condition, sysbvm_x86_register_t destination, sysbvm_x86_register_t source)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, false, source > SYSBVM_X86_REG_HALF_MASK),
+        0x0F, 0x40 + condition,
+        sysbvm_jit_x86_modRMRegister(source, destination),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_orImmediate8(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, int8_t immediate)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, false, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0x83,
+        sysbvm_jit_x86_modRMRegister(destination, 1),
+        (uint8_t)immediate,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_arithmeticShiftRightImmediate(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, uint8_t shiftAmount)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, false, false, destination > SYSBVM_X86_REG_HALF_MASK),
+        0xC1,
+        sysbvm_jit_x86_modRMRegister(destination, 7),
+        shiftAmount
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_cmpRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t left, sysbvm_x86_register_t right)
+{
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, left > SYSBVM_X86_REG_HALF_MASK, false, right > SYSBVM_X86_REG_HALF_MASK),
+        0x3B,
+        sysbvm_jit_x86_modRMRegister(right, left),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_mov32FromMemoryWithOffset(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t base, int8_t offset)
+{
+    SYSBVM_ASSERT((base & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(false, destination > SYSBVM_X86_REG_HALF_MASK, false, base > SYSBVM_X86_REG_HALF_MASK),
+        0x8B,
+        sysbvm_jit_x86_modRM(base, destination, 1),
+        (uint8_t)offset,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_test32MemoryWithImmediate32(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t base, int8_t offset, uint32_t immediate)
+{
+    SYSBVM_ASSERT((base & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(false, false, false, base > SYSBVM_X86_REG_HALF_MASK),
+        0xF7,
+        sysbvm_jit_x86_modRM(base, 0, 1),
+        (uint8_t)offset,
+        immediate & 0xFF, (immediate >> 8) & 0xFF, (immediate >> 16) & 0xFF, (immediate >> 24) & 0xFF,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_mov64FromMemoryIndexedWithOffset(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t destination, sysbvm_x86_register_t base, sysbvm_x86_register_t index, int8_t offset)
+{
+    SYSBVM_ASSERT(index != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, destination > SYSBVM_X86_REG_HALF_MASK, index > SYSBVM_X86_REG_HALF_MASK, base > SYSBVM_X86_REG_HALF_MASK),
+        0x8B,
+        sysbvm_jit_x86_modRM(4, destination, 1),
+        (base & SYSBVM_X86_REG_HALF_MASK) | ((index & SYSBVM_X86_REG_HALF_MASK) << 3),
+        (uint8_t)offset,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_mov64IntoMemoryIndexedWithOffset(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t base, sysbvm_x86_register_t index, int8_t offset, sysbvm_x86_register_t source)
+{
+    SYSBVM_ASSERT(index != SYSBVM_X86_RSP);
+    uint8_t instruction[] = {
+        sysbvm_jit_x86_rex(true, source > SYSBVM_X86_REG_HALF_MASK, index > SYSBVM_X86_REG_HALF_MASK, base > SYSBVM_X86_REG_HALF_MASK),
+        0x89,
+        sysbvm_jit_x86_modRM(4, source, 1),
+        (base & SYSBVM_X86_REG_HALF_MASK) | ((index & SYSBVM_X86_REG_HALF_MASK) << 3),
+        (uint8_t)offset,
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_callRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t reg)
+{
+    if(reg > SYSBVM_X86_REG_HALF_MASK)
+        sysbvm_bytecodeJit_addByte(jit, sysbvm_jit_x86_rex(false, false, false, true));
+
+    uint8_t instruction[] = {
+        0xFF,
+        sysbvm_jit_x86_modRMRegister(reg, 2),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static void sysbvm_jit_x86_callIndirectRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t reg)
+{
+    SYSBVM_ASSERT((reg & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RSP && (reg & SYSBVM_X86_REG_HALF_MASK) != SYSBVM_X86_RBP);
+    if(reg > SYSBVM_X86_REG_HALF_MASK)
+        sysbvm_bytecodeJit_addByte(jit, sysbvm_jit_x86_rex(false, false, false, true));
+
+    uint8_t instruction[] = {
+        0xFF,
+        sysbvm_jit_x86_modRM(reg, 2, 0),
+    };
+
+    sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+}
+
+static size_t sysbvm_jit_x86_jumpForward(sysbvm_bytecodeJit_t *jit)
+{
+    uint8_t instruction[] = {
+        0xE9, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    return sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction) - 4;
+}
+
+static size_t sysbvm_jit_x86_jumpConditionalForward(sysbvm_bytecodeJit_t *jit, sysbvm_x86_condition_t condition)
+{
+    uint8_t instruction[] = {
+        0x0F, 0x80 + condition, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    return sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction) - 4;
+}
+
+static void sysbvm_jit_x86_patchForwardJumpToHere(sysbvm_bytecodeJit_t *jit, size_t jumpDisplacementOffset)
+{
+    int32_t displacement = (int32_t)(jit->instructions.size - (jumpDisplacementOffset + 4));
+    memcpy(jit->instructions.data + jumpDisplacementOffset, &displacement, 4);
+}
+
+static void sysbvm_jit_x86_jumpBackwardTo(sysbvm_bytecodeJit_t *jit, size_t targetOffset)
+{
+    size_t jumpDisplacementOffset = sysbvm_jit_x86_jumpForward(jit);
+    int32_t displacement = (int32_t)((intptr_t)targetOffset - (intptr_t)(jumpDisplacementOffset + 4));
+    memcpy(jit->instructions.data + jumpDisplacementOffset, &displacement, 4);
+}
+
 static void sysbvm_jit_x86_jitLoadContextInRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x86_register_t reg)
 {
     sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, reg, SYSBVM_X86_RBP, jit->contextPointerOffset);
@@ -608,8 +971,23 @@ static void sysbvm_jit_functionApplyVia(sysbvm_bytecodeJit_t *jit, int16_t resul
 
 }
 
-static void sysbvm_jit_functionApplyDirectVia(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, void *calledFunctionPointer)
+static void sysbvm_jit_functionApplyLinkedVia(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, void *trampoline)
 {
+    // Pass the arguments in registers when the callee has a register arguments entry.
+    if(argumentCount <= SYSBVM_JIT_REGISTER_ARGUMENT_COUNT)
+    {
+        sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+        sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG1, functionOperand);
+        for(size_t i = 0; i < argumentCount; ++i)
+            sysbvm_jit_moveOperandToRegister(jit, sysbvm_jit_x86_argumentRegisters[i], argumentOperands[i]);
+
+        sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_RAX, (uint64_t)(uintptr_t)((uint8_t*)trampoline + SYSBVM_JIT_TRAMPOLINE_REGISTER_ARGUMENTS_TARGET_OFFSET));
+        sysbvm_jit_x86_callIndirectRegister(jit, SYSBVM_X86_RAX);
+
+        sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+        return;
+    }
+
     // Move the arguments into the call vector.
     for(size_t i = 0; i < argumentCount; ++i)
         sysbvm_jit_moveOperandToCallArgumentVector(jit, argumentOperands[i], (int32_t)i);
@@ -619,7 +997,9 @@ static void sysbvm_jit_functionApplyDirectVia(sysbvm_bytecodeJit_t *jit, int16_t
     sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG2, (int32_t)argumentCount);
     sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_64_ARG3, SYSBVM_X86_RBP, jit->callArgumentVectorOffset);
 
-    sysbvm_jit_x86_call(jit, calledFunctionPointer);
+    // Call through the target of the trampoline, which is re-patched when the callee is compiled or redefined.
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_RAX, (uint64_t)(uintptr_t)((uint8_t*)trampoline + SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET));
+    sysbvm_jit_x86_callIndirectRegister(jit, SYSBVM_X86_RAX);
 
     sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
 }
@@ -641,65 +1021,171 @@ static void sysbvm_jit_functionApplyDirectWithArgumentsRecord(sysbvm_bytecodeJit
     sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorSizeOffset, 0);
 }
 
-static void *sysbvm_jit_getTrampolineOrEntryPointForBytecode(sysbvm_bytecodeJit_t *jit, sysbvm_functionBytecode_t *bytecode)
+static void *sysbvm_jit_getRegisterArgumentsTrampolineDestinationForBytecode(sysbvm_functionBytecode_t *bytecode)
 {
-    // Attempt direct entry first.
-    if(bytecode->jittedCode && bytecode->jittedCodeSessionToken == jit->context->roots.sessionToken)
-        return (void*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCode);
+    size_t argumentCount = sysbvm_tuple_size_decode(bytecode->argumentCount);
+    return argumentCount <= SYSBVM_JIT_REGISTER_ARGUMENT_COUNT ? sysbvm_jit_x86_registerArgumentsTrampolineDestinations[argumentCount] : NULL;
+}
 
-    if(bytecode->jittedCodeTrampoline && bytecode->jittedCodeTrampolineSessionToken == jit->context->roots.sessionToken)
+static void *sysbvm_jit_getTrampolineForBytecode(sysbvm_context_t *context, sysbvm_functionBytecode_t *bytecode)
+{
+    if(bytecode->jittedCodeTrampoline && bytecode->jittedCodeTrampolineSessionToken == context->roots.sessionToken)
         return (void*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCodeTrampoline);
 
-    uint64_t trampolineTargetAddress = (uint64_t)(uintptr_t)&sysbvm_bytecodeInterpreter_applyJitTrampolineDestination;
-
-    uint8_t trampolineCode[] = {
+    uint8_t trampolineCode[SYSBVM_JIT_TRAMPOLINE_SIZE] = {
         // Endbr64
         0xF3, 0x0F, 0x1E, 0xFA,
 
-        // Mov64
-        sysbvm_jit_x86_rex(true, false, false, false),
-        0xB8 + SYSBVM_X86_RAX,
-        trampolineTargetAddress & 0xFF, (trampolineTargetAddress >> 8) & 0xFF, (trampolineTargetAddress >> 16) & 0xFF, (trampolineTargetAddress >> 24) & 0xFF,
-        (trampolineTargetAddress >> 32) & 0xFF, (trampolineTargetAddress >> 40) & 0xFF, (trampolineTargetAddress >> 48) & 0xFF, (trampolineTargetAddress >> 56) & 0xFF,
-
-        // Jmp RAX
+        // Jmp [RIP + 6]
         0xFF,
-        sysbvm_jit_x86_modRMRegister(SYSBVM_X86_RAX, 4),
+        sysbvm_jit_x86_modRM(5, 4, 0),
+        SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET - 10, 0x00, 0x00, 0x00,
+
+        // Int3 padding
+        0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC,
     };
 
+    // The jump target is also called directly by the linked call sites.
+    uintptr_t trampolineTargetAddress = (uintptr_t)&sysbvm_bytecodeInterpreter_applyJitTrampolineDestination;
+    memcpy(trampolineCode + SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET, &trampolineTargetAddress, sizeof(trampolineTargetAddress));
+
+    uintptr_t registerArgumentsTargetAddress = (uintptr_t)sysbvm_jit_getRegisterArgumentsTrampolineDestinationForBytecode(bytecode);
+    memcpy(trampolineCode + SYSBVM_JIT_TRAMPOLINE_REGISTER_ARGUMENTS_TARGET_OFFSET, &registerArgumentsTargetAddress, sizeof(registerArgumentsTargetAddress));
+
     // Install the trampoline in the code zone.
-    size_t trampolineCodeSize = sizeof(trampolineCode);
-    size_t requiredCodeSize = sysbvm_sizeAlignedTo(trampolineCodeSize, 16);
+    sysbvm_heap_codeBlock_t *trampolineCodeBlock = sysbvm_heap_createCodeBlock(&context->heap, (sysbvm_tuple_t)bytecode);
+    sysbvm_heap_allocateCodeBlockMemory(&context->heap, trampolineCodeBlock, sizeof(trampolineCode));
+    uint8_t *trampolineWritePointer = trampolineCodeBlock->writeableMapping;
+    uint8_t *trampolineExecutablePointer = trampolineCodeBlock->executableMapping;
 
-    uint8_t *trampolineWritePointer = NULL;
-    uint8_t *trampolineExecutablePointer = NULL;
-    sysbvm_chunkedAllocator_allocateWithDualMapping(&jit->context->heap.codeAllocator, requiredCodeSize, 16, (void**)&trampolineWritePointer, (void**)&trampolineExecutablePointer);
+    memset(trampolineWritePointer, 0xcc, trampolineCodeBlock->size); // int3;
+    memcpy(trampolineWritePointer, trampolineCode, sizeof(trampolineCode));
 
-    memset(trampolineWritePointer, 0xcc, requiredCodeSize); // int3;
-    memcpy(trampolineWritePointer, trampolineCode, trampolineCodeSize);
+    bytecode->jittedCodeTrampoline = sysbvm_tuple_systemHandle_encode(context, (sysbvm_systemHandle_t)(uintptr_t)trampolineExecutablePointer);
+    bytecode->jittedCodeTrampolineWritePointer = sysbvm_tuple_systemHandle_encode(context, (sysbvm_systemHandle_t)(uintptr_t)trampolineWritePointer);
+    bytecode->jittedCodeTrampolineSessionToken = context->roots.sessionToken;
 
-    bytecode->jittedCodeTrampoline = sysbvm_tuple_systemHandle_encode(jit->context, (sysbvm_systemHandle_t)(uintptr_t)trampolineExecutablePointer);
-    bytecode->jittedCodeTrampolineWritePointer = sysbvm_tuple_systemHandle_encode(jit->context, (sysbvm_systemHandle_t)(uintptr_t)trampolineWritePointer);
-    bytecode->jittedCodeTrampolineSessionToken = jit->context->roots.sessionToken;
+    // Skip the interpreter entry when the final code is already present.
+    if(bytecode->jittedCode && bytecode->jittedCodeSessionToken == context->roots.sessionToken)
+        sysbvm_jit_patchTrampolineWithRealEntryPoint(context, bytecode);
 
     return trampolineExecutablePointer;
 }
 
-SYSBVM_API void sysbvm_jit_patchTrampolineWithRealEntryPoint(sysbvm_bytecodeJit_t *jit, sysbvm_functionBytecode_t *bytecode)
+static void sysbvm_jit_patchTrampolineTarget(sysbvm_functionBytecode_t *bytecode, size_t targetOffset, void *target)
+{
+    uint8_t *trampolineWritePointer = (uint8_t*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCodeTrampolineWritePointer);
+
+    // The target is aligned, so a single store swaps the destination atomically for the concurrent callers.
+    _Atomic(uintptr_t) *targetLocation = (_Atomic(uintptr_t)*)(trampolineWritePointer + targetOffset);
+    atomic_store_explicit(targetLocation, (uintptr_t)target, memory_order_release);
+}
+
+SYSBVM_API void sysbvm_jit_patchTrampolineWithRealEntryPoint(sysbvm_context_t *context, sysbvm_functionBytecode_t *bytecode)
 {
-    if(bytecode->jittedCodeTrampoline && bytecode->jittedCodeTrampolineWritePointer && bytecode->jittedCodeTrampolineSessionToken == jit->context->roots.sessionToken)
+    if(bytecode->jittedCodeTrampoline && bytecode->jittedCodeTrampolineWritePointer && bytecode->jittedCodeTrampolineSessionToken == context->roots.sessionToken)
     {
-        uint8_t *realEntryPoint = (uint8_t*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCode);
-        uint8_t *trampolineEntryPointWritePointer = (uint8_t*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCodeTrampolineWritePointer);
+        // Code without a register arguments entry is still reached through the generic application.
+        void *registerArgumentsEntryPoint = (void*)sysbvm_tuple_systemHandle_decode(bytecode->jittedRegisterArgumentsEntryPoint);
+        if(!registerArgumentsEntryPoint)
+            registerArgumentsEntryPoint = sysbvm_jit_getRegisterArgumentsTrampolineDestinationForBytecode(bytecode);
 
-        size_t trampolineCodeSize = 16;
-        size_t targetAddressOffset = trampolineCodeSize - 2 - sizeof(void*);
-        uintptr_t *jumpAddressLocation = (uintptr_t*)(trampolineEntryPointWritePointer + targetAddressOffset);
-        *jumpAddressLocation = (uintptr_t)realEntryPoint;
+        sysbvm_jit_patchTrampolineTarget(bytecode, SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET, (void*)sysbvm_tuple_systemHandle_decode(bytecode->jittedCode));
+        sysbvm_jit_patchTrampolineTarget(bytecode, SYSBVM_JIT_TRAMPOLINE_REGISTER_ARGUMENTS_TARGET_OFFSET, registerArgumentsEntryPoint);
     }
 }
 
-SYSBVM_API void sysbvm_jit_functionApply(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+SYSBVM_API void sysbvm_jit_unlinkTrampoline(sysbvm_context_t *context, sysbvm_functionBytecode_t *bytecode)
+{
+    if(bytecode->jittedCodeTrampoline && bytecode->jittedCodeTrampolineWritePointer && bytecode->jittedCodeTrampolineSessionToken == context->roots.sessionToken)
+    {
+        sysbvm_jit_patchTrampolineTarget(bytecode, SYSBVM_JIT_TRAMPOLINE_TARGET_OFFSET, (void*)&sysbvm_bytecodeInterpreter_applyJitUnlinkedTrampolineDestination);
+        sysbvm_jit_patchTrampolineTarget(bytecode, SYSBVM_JIT_TRAMPOLINE_REGISTER_ARGUMENTS_TARGET_OFFSET, sysbvm_jit_getRegisterArgumentsTrampolineDestinationForBytecode(bytecode));
+
+        // Never link it again.
+        bytecode->jittedCodeTrampolineWritePointer = sysbvm_tuple_systemHandle_encode(context, 0);
+    }
+}
+
+static size_t sysbvm_jit_integerPrimitiveFastPath(sysbvm_bytecodeJit_t *jit, const sysbvm_bytecodeJitIntegerPrimitive_t *primitive, int16_t resultOperand, int16_t leftOperand, int16_t rightOperand, size_t *slowPathJumps, size_t *slowPathJumpCount)
+{
+    // Both operands must be immediates with the primitive tag.
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, leftOperand);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_R11, rightOperand);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    sysbvm_jit_x86_cmpImmediate8(jit, SYSBVM_X86_R10, primitive->tag);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_R11);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    sysbvm_jit_x86_cmpImmediate8(jit, SYSBVM_X86_R10, primitive->tag);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+
+    // The operations work on the encoded values. An overflow means that the result does not fit in an immediate.
+    sysbvm_x86_condition_t comparisonCondition = SYSBVM_X86_CONDITION_E;
+    switch(primitive->operation)
+    {
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_ADD:
+        sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_RAX, ~SYSBVM_TUPLE_TAG_BIT_MASK);
+        sysbvm_jit_x86_add64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_O);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_SUBTRACT:
+        sysbvm_jit_x86_sub64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_O);
+        sysbvm_jit_x86_orImmediate8(jit, SYSBVM_X86_RAX, primitive->tag);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_MULTIPLY:
+        sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_RAX, ~SYSBVM_TUPLE_TAG_BIT_MASK);
+        sysbvm_jit_x86_arithmeticShiftRightImmediate(jit, SYSBVM_X86_R11, SYSBVM_TUPLE_TAG_BIT_COUNT);
+        sysbvm_jit_x86_imul64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_O);
+        sysbvm_jit_x86_orImmediate8(jit, SYSBVM_X86_RAX, primitive->tag);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_AND:
+        sysbvm_jit_x86_and64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_OR:
+        sysbvm_jit_x86_or64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_BIT_XOR:
+        sysbvm_jit_x86_xorRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        sysbvm_jit_x86_orImmediate8(jit, SYSBVM_X86_RAX, primitive->tag);
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_EQUALS:
+        comparisonCondition = SYSBVM_X86_CONDITION_E;
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_NOT_EQUALS:
+        comparisonCondition = SYSBVM_X86_CONDITION_NE;
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_THAN:
+        comparisonCondition = primitive->isSigned ? SYSBVM_X86_CONDITION_L : SYSBVM_X86_CONDITION_B;
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_LESS_EQUALS:
+        comparisonCondition = primitive->isSigned ? SYSBVM_X86_CONDITION_LE : SYSBVM_X86_CONDITION_BE;
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_THAN:
+        comparisonCondition = primitive->isSigned ? SYSBVM_X86_CONDITION_G : SYSBVM_X86_CONDITION_A;
+        break;
+    case SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_GREATER_EQUALS:
+        comparisonCondition = primitive->isSigned ? SYSBVM_X86_CONDITION_GE : SYSBVM_X86_CONDITION_AE;
+        break;
+    }
+
+    // The encoding preserves the order of the values with the same tag.
+    if(primitive->operation >= SYSBVM_BYTECODE_JIT_INTEGER_OPERATION_EQUALS)
+    {
+        sysbvm_jit_x86_cmpRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_RAX, (int32_t)SYSBVM_FALSE_TUPLE);
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_R10, (int32_t)SYSBVM_TRUE_TUPLE);
+        sysbvm_jit_x86_cmov64Register(jit, comparisonCondition, SYSBVM_X86_RAX, SYSBVM_X86_R10);
+    }
+
+    sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+    return sysbvm_jit_x86_jumpForward(jit);
+}
+
+static void sysbvm_jit_functionApplyWithoutInlining(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
 {
     bool isNoTypecheck = applicationFlags & SYSBVM_FUNCTION_APPLICATION_FLAGS_NO_TYPECHECK;
 
@@ -725,18 +1211,20 @@ SYSBVM_API void sysbvm_jit_functionApply(sysbvm_bytecodeJit_t *jit, int16_t resu
             }
         }
         
-        if(literalFunctionObject->definition)
+        // The argument count and the lazy analysis are resolved at link time. The compiler already checked the argument types.
+        if(literalFunctionObject->definition
+            && !literalFunctionObject->captureEnvironment
+            && sysbvm_function_getArgumentCount(jit->context, literalFunction) == argumentCount)
         {
             sysbvm_functionDefinition_t *literalFunctionDefinitionObject = (sysbvm_functionDefinition_t*)literalFunctionObject->definition;
             if(literalFunctionDefinitionObject->bytecode && literalFunctionDefinitionObject->bytecode != SYSBVM_PENDING_MEMOIZATION_VALUE)
             {
-                void *trampolineOrEntryPoint = sysbvm_jit_getTrampolineOrEntryPointForBytecode(jit, (sysbvm_functionBytecode_t*)literalFunctionDefinitionObject->bytecode);
-                if(trampolineOrEntryPoint)
-                {
-                    //printf("trampolineOrEntryPoint %p\n", trampolineOrEntryPoint);
-                    sysbvm_jit_functionApplyDirectVia(jit, resultOperand, functionOperand, argumentCount, argumentOperands, trampolineOrEntryPoint);
-                    return;
-                }
+                void *trampoline = sysbvm_jit_getTrampolineForBytecode(jit->context, (sysbvm_functionBytecode_t*)literalFunctionDefinitionObject->bytecode);
+
+                // The called code must outlive this code, even if the function definition is analyzed again.
+                sysbvm_heap_addCodeBlockRetainedObject(jit->codeBlock, literalFunctionDefinitionObject->bytecode);
+                sysbvm_jit_functionApplyLinkedVia(jit, resultOperand, functionOperand, argumentCount, argumentOperands, trampoline);
+                return;
             }
         }
     }
@@ -744,15 +1232,198 @@ SYSBVM_API void sysbvm_jit_functionApply(sysbvm_bytecodeJit_t *jit, int16_t resu
     sysbvm_jit_functionApplyVia(jit, resultOperand, functionOperand, argumentCount, argumentOperands, applicationFlags, &sysbvm_bytecodeInterpreter_functionApplyNoCopyArguments);
 }
 
-SYSBVM_API void sysbvm_jit_send(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+SYSBVM_API void sysbvm_jit_functionApply(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+{
+    // Calls to the integer primitives have an inline path for the immediate operands.
+    sysbvm_tuple_t literalFunction = SYSBVM_NULL_TUPLE;
+    sysbvm_bytecodeJitIntegerPrimitive_t integerPrimitive;
+    if(argumentCount == 2
+        && sysbvm_bytecodeJit_getLiteralValueForOperand(jit, functionOperand, &literalFunction)
+        && sysbvm_bytecodeJit_getIntegerPrimitiveForFunction(jit, literalFunction, &integerPrimitive))
+    {
+        size_t slowPathJumps[5];
+        size_t slowPathJumpCount = 0;
+        size_t doneJump = sysbvm_jit_integerPrimitiveFastPath(jit, &integerPrimitive, resultOperand, argumentOperands[0], argumentOperands[1], slowPathJumps, &slowPathJumpCount);
+        for(size_t i = 0; i < slowPathJumpCount; ++i)
+            sysbvm_jit_x86_patchForwardJumpToHere(jit, slowPathJumps[i]);
+
+        sysbvm_jit_functionApplyWithoutInlining(jit, resultOperand, functionOperand, argumentCount, argumentOperands, applicationFlags);
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, doneJump);
+        return;
+    }
+
+    sysbvm_jit_functionApplyWithoutInlining(jit, resultOperand, functionOperand, argumentCount, argumentOperands, applicationFlags);
+}
+
+static void *sysbvm_jit_getInlineCacheEntryPointForMethod(sysbvm_context_t *context, sysbvm_tuple_t method, size_t argumentCount, sysbvm_tuple_t *outEntryPointOwner)
 {
+    // Only the methods that can skip sysbvm_function_apply are entered directly from the inline cache.
+    if(!sysbvm_tuple_isFunction(context, method)
+        || sysbvm_function_isMemoized(context, method)
+        || sysbvm_function_isVariadic(context, method)
+        || sysbvm_function_getArgumentCount(context, method) != argumentCount)
+        return NULL;
+
+    sysbvm_function_t *methodObject = (sysbvm_function_t*)method;
+    if(methodObject->captureEnvironment)
+        return NULL;
+
+    if(methodObject->primitiveTableIndex)
+    {
+        sysbvm_functionEntryPoint_t entryPoint = sysbvm_function_getNumberedPrimitiveEntryPoint(context, sysbvm_tuple_uint32_decode(methodObject->primitiveTableIndex));
+        if(entryPoint)
+            return (void*)entryPoint;
+    }
+
+    sysbvm_functionDefinition_t *methodDefinitionObject = (sysbvm_functionDefinition_t*)methodObject->definition;
+    if(!methodDefinitionObject || !methodDefinitionObject->bytecode || methodDefinitionObject->bytecode == SYSBVM_PENDING_MEMOIZATION_VALUE)
+        return NULL;
+
+    // Enter through the trampoline, which is unlinked when the method adopts another definition.
+    *outEntryPointOwner = methodDefinitionObject->bytecode;
+    return sysbvm_jit_getTrampolineForBytecode(context, (sysbvm_functionBytecode_t*)methodDefinitionObject->bytecode);
+}
+
+static sysbvm_tuple_t sysbvm_jit_sendInlineCacheMiss(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags)
+{
+    sysbvm_tuple_t receiverType = sysbvm_tuple_getType(context, receiverAndArguments[0]);
+    sysbvm_tuple_t method = SYSBVM_NULL_TUPLE;
+    if(!sysbvm_pic_lookupTypeAndSelector(pic, selector, receiverType, &method))
+    {
+        method = sysbvm_type_lookupSelector(context, receiverType, selector);
+        sysbvm_pic_addSelectorTypeAndMethod(context, pic, selector, receiverType, method);
+    }
+
+    // Repatch the inline cache with the last seen receiver type.
+    sysbvm_tuple_t methodEntryPointOwner = SYSBVM_NULL_TUPLE;
+    void *methodEntryPoint = method ? sysbvm_jit_getInlineCacheEntryPointForMethod(context, method, argumentCount + 1, &methodEntryPointOwner) : NULL;
+    if(receiverType && methodEntryPoint)
+        sysbvm_pic_setInlineCache(pic, selector, receiverType, method, methodEntryPoint, methodEntryPointOwner);
+
+    return sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(context, pic, receiverType, selector, argumentCount, receiverAndArguments, applicationFlags);
+}
+
+static sysbvm_tuple_t sysbvm_jit_sendWithNonLiteralSelector(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags)
+{
+    // The inline cache is keyed only on the receiver type, so it is never filled for a site whose selector changes between sends.
+    sysbvm_tuple_t receiverType = sysbvm_tuple_getType(context, receiverAndArguments[0]);
+    return sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(context, pic, receiverType, selector, argumentCount, receiverAndArguments, applicationFlags);
+}
+
+static sysbvm_tuple_t sysbvm_jit_sendVirtualInlineCacheMiss(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, size_t argumentCount, sysbvm_tuple_t *receiverAndArguments, sysbvm_bitflags_t applicationFlags, size_t virtualTableIndex)
+{
+    // The dispatch table slot replaces the PIC and global cache lookups.
+    sysbvm_tuple_t receiverType = sysbvm_tuple_getType(context, receiverAndArguments[0]);
+    sysbvm_tuple_t method = sysbvm_type_lookupSelectorWithVirtualTableIndex(context, receiverType, selector, virtualTableIndex);
+    if(!method)
+        return sysbvm_bytecodeInterpreter_interpretSendWithReceiverTypeNoCopyArguments(context, pic, receiverType, selector, argumentCount, receiverAndArguments, applicationFlags);
+
+    // The PIC entry registers the selector dependency that flushes the repatched inline cache.
+    sysbvm_pic_addSelectorTypeAndMethod(context, pic, selector, receiverType, method);
+    sysbvm_tuple_t methodEntryPointOwner = SYSBVM_NULL_TUPLE;
+    void *methodEntryPoint = sysbvm_jit_getInlineCacheEntryPointForMethod(context, method, argumentCount + 1, &methodEntryPointOwner);
+    if(receiverType && methodEntryPoint)
+        sysbvm_pic_setInlineCache(pic, selector, receiverType, method, methodEntryPoint, methodEntryPointOwner);
+
+    return sysbvm_bytecodeInterpreter_functionApplyNoCopyArguments(context, method, argumentCount + 1, receiverAndArguments, applicationFlags);
+}
+
+static void sysbvm_jit_inlineCacheLoadReceiverType(sysbvm_bytecodeJit_t *jit, size_t *missJumps, size_t *missJumpCount)
+{
+    // RAX <- type of RAX. Uses R10 and R11 as scratch registers.
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    size_t pointerOrNilJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+
+    // Tagged immediates and trivial values.
+    sysbvm_jit_x86_cmpImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_TRIVIAL);
+    size_t taggedImmediateJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_logicalShiftRightImmediate(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_COUNT);
+    sysbvm_jit_x86_cmpImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_IMMEDIATE_TRIVIAL_COUNT);
+    missJumps[(*missJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_AE);
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uint64_t)(uintptr_t)jit->context->roots.immediateTrivialTypeTable);
+    size_t trivialTableJump = sysbvm_jit_x86_jumpForward(jit);
+
+    // Object pointers. Nil uses the first entry of the immediate type table.
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, pointerOrNilJump);
+    sysbvm_jit_x86_testRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX);
+    size_t nilJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX, offsetof(sysbvm_tuple_header_t, typePointer));
+    size_t pointerTypeJump = sysbvm_jit_x86_jumpForward(jit);
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, taggedImmediateJump);
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, nilJump);
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uint64_t)(uintptr_t)jit->context->roots.immediateTypeTable);
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, trivialTableJump);
+    sysbvm_jit_x86_mov64FromMemoryIndexedScaled8(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11, SYSBVM_X86_R10);
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, pointerTypeJump);
+}
+
+static void sysbvm_jit_sendWithInlineCache(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t selectorOperand, bool hasVirtualTableIndex, size_t virtualTableIndex, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+{
+    // Sends of the Integer arithmetic and comparison selectors have an inline path for the immediate operands.
+    sysbvm_tuple_t literalSelector = SYSBVM_NULL_TUPLE;
+    sysbvm_bytecodeJitIntegerPrimitive_t integerPrimitive;
+    bool hasLiteralSelector = sysbvm_bytecodeJit_getLiteralValueForOperand(jit, selectorOperand, &literalSelector);
+    bool hasIntegerFastPath = hasLiteralSelector
+        && sysbvm_bytecodeJit_getIntegerPrimitiveForSelector(jit, literalSelector, argumentCount, &integerPrimitive);
+    size_t integerFastPathDoneJump = 0;
+    if(hasIntegerFastPath)
+    {
+        size_t slowPathJumps[5];
+        size_t slowPathJumpCount = 0;
+        integerFastPathDoneJump = sysbvm_jit_integerPrimitiveFastPath(jit, &integerPrimitive, resultOperand, argumentOperands[0], argumentOperands[1], slowPathJumps, &slowPathJumpCount);
+        for(size_t i = 0; i < slowPathJumpCount; ++i)
+            sysbvm_jit_x86_patchForwardJumpToHere(jit, slowPathJumps[i]);
+    }
+
     // Move the arguments into the call vector.
     for(size_t i = 0; i < argumentCount + 1; ++i)
         sysbvm_jit_moveOperandToCallArgumentVector(jit, argumentOperands[i], (int32_t)i);
 
-    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+    sysbvm_pic_t *pic = sysbvm_heap_createCodeBlockPIC(jit->codeBlock);
+
+    // Inline cache check on the receiver type. The cache entry does not check the selector, so it is only usable with literal selectors.
+    size_t missJumps[4];
+    size_t missJumpCount = 0;
+    size_t hitDoneJump = 0;
+    if(hasLiteralSelector)
+    {
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RBP, jit->callArgumentVectorOffset);
+        sysbvm_jit_inlineCacheLoadReceiverType(jit, missJumps, &missJumpCount);
+        sysbvm_jit_x86_testRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX);
+        missJumps[missJumpCount++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+
+        sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uint64_t)(uintptr_t)pic);
+        sysbvm_jit_x86_cmp64WithMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11, offsetof(sysbvm_pic_t, inlineCacheEntry.type));
+        missJumps[missJumpCount++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_R11, offsetof(sysbvm_pic_t, inlineCacheEntry.method));
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_R11, offsetof(sysbvm_pic_t, inlineCacheEntryPoint));
+
+        // Check the type again, in case the cache was repatched while reading it.
+        sysbvm_jit_x86_cmp64WithMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11, offsetof(sysbvm_pic_t, inlineCacheEntry.type));
+        missJumps[missJumpCount++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+        SYSBVM_ASSERT(missJumpCount <= sizeof(missJumps) / sizeof(missJumps[0]));
+
+        // Hit: enter the cached method directly, keeping the arguments alive for primitives.
+        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorSizeOffset, (int32_t)(argumentCount + 1));
+        sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG2, (int32_t)(argumentCount + 1));
+        sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_64_ARG3, SYSBVM_X86_RBP, jit->callArgumentVectorOffset);
+        sysbvm_jit_x86_callRegister(jit, SYSBVM_X86_R10);
+        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorSizeOffset, 0);
+        hitDoneJump = sysbvm_jit_x86_jumpForward(jit);
+    }
+
+    // Miss: perform the lookup in the runtime, which also repatches the inline cache.
+    for(size_t i = 0; i < missJumpCount; ++i)
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, missJumps[i]);
 
-    sysbvm_pic_t *pic = (sysbvm_pic_t*)sysbvm_chunkedAllocator_allocate(&jit->context->heap.picTableAllocator, sizeof(sysbvm_pic_t), sizeof(uintptr_t));
+    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
     sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_64_ARG1, (uint64_t)pic);
 
     sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, selectorOperand);
@@ -764,14 +1435,43 @@ SYSBVM_API void sysbvm_jit_send(sysbvm_bytecodeJit_t *jit, int16_t resultOperand
     sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RSP, 4*sizeof(void*), SYSBVM_X86_RAX);
 
     sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RSP, 5*sizeof(void*), applicationFlags);
+    if(hasVirtualTableIndex)
+        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RSP, 6*sizeof(void*), (int32_t)virtualTableIndex);
 #else
     sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_SYSV_ARG4, SYSBVM_X86_RBP, jit->callArgumentVectorOffset);
 
     sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_SYSV_ARG5, applicationFlags);
+    if(hasVirtualTableIndex)
+        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RSP, 0*sizeof(void*), (int32_t)virtualTableIndex);
 #endif
-    sysbvm_jit_x86_call(jit, &sysbvm_bytecodeInterpreter_interpretSendNoCopyArguments);
+    if(!hasLiteralSelector)
+        sysbvm_jit_x86_call(jit, &sysbvm_jit_sendWithNonLiteralSelector);
+    else if(hasVirtualTableIndex)
+        sysbvm_jit_x86_call(jit, &sysbvm_jit_sendVirtualInlineCacheMiss);
+    else
+        sysbvm_jit_x86_call(jit, &sysbvm_jit_sendInlineCacheMiss);
 
+    if(hasLiteralSelector)
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, hitDoneJump);
     sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+
+    if(hasIntegerFastPath)
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, integerFastPathDoneJump);
+}
+
+SYSBVM_API void sysbvm_jit_send(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+{
+    sysbvm_jit_sendWithInlineCache(jit, resultOperand, selectorOperand, false, 0, argumentCount, argumentOperands, applicationFlags);
+}
+
+SYSBVM_API void sysbvm_jit_sendVirtual(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t virtualTableIndexOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
+{
+    // The virtual table index is only used by the inline cache miss, so it must be known when compiling.
+    sysbvm_tuple_t literalVirtualTableIndex = SYSBVM_NULL_TUPLE;
+    bool hasVirtualTableIndex = sysbvm_bytecodeJit_getLiteralValueForOperand(jit, virtualTableIndexOperand, &literalVirtualTableIndex)
+        && sysbvm_tuple_isImmediate(literalVirtualTableIndex)
+        && sysbvm_tuple_size_decode(literalVirtualTableIndex) <= INT32_MAX;
+    sysbvm_jit_sendWithInlineCache(jit, resultOperand, selectorOperand, hasVirtualTableIndex, hasVirtualTableIndex ? sysbvm_tuple_size_decode(literalVirtualTableIndex) : 0, argumentCount, argumentOperands, applicationFlags);
 }
 
 SYSBVM_API void sysbvm_jit_sendWithReceiverType(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t receiverTypeOperand, int16_t selectorOperand, size_t argumentCount, int16_t *argumentOperands, int applicationFlags)
@@ -782,7 +1482,7 @@ SYSBVM_API void sysbvm_jit_sendWithReceiverType(sysbvm_bytecodeJit_t *jit, int16
 
     sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
 
-    sysbvm_pic_t *pic = (sysbvm_pic_t*)sysbvm_chunkedAllocator_allocate(&jit->context->heap.picTableAllocator, sizeof(sysbvm_pic_t), sizeof(uintptr_t));
+    sysbvm_pic_t *pic = sysbvm_heap_createCodeBlockPIC(jit->codeBlock);
     sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_64_ARG1, (uint64_t)pic);
 
     sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, receiverTypeOperand);
@@ -807,14 +1507,192 @@ SYSBVM_API void sysbvm_jit_sendWithReceiverType(sysbvm_bytecodeJit_t *jit, int16
     sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
 }
 
+static void sysbvm_jit_slotAccessPrologue(sysbvm_bytecodeJit_t *jit, int16_t tupleOperand, int16_t typeSlotOperand, bool isReference, uint32_t rejectedFlags, size_t *slowPathJumps, size_t *slowPathJumpCount)
+{
+    // RAX <- the tuple.
+    if(isReference)
+    {
+        sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+        sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG1, tupleOperand);
+        sysbvm_jit_x86_call(jit, &sysbvm_pointerLikeType_load);
+    }
+    else
+    {
+        sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, tupleOperand);
+    }
+
+    // R11 <- slot index * sizeof(sysbvm_tuple_t). The index is read on each access because the layout of a type can be recomputed.
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_R11, typeSlotOperand);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R11, SYSBVM_X86_R11, offsetof(sysbvm_typeSlot_t, index));
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_R11);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R11, ~SYSBVM_TUPLE_TAG_BIT_MASK);
+    sysbvm_jit_x86_logicalShiftRightImmediate(jit, SYSBVM_X86_R11, SYSBVM_TUPLE_TAG_BIT_COUNT - 3);
+
+    // Only non-null pointer tuples, without bytes, weak or dummy contents.
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+    sysbvm_jit_x86_testRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+    sysbvm_jit_x86_test32MemoryWithImmediate32(jit, SYSBVM_X86_RAX, offsetof(sysbvm_tuple_header_t, identityHashAndFlags),
+        SYSBVM_TUPLE_OBJECT_KIND_MASK | SYSBVM_TUPLE_FLAGS_DUMMY_VALUE | rejectedFlags);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+
+    // Bounds check.
+    sysbvm_jit_x86_mov32FromMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX, offsetof(sysbvm_tuple_header_t, objectSize));
+    sysbvm_jit_x86_cmpRegister(jit, SYSBVM_X86_R11, SYSBVM_X86_R10);
+    slowPathJumps[(*slowPathJumpCount)++] = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_AE);
+}
+
+SYSBVM_API void sysbvm_jit_slotAt(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t tupleOperand, int16_t typeSlotOperand, bool isReference)
+{
+    size_t slowPathJumps[5];
+    size_t slowPathJumpCount = 0;
+    sysbvm_jit_slotAccessPrologue(jit, tupleOperand, typeSlotOperand, isReference, 0, slowPathJumps, &slowPathJumpCount);
+
+    sysbvm_jit_x86_mov64FromMemoryIndexedWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX, SYSBVM_X86_R11, sizeof(sysbvm_tuple_header_t));
+    size_t doneJump = sysbvm_jit_x86_jumpForward(jit);
+
+    // Slow path: the generic slot access, which also raises the errors.
+    for(size_t i = 0; i < slowPathJumpCount; ++i)
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, slowPathJumps[i]);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, typeSlotOperand);
+    sysbvm_jit_x86_call(jit, &sysbvm_bytecodeJit_slotAt);
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, doneJump);
+    sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+}
+
+SYSBVM_API void sysbvm_jit_slotAtPut(sysbvm_bytecodeJit_t *jit, int16_t tupleOperand, int16_t typeSlotOperand, int16_t valueOperand, bool isReference)
+{
+    size_t slowPathJumps[5];
+    size_t slowPathJumpCount = 0;
+    sysbvm_jit_slotAccessPrologue(jit, tupleOperand, typeSlotOperand, isReference, SYSBVM_TUPLE_FLAGS_IMMUTABLE, slowPathJumps, &slowPathJumpCount);
+
+    // There is no write barrier, because the GC does not have generations.
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_R10, valueOperand);
+    sysbvm_jit_x86_mov64IntoMemoryIndexedWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11, sizeof(sysbvm_tuple_header_t), SYSBVM_X86_R10);
+    size_t doneJump = sysbvm_jit_x86_jumpForward(jit);
+
+    for(size_t i = 0; i < slowPathJumpCount; ++i)
+        sysbvm_jit_x86_patchForwardJumpToHere(jit, slowPathJumps[i]);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, typeSlotOperand);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG3, valueOperand);
+    sysbvm_jit_x86_call(jit, &sysbvm_bytecodeJit_slotAtPut);
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, doneJump);
+}
+
+static void sysbvm_jit_allocateTupleInAllocationBuffer(sysbvm_bytecodeJit_t *jit, uint32_t objectKind, size_t objectSize, sysbvm_tuple_t *typePointer, bool zeroFill)
+{
+    sysbvm_heap_t *heap = &jit->context->heap;
+    int32_t allocationSize = (int32_t)((sizeof(sysbvm_heap_mallocObjectHeader_t) + sizeof(sysbvm_tuple_header_t) + objectSize + 15) & (~(size_t)15));
+
+    // Bump the allocation buffer pointer.
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uintptr_t)heap);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, allocationBufferPosition));
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX, allocationSize);
+    sysbvm_jit_x86_cmp64WithMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, allocationBufferLimit));
+    size_t slowPathJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_A);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, allocationBufferPosition), SYSBVM_X86_R10);
+
+    // Link the object preheader at the end of the heap object list, like sysbvm_heap_linkObject.
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, lastMallocObject));
+    sysbvm_jit_x86_testRegister(jit, SYSBVM_X86_R10, SYSBVM_X86_R10);
+    size_t emptyHeapJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_E);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_R10, offsetof(sysbvm_heap_mallocObjectHeader_t, next), SYSBVM_X86_RAX);
+    size_t linkedJump = sysbvm_jit_x86_jumpForward(jit);
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, emptyHeapJump);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, firstMallocObject), SYSBVM_X86_RAX);
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, linkedJump);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, lastMallocObject), SYSBVM_X86_RAX);
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_heap_mallocObjectHeader_t, next), 0);
+
+    // size | allocationBufferOffset << 32
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG0, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, currentAllocationBuffer));
+    sysbvm_jit_x86_sub64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_x86_logicalShiftLeftImmediate(jit, SYSBVM_X86_R10, 32);
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_R10, allocationSize);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_heap_mallocObjectHeader_t, size), SYSBVM_X86_R10);
+
+    // The GC threshold already accounts the whole allocation buffer.
+
+    // Generate the identity hash in the same way as sysbvm_context_generateIdentityHash.
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX, sizeof(sysbvm_heap_mallocObjectHeader_t));
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R10, (uintptr_t)&jit->context->identityHashSeed);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_R10, 0);
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_64_ARG0, SYSBVM_HASH_MULTIPLICATION_CONSTANT);
+    sysbvm_jit_x86_imul64Register(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_x86_logicalShiftLeftImmediate(jit, SYSBVM_X86_64_ARG1, 64 - SYSBVM_HASH_BIT_COUNT);
+    sysbvm_jit_x86_logicalShiftRightImmediate(jit, SYSBVM_X86_64_ARG1, 64 - SYSBVM_HASH_BIT_COUNT);
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_64_ARG1, 12345);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_R10, 0, SYSBVM_X86_64_ARG1);
+    sysbvm_jit_x86_logicalShiftLeftImmediate(jit, SYSBVM_X86_64_ARG1, 64 - SYSBVM_TUPLE_IDENTITY_HASH_BITS);
+    sysbvm_jit_x86_logicalShiftRightImmediate(jit, SYSBVM_X86_64_ARG1, 64 - SYSBVM_TUPLE_IDENTITY_HASH_BITS - SYSBVM_TUPLE_IDENTITY_HASH_SHIFT);
+
+    // identityHashAndFlags | objectSize << 32
+    sysbvm_jit_x86_mov32FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG0, SYSBVM_X86_R11, offsetof(sysbvm_heap_t, gcWhiteColor));
+    if(SYSBVM_TUPLE_GC_COLOR_SHIFT)
+        sysbvm_jit_x86_logicalShiftLeftImmediate(jit, SYSBVM_X86_64_ARG0, SYSBVM_TUPLE_GC_COLOR_SHIFT);
+    sysbvm_jit_x86_or64Register(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_64_ARG0, ((uint64_t)objectSize << 32) | (objectKind << SYSBVM_TUPLE_OBJECT_KIND_SHIFT));
+    sysbvm_jit_x86_or64Register(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_tuple_header_t, identityHashAndFlags), SYSBVM_X86_64_ARG1);
+
+    // The type is read at run time from its owner.
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R10, (uintptr_t)typePointer);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_R10, 0);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_tuple_header_t, typePointer), SYSBVM_X86_R10);
+
+    if(zeroFill)
+    {
+        for(size_t i = 0; i < objectSize / sizeof(sysbvm_tuple_t); ++i)
+            sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, (int32_t)(sizeof(sysbvm_tuple_header_t) + i * sizeof(sysbvm_tuple_t)), 0);
+    }
+
+    size_t doneJump = sysbvm_jit_x86_jumpForward(jit);
+
+    // Slow path: refill the allocation buffer.
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, slowPathJump);
+    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_64_ARG1, (uintptr_t)typePointer);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG1, SYSBVM_X86_64_ARG1, 0);
+    if(objectKind == SYSBVM_TUPLE_OBJECT_KIND_BYTES)
+    {
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG2, (int32_t)objectSize);
+        sysbvm_jit_x86_call(jit, &sysbvm_context_allocateByteTupleInAllocationBuffer);
+    }
+    else
+    {
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG2, (int32_t)(objectSize / sizeof(sysbvm_tuple_t)));
+        sysbvm_jit_x86_call(jit, &sysbvm_context_allocatePointerTupleInAllocationBuffer);
+    }
+
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, doneJump);
+}
+
 SYSBVM_API void sysbvm_jit_makeArray(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, size_t elementCount, int16_t *elementOperands)
 {
     if(resultOperand < 0)
         return;
 
-    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
-    sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG1, (int32_t)elementCount);
-    sysbvm_jit_x86_call(jit, &sysbvm_array_create);
+    if(elementCount > 0)
+    {
+        sysbvm_jit_allocateTupleInAllocationBuffer(jit, SYSBVM_TUPLE_OBJECT_KIND_POINTERS, elementCount * sizeof(sysbvm_tuple_t), &jit->context->roots.arrayType, false);
+    }
+    else
+    {
+        sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG1, (int32_t)elementCount);
+        sysbvm_jit_x86_call(jit, &sysbvm_array_create);
+    }
 
     for(size_t i = 0; i < elementCount; ++i)
     {
@@ -830,9 +1708,16 @@ SYSBVM_API void sysbvm_jit_makeByteArray(sysbvm_bytecodeJit_t *jit, int16_t resu
     if(resultOperand < 0)
         return;
 
-    sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
-    sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG1, (int32_t)elementCount);
-    sysbvm_jit_x86_call(jit, &sysbvm_byteArray_create);
+    if(elementCount > 0)
+    {
+        sysbvm_jit_allocateTupleInAllocationBuffer(jit, SYSBVM_TUPLE_OBJECT_KIND_BYTES, elementCount, &jit->context->roots.byteArrayType, false);
+    }
+    else
+    {
+        sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
+        sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG1, (int32_t)elementCount);
+        sysbvm_jit_x86_call(jit, &sysbvm_byteArray_create);
+    }
 
     for(size_t i = 0; i < elementCount; ++i)
     {
@@ -844,6 +1729,19 @@ SYSBVM_API void sysbvm_jit_makeByteArray(sysbvm_bytecodeJit_t *jit, int16_t resu
     sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
 }
 
+SYSBVM_API void sysbvm_jit_makeAssociation(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t keyOperand, int16_t valueOperand)
+{
+    if(resultOperand < 0)
+        return;
+
+    sysbvm_jit_allocateTupleInAllocationBuffer(jit, SYSBVM_TUPLE_OBJECT_KIND_POINTERS, sizeof(sysbvm_association_t) - sizeof(sysbvm_tuple_header_t), &jit->context->roots.associationType, false);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, keyOperand);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_association_t, key), SYSBVM_X86_64_ARG2);
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, valueOperand);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_association_t, value), SYSBVM_X86_64_ARG2);
+    sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+}
+
 SYSBVM_API void sysbvm_jit_makeDictionary(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, size_t elementCount, int16_t *elementOperands)
 {
     if(resultOperand < 0)
@@ -863,11 +1761,61 @@ SYSBVM_API void sysbvm_jit_makeDictionary(sysbvm_bytecodeJit_t *jit, int16_t res
     }
 }
 
+static bool sysbvm_jit_canInlineClosureCreation(sysbvm_bytecodeJit_t *jit, int16_t functionDefinitionOperand, size_t captureCount, sysbvm_functionDefinition_t **outFunctionDefinition)
+{
+    sysbvm_tuple_t functionDefinition;
+    if(!sysbvm_bytecodeJit_getLiteralValueForOperand(jit, functionDefinitionOperand, &functionDefinition)
+        || !sysbvm_tuple_isKindOf(jit->context, functionDefinition, jit->context->roots.functionDefinitionType))
+        return false;
+
+    // The capture vector layout must match the captures emitted by this instruction.
+    sysbvm_functionDefinition_t *functionDefinitionObject = (sysbvm_functionDefinition_t*)functionDefinition;
+    if(!functionDefinitionObject->type || !functionDefinitionObject->captureVectorType)
+        return false;
+
+    size_t captureVectorSlotCount = sysbvm_tuple_size_decode(((sysbvm_type_tuple_t*)functionDefinitionObject->captureVectorType)->totalSlotCount);
+    if(captureCount == 0 || captureVectorSlotCount != captureCount)
+        return false;
+
+    *outFunctionDefinition = functionDefinitionObject;
+    return true;
+}
+
 SYSBVM_API void sysbvm_jit_makeClosureWithCaptures(sysbvm_bytecodeJit_t *jit, int16_t resultOperand, int16_t functionDefinitionOperand, size_t captureCount, int16_t *elementOperands)
 {
     if(resultOperand < 0)
         return;
 
+    sysbvm_functionDefinition_t *functionDefinition = NULL;
+    if(sysbvm_jit_canInlineClosureCreation(jit, functionDefinitionOperand, captureCount, &functionDefinition))
+    {
+        // Make the capture vector.
+        sysbvm_jit_allocateTupleInAllocationBuffer(jit, SYSBVM_TUPLE_OBJECT_KIND_POINTERS, captureCount * sizeof(sysbvm_tuple_t), &functionDefinition->captureVectorType, false);
+        for(size_t i = 0; i < captureCount; ++i)
+        {
+            sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, elementOperands[i]);
+            sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, (int32_t) (sizeof(sysbvm_tuple_header_t) + i * sizeof(void*)), SYSBVM_X86_64_ARG2);
+        }
+        sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+
+        // Now construct the actual closure, as done by sysbvm_function_createClosureWithCaptureVector.
+        sysbvm_jit_allocateTupleInAllocationBuffer(jit, SYSBVM_TUPLE_OBJECT_KIND_POINTERS, sizeof(sysbvm_function_t) - sizeof(sysbvm_tuple_header_t), &functionDefinition->type, true);
+        sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, resultOperand);
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, captureVector), SYSBVM_X86_64_ARG2);
+
+        sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG1, functionDefinitionOperand);
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, definition), SYSBVM_X86_64_ARG1);
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG2, SYSBVM_X86_64_ARG1, offsetof(sysbvm_functionDefinition_t, flags));
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, flags), SYSBVM_X86_64_ARG2);
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG2, SYSBVM_X86_64_ARG1, offsetof(sysbvm_functionDefinition_t, argumentCount));
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, argumentCount), SYSBVM_X86_64_ARG2);
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_64_ARG2, SYSBVM_X86_64_ARG1, offsetof(sysbvm_functionDefinition_t, primitiveName));
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, primitiveName), SYSBVM_X86_64_ARG2);
+        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RAX, offsetof(sysbvm_function_t, primitiveTableIndex), (int32_t)sysbvm_tuple_uint32_encode(jit->context, 0));
+        sysbvm_jit_moveRegisterToOperand(jit, resultOperand, SYSBVM_X86_RAX);
+        return;
+    }
+
     // Make the capture vector.
     sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
     sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG1, functionDefinitionOperand);
@@ -932,30 +1880,207 @@ SYSBVM_API void sysbvm_jit_jumpRelativeIfTrue(sysbvm_bytecodeJit_t *jit, int16_t
     sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
 }
 
-SYSBVM_API void sysbvm_jit_jumpRelativeIfFalse(sysbvm_bytecodeJit_t *jit, int16_t conditionOperand, size_t targetPC)
+SYSBVM_API void sysbvm_jit_jumpRelativeIfFalse(sysbvm_bytecodeJit_t *jit, int16_t conditionOperand, size_t targetPC)
+{
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, conditionOperand);
+    sysbvm_jit_x86_cmpRAXWithImmediate32(jit, SYSBVM_TRUE_TUPLE);
+
+    uint8_t instruction[] = {
+        // Jne
+        0x0F, 0x85, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    size_t relocationOffset = sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction) - 4;
+    sysbvm_bytecodeJitPCRelocation_t relocation = {
+        .offset = relocationOffset,
+        .targetPC = targetPC,
+        .addend = -4,
+    };
+    sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
+}
+
+
+typedef struct sysbvm_jit_x86_caseJumpEntry_s
+{
+    int64_t key;
+    size_t caseIndex;
+    size_t targetPC;
+} sysbvm_jit_x86_caseJumpEntry_t;
+
+static int sysbvm_jit_x86_compareCaseJumpEntries(const void *a, const void *b)
+{
+    const sysbvm_jit_x86_caseJumpEntry_t *left = (const sysbvm_jit_x86_caseJumpEntry_t*)a;
+    const sysbvm_jit_x86_caseJumpEntry_t *right = (const sysbvm_jit_x86_caseJumpEntry_t*)b;
+    if(left->key != right->key)
+        return left->key < right->key ? -1 : 1;
+    if(left->caseIndex != right->caseIndex)
+        return left->caseIndex < right->caseIndex ? -1 : 1;
+    return 0;
+}
+
+static void sysbvm_jit_x86_jumpConditionalToPC(sysbvm_bytecodeJit_t *jit, sysbvm_x86_condition_t condition, size_t targetPC)
+{
+    sysbvm_bytecodeJitPCRelocation_t relocation = {
+        .offset = sysbvm_jit_x86_jumpConditionalForward(jit, condition),
+        .targetPC = targetPC,
+        .addend = -4,
+    };
+    sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
+}
+
+static void sysbvm_jit_x86_cmpRAXWithImmediate64(sysbvm_bytecodeJit_t *jit, int64_t immediate)
+{
+    if(immediate == (int64_t)(int32_t)immediate)
+    {
+        sysbvm_jit_x86_cmpRAXWithImmediate32(jit, (int32_t)immediate);
+        return;
+    }
+
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uint64_t)immediate);
+    sysbvm_jit_x86_cmpRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+}
+
+static void sysbvm_jit_x86_caseJumpBinarySearch(sysbvm_bytecodeJit_t *jit, sysbvm_jit_x86_caseJumpEntry_t *entries, size_t entryCount, size_t defaultPC)
+{
+    if(entryCount <= SYSBVM_JIT_CASE_JUMP_LINEAR_SEARCH_COUNT)
+    {
+        for(size_t i = 0; i < entryCount; ++i)
+        {
+            sysbvm_jit_x86_cmpRAXWithImmediate64(jit, entries[i].key);
+            sysbvm_jit_x86_jumpConditionalToPC(jit, SYSBVM_X86_CONDITION_E, entries[i].targetPC);
+        }
+
+        sysbvm_jit_jumpRelative(jit, defaultPC);
+        return;
+    }
+
+    size_t middleIndex = entryCount / 2;
+    sysbvm_jit_x86_cmpRAXWithImmediate64(jit, entries[middleIndex].key);
+    sysbvm_jit_x86_jumpConditionalToPC(jit, SYSBVM_X86_CONDITION_E, entries[middleIndex].targetPC);
+    size_t greaterJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_G);
+    sysbvm_jit_x86_caseJumpBinarySearch(jit, entries, middleIndex, defaultPC);
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, greaterJump);
+    sysbvm_jit_x86_caseJumpBinarySearch(jit, entries + middleIndex + 1, entryCount - middleIndex - 1, defaultPC);
+}
+
+static void sysbvm_jit_x86_caseJumpTable(sysbvm_bytecodeJit_t *jit, sysbvm_jit_x86_caseJumpEntry_t *entries, size_t entryCount, size_t tableSize, size_t defaultPC)
+{
+    // RAX = (value - minKey) >> tagBits. Smaller values wrap around into the default range check.
+    int64_t minKey = entries[0].key;
+    if(minKey == (int64_t)(int32_t)minKey)
+    {
+        sysbvm_jit_x86_subImmediate32(jit, SYSBVM_X86_RAX, (int32_t)minKey);
+    }
+    else
+    {
+        sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_R11, (uint64_t)minKey);
+        sysbvm_jit_x86_sub64Register(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+    }
+    sysbvm_jit_x86_logicalShiftRightImmediate(jit, SYSBVM_X86_RAX, SYSBVM_TUPLE_TAG_BIT_COUNT);
+    sysbvm_jit_x86_cmpRAXWithImmediate32(jit, (int32_t)(tableSize - 1));
+    sysbvm_jit_x86_jumpConditionalToPC(jit, SYSBVM_X86_CONDITION_A, defaultPC);
+
+    uint8_t tableLoadAndJump[] = {
+        // lea R11, [RIP + table]
+        sysbvm_jit_x86_rex(true, true, false, false), 0x8D, sysbvm_jit_x86_modRM(5, SYSBVM_X86_R11, 0), 0x00, 0x00, 0x00, 0x00,
+
+        // movsxd RAX, dword [R11 + RAX*4]
+        sysbvm_jit_x86_rex(true, false, false, true), 0x63, sysbvm_jit_x86_modRM(4, SYSBVM_X86_RAX, 0), (SYSBVM_X86_R11 & SYSBVM_X86_REG_HALF_MASK) | (SYSBVM_X86_RAX << 3) | (2 << 6),
+
+        // add RAX, R11
+        sysbvm_jit_x86_rex(true, false, false, true), 0x03, sysbvm_jit_x86_modRMRegister(SYSBVM_X86_R11, SYSBVM_X86_RAX),
+
+        // notrack jmp RAX
+        0x3E, 0xFF, sysbvm_jit_x86_modRMRegister(SYSBVM_X86_RAX, 4),
+    };
+    size_t tableDisplacementOffset = sysbvm_bytecodeJit_addBytes(jit, sizeof(tableLoadAndJump), tableLoadAndJump) - sizeof(tableLoadAndJump) + 3;
+
+    // The table entries are the offsets of the case destinations relative to the table start.
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, tableDisplacementOffset);
+    size_t tableOffset = jit->instructions.size;
+    size_t nextEntryIndex = 0;
+    for(size_t i = 0; i < tableSize; ++i)
+    {
+        size_t targetPC = defaultPC;
+        if(nextEntryIndex < entryCount && (size_t)(((uint64_t)entries[nextEntryIndex].key - (uint64_t)minKey) >> SYSBVM_TUPLE_TAG_BIT_COUNT) == i)
+            targetPC = entries[nextEntryIndex++].targetPC;
+
+        uint8_t tableEntry[4] = {0};
+        size_t tableEntryOffset = sysbvm_bytecodeJit_addBytes(jit, sizeof(tableEntry), tableEntry) - sizeof(tableEntry);
+        sysbvm_bytecodeJitPCRelocation_t relocation = {
+            .offset = tableEntryOffset,
+            .targetPC = targetPC,
+            .addend = (intptr_t)tableEntryOffset - (intptr_t)tableOffset,
+        };
+        sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
+    }
+}
+
+static bool sysbvm_jit_x86_caseJumpWithImmediateKeys(sysbvm_bytecodeJit_t *jit, int16_t valueOperand, size_t caseCount, int16_t *caseKeyOperands, int16_t *caseLabelOperands, size_t pc, size_t defaultPC)
 {
-    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, conditionOperand);
-    sysbvm_jit_x86_cmpRAXWithImmediate32(jit, SYSBVM_TRUE_TUPLE);
+    // All of the keys must be literal immediates with the same tag.
+    sysbvm_tuple_t keyTag = SYSBVM_TUPLE_TAG_POINTER;
+    sysbvm_jit_x86_caseJumpEntry_t *entries = (sysbvm_jit_x86_caseJumpEntry_t*)calloc(caseCount, sizeof(sysbvm_jit_x86_caseJumpEntry_t));
+    for(size_t i = 0; i < caseCount; ++i)
+    {
+        sysbvm_tuple_t key;
+        if(!sysbvm_bytecodeJit_getLiteralValueForOperand(jit, caseKeyOperands[i], &key) || !sysbvm_tuple_isIdentityComparableImmediate(key) ||
+            (i > 0 && (key & SYSBVM_TUPLE_TAG_BIT_MASK) != keyTag))
+        {
+            free(entries);
+            return false;
+        }
 
-    uint8_t instruction[] = {
-        // Jne
-        0x0F, 0x85, 0x00, 0x00, 0x00, 0x00,
-    };
+        keyTag = key & SYSBVM_TUPLE_TAG_BIT_MASK;
+        entries[i].key = (int64_t)key;
+        entries[i].caseIndex = i;
+        entries[i].targetPC = pc + caseLabelOperands[i];
+    }
 
-    size_t relocationOffset = sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction) - 4;
-    sysbvm_bytecodeJitPCRelocation_t relocation = {
-        .offset = relocationOffset,
-        .targetPC = targetPC,
-        .addend = -4,
-    };
-    sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
-}
+    // Sort the keys, keeping only the first case of the repeated keys.
+    qsort(entries, caseCount, sizeof(sysbvm_jit_x86_caseJumpEntry_t), sysbvm_jit_x86_compareCaseJumpEntries);
+    size_t entryCount = 0;
+    for(size_t i = 0; i < caseCount; ++i)
+    {
+        if(entryCount == 0 || entries[entryCount - 1].key != entries[i].key)
+            entries[entryCount++] = entries[i];
+    }
 
+    // Values with a different tag need the generic equality.
+    sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, valueOperand);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_RAX);
+    sysbvm_jit_x86_andImmediate8(jit, SYSBVM_X86_R10, SYSBVM_TUPLE_TAG_BIT_MASK);
+    sysbvm_jit_x86_cmpImmediate8(jit, SYSBVM_X86_R10, (int8_t)keyTag);
+    size_t genericCaseJump = sysbvm_jit_x86_jumpConditionalForward(jit, SYSBVM_X86_CONDITION_NE);
+
+    // Same tag immediates are equal only when they are identical.
+    uint64_t keyRange = ((uint64_t)entries[entryCount - 1].key - (uint64_t)entries[0].key) >> SYSBVM_TUPLE_TAG_BIT_COUNT;
+    if(entryCount >= SYSBVM_JIT_CASE_JUMP_TABLE_MIN_COUNT && keyRange < entryCount * SYSBVM_JIT_CASE_JUMP_TABLE_MAX_SPARSENESS)
+        sysbvm_jit_x86_caseJumpTable(jit, entries, entryCount, (size_t)keyRange + 1, defaultPC);
+    else
+        sysbvm_jit_x86_caseJumpBinarySearch(jit, entries, entryCount, defaultPC);
+
+    free(entries);
+    sysbvm_jit_x86_patchForwardJumpToHere(jit, genericCaseJump);
+    return true;
+}
 
 SYSBVM_API void sysbvm_jit_caseJump(sysbvm_bytecodeJit_t *jit, int16_t valueOperand, size_t caseCount, int16_t *caseKeyOperands, int16_t *caseLabelOperands, int16_t defaultLabelOperand, size_t pc)
 {
+    size_t defaultPC = pc + defaultLabelOperand;
+    bool hasImmediateKeys = caseCount > 0 && sysbvm_jit_x86_caseJumpWithImmediateKeys(jit, valueOperand, caseCount, caseKeyOperands, caseLabelOperands, pc, defaultPC);
+
     for(size_t i = 0; i < caseCount; ++i)
     {
+        // Identical values are always equal.
+        if(!hasImmediateKeys)
+        {
+            sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_RAX, valueOperand);
+            sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_R11, caseKeyOperands[i]);
+            sysbvm_jit_x86_cmpRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_R11);
+            sysbvm_jit_x86_jumpConditionalToPC(jit, SYSBVM_X86_CONDITION_E, pc + caseLabelOperands[i]);
+        }
+
         sysbvm_jit_x86_jitLoadContextInRegister(jit, SYSBVM_X86_64_ARG0);
         sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG1, valueOperand);
         sysbvm_jit_moveOperandToRegister(jit, SYSBVM_X86_64_ARG2, caseKeyOperands[i]);
@@ -964,21 +2089,13 @@ SYSBVM_API void sysbvm_jit_caseJump(sysbvm_bytecodeJit_t *jit, int16_t valueOper
         uint8_t instruction[] = {
             // test AL, AL
             0x84, sysbvm_jit_x86_modRMRegister(SYSBVM_X86_RAX, SYSBVM_X86_RAX),
-
-            // jnz
-            0x0F, 0x85, 0x00, 0x00, 0x00, 0x00,
         };
 
-        size_t relocationOffset = sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction) - 4;
-        sysbvm_bytecodeJitPCRelocation_t relocation = {
-            .offset = relocationOffset,
-            .targetPC = pc + caseLabelOperands[i],
-            .addend = -4,
-        };
-        sysbvm_bytecodeJit_addPCRelocation(jit, relocation);
+        sysbvm_bytecodeJit_addBytes(jit, sizeof(instruction), instruction);
+        sysbvm_jit_x86_jumpConditionalToPC(jit, SYSBVM_X86_CONDITION_NE, pc + caseLabelOperands[i]);
     }
 
-    sysbvm_jit_jumpRelative(jit, pc + defaultLabelOperand);
+    sysbvm_jit_jumpRelative(jit, defaultPC);
 }
 
 static void sysbvm_jit_cfi_beginPrologue(sysbvm_bytecodeJit_t *jit)
@@ -998,10 +2115,19 @@ static void sysbvm_jit_cfi_beginPrologue(sysbvm_bytecodeJit_t *jit)
     sysbvm_dwarf_cfi_beginFDE(&jit->dwarfEhBuilder, jit->instructions.size);
 }
 
+#ifdef _WIN32
+// The secondary prologues emit the same instructions as the regular one, so they share its unwind codes.
+static bool sysbvm_jit_cfi_recordsUnwindCodes(sysbvm_bytecodeJit_t *jit)
+{
+    return jit->secondaryPrologueCount == 0;
+}
+#endif
+
 static void sysbvm_jit_cfi_pushRBP(sysbvm_bytecodeJit_t *jit)
 {
 #ifdef _WIN32
-    sysbvm_bytecodeJit_uwop_pushNonVol(jit, 5);
+    if(sysbvm_jit_cfi_recordsUnwindCodes(jit))
+        sysbvm_bytecodeJit_uwop_pushNonVol(jit, 5);
 #endif
     sysbvm_dwarf_cfi_setPC(&jit->dwarfEhBuilder, jit->instructions.size);
     sysbvm_dwarf_cfi_pushRegister(&jit->dwarfEhBuilder, sizeof(uintptr_t) == 8 ? DW_X64_REG_RBP : DW_X86_REG_EBP);
@@ -1011,8 +2137,11 @@ static void sysbvm_jit_cfi_storeStackInFramePointer(sysbvm_bytecodeJit_t *jit, i
 {
 #ifdef _WIN32
     SYSBVM_ASSERT((offset % 16) == 0);
-    jit->cfiFrameOffset = offset / 16;
-    sysbvm_bytecodeJit_uwop_setFPReg(jit);
+    if(sysbvm_jit_cfi_recordsUnwindCodes(jit))
+    {
+        jit->cfiFrameOffset = offset / 16;
+        sysbvm_bytecodeJit_uwop_setFPReg(jit);
+    }
 #endif
     sysbvm_dwarf_cfi_setPC(&jit->dwarfEhBuilder, jit->instructions.size);
     sysbvm_dwarf_cfi_saveFramePointerInRegister(&jit->dwarfEhBuilder, sizeof(uintptr_t) == 8 ? DW_X64_REG_RBP : DW_X86_REG_EBP, offset);
@@ -1022,7 +2151,8 @@ static void sysbvm_jit_cfi_subtract(sysbvm_bytecodeJit_t *jit, size_t subtractio
 {
     if(!subtractionAmount) return;
 #ifdef _WIN32
-    sysbvm_bytecodeJit_uwop_alloc(jit, subtractionAmount);
+    if(sysbvm_jit_cfi_recordsUnwindCodes(jit))
+        sysbvm_bytecodeJit_uwop_alloc(jit, subtractionAmount);
 #endif
     sysbvm_dwarf_cfi_stackSizeAdvance(&jit->dwarfEhBuilder, jit->instructions.size, subtractionAmount);
 }
@@ -1033,6 +2163,161 @@ static void sysbvm_jit_cfi_endPrologue(sysbvm_bytecodeJit_t *jit)
     sysbvm_dwarf_cfi_endPrologue(&jit->dwarfEhBuilder);
 }
 
+static void sysbvm_jit_cfi_pushCalleeSavedRegister(sysbvm_bytecodeJit_t *jit, const sysbvm_x86_calleeSavedRegister_t *calleeSavedRegister)
+{
+#ifdef _WIN32
+    if(sysbvm_jit_cfi_recordsUnwindCodes(jit))
+        sysbvm_bytecodeJit_uwop_pushNonVol(jit, (uint8_t)calleeSavedRegister->reg);
+#endif
+    sysbvm_dwarf_cfi_setPC(&jit->dwarfEhBuilder, jit->instructions.size);
+    sysbvm_dwarf_cfi_pushRegister(&jit->dwarfEhBuilder, calleeSavedRegister->dwarfRegister);
+}
+
+static void sysbvm_jit_cfi_beginSecondaryPrologue(sysbvm_bytecodeJit_t *jit)
+{
+    SYSBVM_ASSERT(jit->secondaryPrologueCount < sizeof(jit->secondaryPrologueOffsets) / sizeof(jit->secondaryPrologueOffsets[0]));
+    jit->secondaryPrologueOffsets[jit->secondaryPrologueCount++] = jit->instructions.size;
+    sysbvm_dwarf_cfi_beginSecondaryPrologue(&jit->dwarfEhBuilder, jit->instructions.size);
+
+    // The registers saved by the body still hold the caller values until they are pushed again.
+    sysbvm_dwarf_cfi_restoreRegister(&jit->dwarfEhBuilder, sizeof(uintptr_t) == 8 ? DW_X64_REG_RBP : DW_X86_REG_EBP);
+    for(size_t i = 0; i < jit->cachedLocalCount; ++i)
+        sysbvm_dwarf_cfi_restoreRegister(&jit->dwarfEhBuilder, sysbvm_jit_x86_cachedLocalRegisters[i].dwarfRegister);
+}
+
+static void sysbvm_jit_cfi_endSecondaryPrologue(sysbvm_bytecodeJit_t *jit)
+{
+    sysbvm_dwarf_cfi_endSecondaryPrologue(&jit->dwarfEhBuilder, jit->instructions.size);
+}
+
+static void sysbvm_jit_pushCachedLocalRegisters(sysbvm_bytecodeJit_t *jit, bool emitUnwindInfo)
+{
+    for(size_t i = 0; i < jit->cachedLocalCount; ++i)
+    {
+        sysbvm_jit_x86_pushRegister(jit, sysbvm_jit_x86_cachedLocalRegisters[i].reg);
+        if(emitUnwindInfo)
+            sysbvm_jit_cfi_pushCalleeSavedRegister(jit, sysbvm_jit_x86_cachedLocalRegisters + i);
+    }
+}
+
+static void sysbvm_jit_copyArgumentsIntoFrame(sysbvm_bytecodeJit_t *jit)
+{
+    for(size_t i = 0; i < jit->argumentCount; ++i)
+    {
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_64_ARG3, (int32_t)(i*sizeof(void*)));
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->inlineArgumentVectorOffset + (int32_t)(i*sizeof(void*)), SYSBVM_X86_RAX);
+    }
+}
+
+static void sysbvm_jit_buildStackFrameRecord(sysbvm_bytecodeJit_t *jit, bool isOsrEntry)
+{
+    // The register arguments entry joins here, after storing its arguments in the frame.
+    if(jit->hasRegisterArgumentsEntryPoint)
+    {
+        sysbvm_jit_copyArgumentsIntoFrame(jit);
+        if(!isOsrEntry)
+            jit->registerArgumentsEntryJoinOffset = jit->instructions.size;
+    }
+
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit,
+        SYSBVM_X86_RBP, jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, previous),
+        0);
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit,
+        SYSBVM_X86_RBP, jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, type),
+        SYSBVM_STACK_FRAME_RECORD_TYPE_BYTECODE_JIT_FUNCTION_ACTIVATION);
+
+    jit->pcOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, pc);
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->pcOffset, 0);
+
+    jit->contextPointerOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, context);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->contextPointerOffset, SYSBVM_X86_64_ARG0);
+
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_RAX, (uintptr_t)jit->literalVectorGCRoot); // Pointer to GC root with the literal vector.
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, 0, SYSBVM_X86_RAX);
+    jit->literalVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, literalVector);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->literalVectorOffset, SYSBVM_X86_RAX);
+
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_64_ARG1, offsetof(sysbvm_function_t, captureVector));
+    jit->captureVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, captureVector);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->captureVectorOffset, SYSBVM_X86_RAX);
+
+    size_t functionOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, function);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)functionOffset, SYSBVM_X86_64_ARG1);
+
+    // The function may get a new definition while this code runs, so the frame keeps its own bytecode (and this code) alive.
+    sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_RAX, (uintptr_t)jit->functionBytecodeGCRoot);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, 0, SYSBVM_X86_RAX);
+    size_t functionBytecodeOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, functionBytecode);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)functionBytecodeOffset, SYSBVM_X86_RAX);
+
+    size_t argumentCountOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, argumentCount);
+    sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)argumentCountOffset, SYSBVM_X86_64_ARG2);
+
+    jit->callArgumentVectorSizeOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, callArgumentVectorSize);
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorSizeOffset, 0);
+
+    jit->callArgumentVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, callArgumentVector);
+    // This is not needed to be cleared.
+
+    jit->argumentVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, arguments);
+    if(jit->hasRegisterArgumentsEntryPoint)
+    {
+        sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RBP, jit->inlineArgumentVectorOffset);
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->argumentVectorOffset, SYSBVM_X86_RAX);
+    }
+    else
+    {
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->argumentVectorOffset, SYSBVM_X86_64_ARG3);
+    }
+
+    size_t inlineLocalVectorSizeOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, inlineLocalVectorSize);
+    sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)inlineLocalVectorSizeOffset, (int32_t)jit->localVectorSize);
+
+    jit->localVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, inlineLocalVector);
+
+    if(isOsrEntry)
+    {
+        // Copy the locals from the interpreter activation record, and keep the resume address in the call argument vector.
+        for(size_t i = 0; i < jit->localVectorSize; ++i)
+        {
+            size_t localOffset = jit->localVectorOffset + i*sizeof(void*);
+            sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_R10, (int32_t)(i*sizeof(void*)));
+            sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)localOffset, SYSBVM_X86_RAX);
+        }
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorOffset, SYSBVM_X86_R11);
+
+        for(size_t i = 0; i < jit->cachedLocalCount; ++i)
+        {
+            size_t localOffset = jit->localVectorOffset + jit->cachedLocalIndices[i]*sizeof(void*);
+            sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, sysbvm_jit_x86_cachedLocalRegisters[i].reg, SYSBVM_X86_RBP, (int32_t)localOffset);
+        }
+    }
+    else if(jit->localVectorSize > 0)
+    {
+        // Initialize the locals
+        sysbvm_jit_x86_xorRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX);
+        for(size_t i = 0; i < jit->localVectorSize; ++i)
+        {
+            size_t localOffset = jit->localVectorOffset + i*sizeof(void*);
+            sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)localOffset, SYSBVM_X86_RAX);
+        }
+
+        for(size_t i = 0; i < jit->cachedLocalCount; ++i)
+            sysbvm_jit_x86_mov64Register(jit, sysbvm_jit_x86_cachedLocalRegisters[i].reg, SYSBVM_X86_RAX);
+    }
+
+    // Connect with the stack unwinder.
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_64_ARG0, SYSBVM_X86_RBP, jit->stackFrameRecordOffset);
+    sysbvm_jit_x86_call(jit, &sysbvm_stackFrame_pushRecord);
+
+    // Resume at the loop header.
+    if(isOsrEntry)
+    {
+        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_RBP, jit->callArgumentVectorOffset);
+        sysbvm_jit_x86_jmpRegister(jit, SYSBVM_X86_RAX);
+    }
+}
+
 SYSBVM_API void sysbvm_jit_prologue(sysbvm_bytecodeJit_t *jit)
 {
     sysbvm_jit_cfi_beginPrologue(jit);
@@ -1044,13 +2329,18 @@ SYSBVM_API void sysbvm_jit_prologue(sysbvm_bytecodeJit_t *jit)
     sysbvm_jit_x86_pushRegister(jit, SYSBVM_X86_RBP);
     sysbvm_jit_cfi_pushRBP(jit);
 
-    // Allocate the stack storage.
-    size_t requiredStackSize = jit->localVectorSize * sizeof(intptr_t)
+    // Allocate the stack storage. The saved registers are pushed between the frame pointer and it.
+    jit->hasRegisterArgumentsEntryPoint = jit->argumentCount <= SYSBVM_JIT_REGISTER_ARGUMENT_COUNT;
+    size_t inlineArgumentCount = jit->hasRegisterArgumentsEntryPoint ? jit->argumentCount : 0;
+    size_t savedRegistersSize = jit->cachedLocalCount * sizeof(intptr_t);
+    size_t requiredStackSize = (jit->localVectorSize + inlineArgumentCount) * sizeof(intptr_t)
         + (sizeof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t) - sizeof(intptr_t));
-    jit->stackFrameSize = (requiredStackSize + 15) & (-16);
+    jit->stackFrameSize = (int32_t)(((requiredStackSize + savedRegistersSize + 15) & (-16)) - savedRegistersSize);
     jit->stackFrameRecordOffset = 0;
 
 #ifdef _WIN32
+    sysbvm_jit_pushCachedLocalRegisters(jit, true);
+
     jit->stackCallReservationSize = SYSBVM_X86_64_CALL_SHADOW_SPACE + 32;
     sysbvm_jit_x86_subImmediate32(jit, SYSBVM_X86_RSP, jit->stackFrameSize + jit->stackCallReservationSize);
     sysbvm_jit_cfi_subtract(jit, jit->stackFrameSize + jit->stackCallReservationSize);
@@ -1064,72 +2354,75 @@ SYSBVM_API void sysbvm_jit_prologue(sysbvm_bytecodeJit_t *jit)
     sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_RBP, SYSBVM_X86_RSP);
     sysbvm_jit_cfi_storeStackInFramePointer(jit, 0);
 
+    sysbvm_jit_pushCachedLocalRegisters(jit, true);
+
     sysbvm_jit_x86_subImmediate32(jit, SYSBVM_X86_RSP, jit->stackFrameSize + jit->stackCallReservationSize);
     sysbvm_jit_cfi_subtract(jit, jit->stackFrameSize + jit->stackCallReservationSize);
-    jit->stackFrameRecordOffset = -jit->stackFrameSize;
+    jit->stackFrameRecordOffset = -(int32_t)savedRegistersSize - jit->stackFrameSize;
 #endif
 
-    sysbvm_jit_cfi_endPrologue(jit);
-
-    // Build the stack frame record.
-    {
-        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit,
-            SYSBVM_X86_RBP, jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, previous),
-            0);
-        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit,
-            SYSBVM_X86_RBP, jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, type),
-            SYSBVM_STACK_FRAME_RECORD_TYPE_BYTECODE_JIT_FUNCTION_ACTIVATION);
-
-        jit->pcOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, pc);
-        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->pcOffset, 0);
+    // The in-frame arguments follow the locals.
+    jit->inlineArgumentVectorOffset = jit->stackFrameRecordOffset + (int32_t)offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, inlineLocalVector)
+        + (int32_t)(jit->localVectorSize * sizeof(intptr_t));
 
-        jit->contextPointerOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, context);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->contextPointerOffset, SYSBVM_X86_64_ARG0);
-
-        sysbvm_jit_x86_mov64Absolute(jit, SYSBVM_X86_RAX, (uintptr_t)jit->literalVectorGCRoot); // Pointer to GC root with the literal vector.
-        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, 0, SYSBVM_X86_RAX);
-        jit->literalVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, literalVector);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->literalVectorOffset, SYSBVM_X86_RAX);
-
-        sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_RAX, SYSBVM_X86_64_ARG1, offsetof(sysbvm_function_t, captureVector));
-        jit->captureVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, captureVector);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->captureVectorOffset, SYSBVM_X86_RAX);
+    sysbvm_jit_cfi_endPrologue(jit);
 
-        size_t functionOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, function);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)functionOffset, SYSBVM_X86_64_ARG1);
+    sysbvm_jit_buildStackFrameRecord(jit, false);
+}
 
-        size_t argumentCountOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, argumentCount);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)argumentCountOffset, SYSBVM_X86_64_ARG2);
+static void sysbvm_jit_secondaryEntryFrameSetup(sysbvm_bytecodeJit_t *jit)
+{
+    // Same frame layout and frame description as the regular prologue.
+    sysbvm_jit_cfi_beginSecondaryPrologue(jit);
+#ifndef _WIN32
+    sysbvm_jit_x86_endbr64(jit);
+#endif
+    sysbvm_jit_x86_pushRegister(jit, SYSBVM_X86_RBP);
+    sysbvm_jit_cfi_pushRBP(jit);
 
-        jit->callArgumentVectorSizeOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, callArgumentVectorSize);
-        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->callArgumentVectorSizeOffset, 0);
+#ifdef _WIN32
+    sysbvm_jit_pushCachedLocalRegisters(jit, true);
+    sysbvm_jit_x86_subImmediate32(jit, SYSBVM_X86_RSP, jit->stackFrameSize + jit->stackCallReservationSize);
+    sysbvm_jit_cfi_subtract(jit, jit->stackFrameSize + jit->stackCallReservationSize);
+    sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_RBP, SYSBVM_X86_RSP, jit->stackCallReservationSize);
+    sysbvm_jit_cfi_storeStackInFramePointer(jit, jit->stackCallReservationSize);
+#else
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_RBP, SYSBVM_X86_RSP);
+    sysbvm_jit_cfi_storeStackInFramePointer(jit, 0);
+    sysbvm_jit_pushCachedLocalRegisters(jit, true);
+    sysbvm_jit_x86_subImmediate32(jit, SYSBVM_X86_RSP, jit->stackFrameSize + jit->stackCallReservationSize);
+    sysbvm_jit_cfi_subtract(jit, jit->stackFrameSize + jit->stackCallReservationSize);
+#endif
+    sysbvm_jit_cfi_endSecondaryPrologue(jit);
+}
 
-        jit->callArgumentVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, callArgumentVector);
-        // This is not needed to be cleared.
+SYSBVM_API void sysbvm_jit_osrEntryPrologue(sysbvm_bytecodeJit_t *jit)
+{
+    sysbvm_jit_secondaryEntryFrameSetup(jit);
 
-        jit->argumentVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, arguments);
-        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->argumentVectorOffset, SYSBVM_X86_64_ARG3);
+#ifdef _WIN32
+    // The extra OSR arguments are passed in the stack.
+    int32_t savedRegistersSize = (int32_t)(jit->cachedLocalCount * sizeof(intptr_t));
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R10, SYSBVM_X86_RBP, jit->stackFrameSize + savedRegistersSize + 16 + SYSBVM_X86_64_CALL_SHADOW_SPACE);
+    sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, SYSBVM_X86_R11, SYSBVM_X86_RBP, jit->stackFrameSize + savedRegistersSize + 24 + SYSBVM_X86_64_CALL_SHADOW_SPACE);
+#else
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R10, SYSBVM_X86_SYSV_ARG4);
+    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_R11, SYSBVM_X86_SYSV_ARG5);
+#endif
 
-        size_t inlineLocalVectorSizeOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, inlineLocalVectorSize);
-        sysbvm_jit_x86_movS32IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)inlineLocalVectorSizeOffset, (int32_t)jit->localVectorSize);
+    sysbvm_jit_buildStackFrameRecord(jit, true);
+}
 
-        jit->localVectorOffset = jit->stackFrameRecordOffset + offsetof(sysbvm_stackFrameBytecodeFunctionJitActivationRecord_t, inlineLocalVector);
+SYSBVM_API void sysbvm_jit_registerArgumentsEntryPrologue(sysbvm_bytecodeJit_t *jit)
+{
+    //(sysbvm_context_t *context, sysbvm_tuple_t function, sysbvm_tuple_t argument0, ...)
+    sysbvm_jit_secondaryEntryFrameSetup(jit);
 
-        // Initialize the locals
-        if(jit->localVectorSize > 0)
-        {
-            sysbvm_jit_x86_xorRegister(jit, SYSBVM_X86_RAX, SYSBVM_X86_RAX);
-            for(size_t i = 0; i < jit->localVectorSize; ++i)
-            {
-                size_t localOffset = jit->localVectorOffset + i*sizeof(void*);
-                sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, (int32_t)localOffset, SYSBVM_X86_RAX);
-            }
-        }
+    for(size_t i = 0; i < jit->argumentCount; ++i)
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, jit->inlineArgumentVectorOffset + (int32_t)(i*sizeof(void*)), sysbvm_jit_x86_argumentRegisters[i]);
+    sysbvm_jit_x86_movImmediate32(jit, SYSBVM_X86_64_ARG2, (int32_t)jit->argumentCount);
 
-        // Connect with the stack unwinder.
-        sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_64_ARG0, SYSBVM_X86_RBP, jit->stackFrameRecordOffset);
-        sysbvm_jit_x86_call(jit, &sysbvm_stackFrame_pushRecord);
-    }
+    sysbvm_jit_x86_jumpBackwardTo(jit, jit->registerArgumentsEntryJoinOffset);
 }
 
 static void sysbvm_jit_epilogue(sysbvm_bytecodeJit_t *jit)
@@ -1137,12 +2430,35 @@ static void sysbvm_jit_epilogue(sysbvm_bytecodeJit_t *jit)
 #ifdef _WIN32
     sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_RSP, SYSBVM_X86_RBP, jit->stackFrameSize);
 #else
-    sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_RSP, SYSBVM_X86_RBP);
+    if(jit->cachedLocalCount > 0)
+        sysbvm_jit_x86_leaRegisterWithOffset(jit, SYSBVM_X86_RSP, SYSBVM_X86_RBP, -(int32_t)(jit->cachedLocalCount * sizeof(intptr_t)));
+    else
+        sysbvm_jit_x86_mov64Register(jit, SYSBVM_X86_RSP, SYSBVM_X86_RBP);
 #endif
+    for(size_t i = jit->cachedLocalCount; i > 0; --i)
+        sysbvm_jit_x86_popRegister(jit, sysbvm_jit_x86_cachedLocalRegisters[i - 1].reg);
     sysbvm_jit_x86_popRegister(jit, SYSBVM_X86_RBP);
     sysbvm_jit_x86_ret(jit);
 }
 
+static bool sysbvm_jit_getCachedLocalRegister(sysbvm_bytecodeJit_t *jit, int16_t operand, sysbvm_x86_register_t *outRegister)
+{
+    if((operand & SYSBVM_OPERAND_VECTOR_BITMASK) != SYSBVM_OPERAND_VECTOR_LOCAL)
+        return false;
+
+    int16_t vectorIndex = operand >> SYSBVM_OPERAND_VECTOR_BITS;
+    for(size_t i = 0; i < jit->cachedLocalCount; ++i)
+    {
+        if(jit->cachedLocalIndices[i] == vectorIndex)
+        {
+            *outRegister = sysbvm_jit_x86_cachedLocalRegisters[i].reg;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 static void sysbvm_jit_moveRegisterToOperand(sysbvm_bytecodeJit_t *jit, int16_t operand, sysbvm_x86_register_t reg)
 {
     sysbvm_operandVectorName_t vectorType = (sysbvm_operandVectorName_t) (operand & SYSBVM_OPERAND_VECTOR_BITMASK);
@@ -1150,6 +2466,11 @@ static void sysbvm_jit_moveRegisterToOperand(sysbvm_bytecodeJit_t *jit, int16_t
     if(vectorIndex < 0)
         return;
 
+    // The cached locals are written through, so that the frame always has the values seen by the GC and the debugger.
+    sysbvm_x86_register_t cachedRegister;
+    if(sysbvm_jit_getCachedLocalRegister(jit, operand, &cachedRegister))
+        sysbvm_jit_x86_mov64Register(jit, cachedRegister, reg);
+
     int32_t vectorOffset = vectorIndex * sizeof(void*);
     switch(vectorType)
     {
@@ -1172,10 +2493,22 @@ static void sysbvm_jit_moveOperandToRegister(sysbvm_bytecodeJit_t *jit, sysbvm_x
         return;
     }
 
+    sysbvm_x86_register_t cachedRegister;
+    if(sysbvm_jit_getCachedLocalRegister(jit, operand, &cachedRegister))
+    {
+        sysbvm_jit_x86_mov64Register(jit, reg, cachedRegister);
+        return;
+    }
+
     int32_t vectorOffset = (int32_t)vectorIndex * sizeof(void*);
     switch(vectorType)
     {
     case SYSBVM_OPERAND_VECTOR_ARGUMENTS:
+        if(jit->hasRegisterArgumentsEntryPoint)
+        {
+            sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, reg, SYSBVM_X86_RBP, jit->inlineArgumentVectorOffset + vectorOffset);
+            break;
+        }
         sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, reg, SYSBVM_X86_RBP, jit->argumentVectorOffset);
         sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, reg, reg, vectorOffset);
         break;
@@ -1205,11 +2538,23 @@ static void sysbvm_jit_moveOperandToCallArgumentVector(sysbvm_bytecodeJit_t *jit
         return;
     }
 
+    sysbvm_x86_register_t cachedRegister;
+    if(sysbvm_jit_getCachedLocalRegister(jit, operand, &cachedRegister))
+    {
+        sysbvm_jit_x86_mov64IntoMemoryWithOffset(jit, SYSBVM_X86_RBP, callArgumentVectorOffset, cachedRegister);
+        return;
+    }
+
     int32_t vectorOffset = vectorIndex * sizeof(void*);
     sysbvm_x86_register_t scratchRegister = SYSBVM_X86_RAX;
     switch(vectorType)
     {
     case SYSBVM_OPERAND_VECTOR_ARGUMENTS:
+        if(jit->hasRegisterArgumentsEntryPoint)
+        {
+            sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, scratchRegister, SYSBVM_X86_RBP, jit->inlineArgumentVectorOffset + vectorOffset);
+            break;
+        }
         sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, scratchRegister, SYSBVM_X86_RBP, jit->argumentVectorOffset);
         sysbvm_jit_x86_mov64FromMemoryWithOffset(jit, scratchRegister, scratchRegister, vectorOffset);
         break;
@@ -1256,10 +2601,15 @@ SYSBVM_API void sysbvm_jit_storePC(sysbvm_bytecodeJit_t *jit, uint16_t pc)
 static void sysbvm_jit_emitUnwindInfo(sysbvm_bytecodeJit_t *jit)
 {
 #ifdef _WIN32
-    RUNTIME_FUNCTION runtimeFunction = {0};
-    runtimeFunction.BeginAddress = 0;
-    runtimeFunction.EndAddress = (DWORD)jit->instructions.size;
-    sysbvm_bytecodeJit_addUnwindInfoBytes(jit, sizeof(runtimeFunction), (uint8_t*)&runtimeFunction);
+    // The secondary entry points start new function entries, which share the unwind information of the regular prologue.
+    size_t runtimeFunctionCount = 1 + jit->secondaryPrologueCount;
+    for(size_t i = 0; i < runtimeFunctionCount; ++i)
+    {
+        RUNTIME_FUNCTION runtimeFunction = {0};
+        runtimeFunction.BeginAddress = (DWORD)(i > 0 ? jit->secondaryPrologueOffsets[i - 1] : 0);
+        runtimeFunction.EndAddress = (DWORD)(i + 1 < runtimeFunctionCount ? jit->secondaryPrologueOffsets[i] : jit->instructions.size);
+        sysbvm_bytecodeJit_addUnwindInfoBytes(jit, sizeof(runtimeFunction), (uint8_t*)&runtimeFunction);
+    }
 
     // Unwind_info
     size_t codeCount = jit->unwindInfoBytecode.size/2;
@@ -1321,18 +2671,17 @@ static size_t sysbvm_jit_emitObjectFileCString(sysbvm_bytecodeJit_t *jit, const
     return result;
 }
 
-static size_t sysbvm_jit_emitObjectFileSourceFileName(sysbvm_bytecodeJit_t *jit)
+static bool sysbvm_jit_emitSourceFileNameInto(sysbvm_dynarray_t *buffer, sysbvm_tuple_t sourcePositionTuple)
 {
-    if(!sysbvm_tuple_isNonNullPointer(jit->sourcePosition))
-        return 0;
+    if(!sysbvm_tuple_isNonNullPointer(sourcePositionTuple))
+        return false;
 
-    sysbvm_sourcePosition_t *sourcePosition = (sysbvm_sourcePosition_t*)jit->sourcePosition;
+    sysbvm_sourcePosition_t *sourcePosition = (sysbvm_sourcePosition_t*)sourcePositionTuple;
     if(!sysbvm_tuple_isNonNullPointer(sourcePosition->sourceCode))
-        return 0;
+        return false;
 
     sysbvm_sourceCode_t *sourceCode = (sysbvm_sourceCode_t*)sourcePosition->sourceCode;
     
-    size_t nameOffset = jit->objectFileContent.size;
     bool hasEmittedName = false;
 
     if(sourceCode->directory)
@@ -1340,11 +2689,11 @@ static size_t sysbvm_jit_emitObjectFileSourceFileName(sysbvm_bytecodeJit_t *jit)
         size_t byteSize = sysbvm_tuple_getSizeInBytes(sourceCode->directory);
         if(byteSize > 0)
         {
-            sysbvm_dynarray_addAll(&jit->objectFileContent, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(sourceCode->directory)->bytes);
+            sysbvm_dynarray_addAll(buffer, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(sourceCode->directory)->bytes);
             hasEmittedName = true;
 
             char slash = '/';
-            sysbvm_dynarray_add(&jit->objectFileContent, &slash);
+            sysbvm_dynarray_add(buffer, &slash);
         }
     }
 
@@ -1353,47 +2702,52 @@ static size_t sysbvm_jit_emitObjectFileSourceFileName(sysbvm_bytecodeJit_t *jit)
         size_t byteSize = sysbvm_tuple_getSizeInBytes(sourceCode->name);
         if(byteSize > 0)
         {
-            sysbvm_dynarray_addAll(&jit->objectFileContent, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(sourceCode->name)->bytes);
+            sysbvm_dynarray_addAll(buffer, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(sourceCode->name)->bytes);
             hasEmittedName = true;
         }
     }
 
     if(!hasEmittedName)
-        return 0;
+        return false;
 
     char nullTerminator = 0;
-    sysbvm_dynarray_add(&jit->objectFileContent, &nullTerminator);
+    sysbvm_dynarray_add(buffer, &nullTerminator);
+    return true;
+}
+
+static size_t sysbvm_jit_emitObjectFileSourceFileName(sysbvm_bytecodeJit_t *jit)
+{
+    size_t nameOffset = jit->objectFileContent.size;
+    if(!sysbvm_jit_emitSourceFileNameInto(&jit->objectFileContent, jit->sourcePosition))
+        return 0;
     return nameOffset;
 }
 
-static bool sysbvm_jit_emitObjectFileProgramEntityRecursiveName(sysbvm_bytecodeJit_t *jit, sysbvm_programEntity_t *programEntity)
+static bool sysbvm_jit_emitProgramEntityRecursiveName(sysbvm_dynarray_t *buffer, sysbvm_programEntity_t *programEntity)
 {
     if(!programEntity)
         return false;
 
-    bool hasEmittedName = sysbvm_jit_emitObjectFileProgramEntityRecursiveName(jit, (sysbvm_programEntity_t*)programEntity->owner);
+    bool hasEmittedName = sysbvm_jit_emitProgramEntityRecursiveName(buffer, (sysbvm_programEntity_t*)programEntity->owner);
     if(sysbvm_tuple_isBytes(programEntity->name))
     {
         if(hasEmittedName)
         {
             char dot = '.';
-            sysbvm_dynarray_add(&jit->objectFileContent, &dot);
+            sysbvm_dynarray_add(buffer, &dot);
         }
         size_t byteSize = sysbvm_tuple_getSizeInBytes(programEntity->name);
-        sysbvm_dynarray_addAll(&jit->objectFileContent, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(programEntity->name)->bytes);
+        sysbvm_dynarray_addAll(buffer, byteSize, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(programEntity->name)->bytes);
         hasEmittedName = hasEmittedName || byteSize > 0;
     }
 
     return hasEmittedName;
 }
 
-static size_t sysbvm_jit_emitObjectFileJittedFunctionName(sysbvm_bytecodeJit_t *jit)
+static void sysbvm_jit_emitJittedFunctionNameInto(sysbvm_bytecodeJit_t *jit, sysbvm_dynarray_t *buffer)
 {
-    size_t nameOffset = jit->objectFileContent.size;
-    jit->objectFileContentJittedFunctionNameOffset = nameOffset;
-
     // Emit the program entity name;
-    bool hasEmittedName = sysbvm_jit_emitObjectFileProgramEntityRecursiveName(jit, (sysbvm_programEntity_t*)jit->compiledProgramEntity);
+    bool hasEmittedName = sysbvm_jit_emitProgramEntityRecursiveName(buffer, (sysbvm_programEntity_t*)jit->compiledProgramEntity);
 
     // Function source location and pointer number.
     if(!hasEmittedName)
@@ -1403,12 +2757,18 @@ static size_t sysbvm_jit_emitObjectFileJittedFunctionName(sysbvm_bytecodeJit_t *
         sysbvm_sourcePosition_getStartLineAndColumn(jit->context, jit->sourcePosition, &sourceLine, &sourceColumn);
 
         snprintf(pointerBuffer, sizeof(pointerBuffer), "%d:%d-%08llx", sourceLine, sourceColumn, (unsigned long long)sysbvm_tuple_identityHash(jit->compiledProgramEntity));
-        sysbvm_dynarray_addAll(&jit->objectFileContent, strlen(pointerBuffer), pointerBuffer);
+        sysbvm_dynarray_addAll(buffer, strlen(pointerBuffer), pointerBuffer);
     }
 
     char nullTerminator = 0;
-    sysbvm_dynarray_add(&jit->objectFileContent, &nullTerminator);
+    sysbvm_dynarray_add(buffer, &nullTerminator);
+}
 
+static size_t sysbvm_jit_emitObjectFileJittedFunctionName(sysbvm_bytecodeJit_t *jit)
+{
+    size_t nameOffset = jit->objectFileContent.size;
+    jit->objectFileContentJittedFunctionNameOffset = nameOffset;
+    sysbvm_jit_emitJittedFunctionNameInto(jit, &jit->objectFileContent);
     return nameOffset;
 }
 
@@ -1505,10 +2865,20 @@ static void sysbvm_jit_emitObjectFile(sysbvm_bytecodeJit_t *jit)
     sysbvm_dynarray_addAll(&jit->objectFileContent, sizeof(footer), &footer);
 }
 
+static void sysbvm_jit_fixupEhFrame(sysbvm_bytecodeJit_t *jit, uint8_t *instructionsExecutablePointer, uint8_t *ehFramePointer, uint8_t *ehFrameExecutablePointer)
+{
+    if(jit->dwarfEhBuilder.fdeInitialLocationOffset > 0)
+    {
+        int32_t *initialLocationPointer = (int32_t*)(ehFramePointer + jit->dwarfEhBuilder.fdeInitialLocationOffset);
+        int32_t *initialLocationExecutablePointer = (int32_t*)(ehFrameExecutablePointer + jit->dwarfEhBuilder.fdeInitialLocationOffset);
+        *initialLocationPointer = (int32_t) ((uintptr_t)instructionsExecutablePointer - (uintptr_t)initialLocationExecutablePointer);
+    }
+}
+
 static void sysbvm_jit_fixupObjectFile(sysbvm_bytecodeJit_t *jit,
     sysbvm_elf64_header_t *header, sysbvm_elf64_header_t *headerExecutablePointer,
     uint8_t *instructionsExecutablePointer,
-    uint8_t *ehFramePointer, uint8_t *ehFrameExecutablePointer,
+    uint8_t *ehFrameExecutablePointer,
     uint8_t *debugLineExecutablePointer,
     uint8_t *debugStrExecutablePointer,
     uint8_t *debugAbbrevExecutablePointer,
@@ -1516,13 +2886,6 @@ static void sysbvm_jit_fixupObjectFile(sysbvm_bytecodeJit_t *jit,
     uint8_t *objectFileContentExecutablePointer,
     sysbvm_jit_x64_elfContentFooter_t *footer)
 {
-    if(jit->dwarfEhBuilder.fdeInitialLocationOffset > 0)
-    {
-        int32_t *initialLocationPointer = (int32_t*)(ehFramePointer + jit->dwarfEhBuilder.fdeInitialLocationOffset);
-        int32_t *initialLocationExecutablePointer = (int32_t*)(ehFrameExecutablePointer + jit->dwarfEhBuilder.fdeInitialLocationOffset);
-        *initialLocationPointer = (int32_t) ((uintptr_t)instructionsExecutablePointer - (uintptr_t)initialLocationExecutablePointer);
-    }
-
     header->sectionHeadersOffset = (uintptr_t)&footer->sections - (uintptr_t)header;
     sysbvm_elf64_off_t contentOffset = (uintptr_t)objectFileContentExecutablePointer - (uintptr_t)headerExecutablePointer;
     sysbvm_elf64_addr_t contentBaseAddress = (uintptr_t)objectFileContentExecutablePointer;
@@ -1559,29 +2922,78 @@ static void sysbvm_jit_fixupObjectFile(sysbvm_bytecodeJit_t *jit,
     footer->sections.shstr.address += contentBaseAddress;
 }
 
-static void sysbvm_jit_emitPerfSymbolFor(sysbvm_bytecodeJit_t *jit, uint8_t *instructionsPointers)
+static void sysbvm_jit_emitPerfJitDumpFor(sysbvm_bytecodeJit_t *jit, const char *name, uint8_t *instructionsPointers, uint8_t *instructionsExecutablePointers)
 {
-#if defined(__linux__) && defined(SYSBVM_EMIT_PERF_STACK_MAP)
-    static int sysbvm_jit_perfMapFD;
+    // Collect the line entries, and the names of their source files.
+    sysbvm_dynarray_t lineEntries;
+    sysbvm_dynarray_initialize(&lineEntries, sizeof(sysbvm_perf_jitDumpLineEntry_t), jit->sourcePositions.size);
+    sysbvm_dynarray_t fileNameOffsets;
+    sysbvm_dynarray_initialize(&fileNameOffsets, sizeof(size_t), jit->sourcePositions.size);
+    sysbvm_dynarray_t fileNames;
+    sysbvm_dynarray_initialize(&fileNames, 1, 256);
 
-    char buffer[2048];
-
-    if(!sysbvm_jit_perfMapFD)
+    sysbvm_tuple_t lastSourceCode = SYSBVM_NULL_TUPLE;
+    size_t lastFileNameOffset = 0;
+    sysbvm_bytecodeJitSourcePositionRecord_t *sourcePositionRecords = (sysbvm_bytecodeJitSourcePositionRecord_t*)jit->sourcePositions.data;
+    for(size_t i = 0; i < jit->sourcePositions.size; ++i)
     {
-        snprintf(buffer, sizeof(buffer), "/tmp/perf-%d.map", getpid());
-        sysbvm_jit_perfMapFD = open(buffer, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        sysbvm_bytecodeJitSourcePositionRecord_t *record = sourcePositionRecords + i;
+        sysbvm_tuple_t sourceCode = ((sysbvm_sourcePosition_t*)record->sourcePosition)->sourceCode;
+        if(i == 0 || sourceCode != lastSourceCode)
+        {
+            lastSourceCode = sourceCode;
+            lastFileNameOffset = fileNames.size;
+            if(!sysbvm_jit_emitSourceFileNameInto(&fileNames, record->sourcePosition))
+            {
+                char nullTerminator = 0;
+                sysbvm_dynarray_add(&fileNames, &nullTerminator);
+            }
+        }
+
+        sysbvm_perf_jitDumpLineEntry_t entry = {
+            .address = (uintptr_t)instructionsExecutablePointers + record->pc,
+            .line = record->line,
+        };
+        sysbvm_dynarray_add(&lineEntries, &entry);
+        sysbvm_dynarray_add(&fileNameOffsets, &lastFileNameOffset);
     }
 
-    if(sysbvm_jit_perfMapFD < 0) return;
+    for(size_t i = 0; i < lineEntries.size; ++i)
+        sysbvm_dynarray_entryOfTypeAt(lineEntries, sysbvm_perf_jitDumpLineEntry_t, i)->fileName = (const char*)fileNames.data + *sysbvm_dynarray_entryOfTypeAt(fileNameOffsets, size_t, i);
+
+    sysbvm_perf_jitDumpCodeLoad_t codeLoad = {
+        .elfMachine = SYSBVM_EM_X86_64,
+        .name = name,
+        .codeAddress = (uintptr_t)instructionsExecutablePointers,
+        .code = instructionsPointers,
+        .codeSize = jit->instructions.size,
+        .lineEntryCount = lineEntries.size,
+        .lineEntries = (sysbvm_perf_jitDumpLineEntry_t*)lineEntries.data,
+        .ehFrame = jit->dwarfEhBuilder.buffer.data,
+        .ehFrameSize = jit->dwarfEhBuilder.buffer.size,
+        .ehFrameFdeOffset = jit->dwarfEhBuilder.fdeOffset,
+        .ehFrameFdeInitialLocationOffset = jit->dwarfEhBuilder.fdeInitialLocationOffset,
+    };
+    sysbvm_perf_writeJitDumpCodeLoad(&codeLoad);
+
+    sysbvm_dynarray_destroy(&fileNames);
+    sysbvm_dynarray_destroy(&fileNameOffsets);
+    sysbvm_dynarray_destroy(&lineEntries);
+}
 
-    int symbolRecordSize = snprintf(buffer, sizeof(buffer), "%llx %llx %s\n", (long long)instructionsPointers, (long long)jit->instructions.size, (const char *)jit->objectFileContent.data + jit->objectFileContentJittedFunctionNameOffset);
-    ssize_t writeSize = write(sysbvm_jit_perfMapFD, buffer, symbolRecordSize);
-    if(writeSize != symbolRecordSize)
-        perror("Failed write map file entry");
-#else
-    (void)jit;
-    (void)instructionsPointers;
-#endif
+static void sysbvm_jit_emitPerfSymbolFor(sysbvm_bytecodeJit_t *jit, uint8_t *instructionsPointers, uint8_t *instructionsExecutablePointers)
+{
+    sysbvm_dynarray_t nameBuffer;
+    sysbvm_dynarray_initialize(&nameBuffer, 1, 64);
+    sysbvm_jit_emitJittedFunctionNameInto(jit, &nameBuffer);
+    const char *name = (const char*)nameBuffer.data;
+
+    if(jit->emitsPerfMapSymbol)
+        sysbvm_perf_writeMapEntry((uintptr_t)instructionsExecutablePointers, jit->instructions.size, name);
+    if(jit->emitsPerfJitDump)
+        sysbvm_jit_emitPerfJitDumpFor(jit, name, instructionsPointers, instructionsExecutablePointers);
+
+    sysbvm_dynarray_destroy(&nameBuffer);
 }
 
 static void sysbvm_jit_emitArgumentDebugInfo(sysbvm_bytecodeJit_t *jit, size_t oopTypeDie, size_t index, sysbvm_tuple_t binding)
@@ -1595,13 +3007,20 @@ static void sysbvm_jit_emitArgumentDebugInfo(sysbvm_bytecodeJit_t *jit, size_t o
 
     sysbvm_dwarf_debugInfo_attribute_beginLocationExpression(&jit->dwarfDebugInfoBuilder, DW_AT_location);
 
-    sysbvm_dwarf_debugInfo_location_frameBaseOffset(&jit->dwarfDebugInfoBuilder, jit->argumentVectorOffset);
-    sysbvm_dwarf_debugInfo_location_deref(&jit->dwarfDebugInfoBuilder);
-
-    if(index > 0)
+    if(jit->hasRegisterArgumentsEntryPoint)
+    {
+        sysbvm_dwarf_debugInfo_location_frameBaseOffset(&jit->dwarfDebugInfoBuilder, jit->inlineArgumentVectorOffset + (int32_t)(index * sizeof(sysbvm_tuple_t)));
+    }
+    else
     {
-        sysbvm_dwarf_debugInfo_location_constUnsigned(&jit->dwarfDebugInfoBuilder, index * sizeof(sysbvm_tuple_t));
-        sysbvm_dwarf_debugInfo_location_plus(&jit->dwarfDebugInfoBuilder);
+        sysbvm_dwarf_debugInfo_location_frameBaseOffset(&jit->dwarfDebugInfoBuilder, jit->argumentVectorOffset);
+        sysbvm_dwarf_debugInfo_location_deref(&jit->dwarfDebugInfoBuilder);
+
+        if(index > 0)
+        {
+            sysbvm_dwarf_debugInfo_location_constUnsigned(&jit->dwarfDebugInfoBuilder, index * sizeof(sysbvm_tuple_t));
+            sysbvm_dwarf_debugInfo_location_plus(&jit->dwarfDebugInfoBuilder);
+        }
     }
     sysbvm_dwarf_debugInfo_attribute_endLocationExpression(&jit->dwarfDebugInfoBuilder);
 
@@ -1702,8 +3121,20 @@ SYSBVM_API void sysbvm_jit_finish(sysbvm_bytecodeJit_t *jit)
     }
 
     sysbvm_jit_emitUnwindInfo(jit);
-    sysbvm_jit_emitDebugInfo(jit);
-    sysbvm_jit_emitObjectFile(jit);
+    if(jit->debugInfoLevel == SYSBVM_JIT_DEBUG_INFO_NONE)
+    {
+        // Exceptions are raised with longjmp, so only debuggers and profilers use the call frame information.
+        // The Windows function table is always kept because its longjmp unwinds through it.
+        jit->dwarfEhBuilder.buffer.size = 0;
+        return;
+    }
+
+    // The debug information and the object file are only used by gdb.
+    if(jit->debugInfoLevel == SYSBVM_JIT_DEBUG_INFO_FULL)
+    {
+        sysbvm_jit_emitDebugInfo(jit);
+        sysbvm_jit_emitObjectFile(jit);
+    }
 }
 
 SYSBVM_API uint8_t *sysbvm_jit_installIn(sysbvm_bytecodeJit_t *jit, uint8_t *codeWriteablePointer, uint8_t *codeExecutablePointer)
@@ -1782,28 +3213,35 @@ SYSBVM_API uint8_t *sysbvm_jit_installIn(sysbvm_bytecodeJit_t *jit, uint8_t *cod
     uint8_t *objectFileContentExecutablePointer = codeExecutablePointer + objectFileContentOffset;
     memcpy(objectFileContentPointer, jit->objectFileContent.data, jit->objectFileContent.size);
 
-    sysbvm_jit_fixupObjectFile(jit,
-        (sysbvm_elf64_header_t*)objectFileHeaderPointer,
-        (sysbvm_elf64_header_t*)objectFileHeaderExecutablePointer,
-        instructionsExecutablePointers,
-        ehFrameZonePointer, ehFrameZoneExecutablePointer,
-        debugLineZoneExecutablePointer,
-        debugStrZoneExecutablePointer,
-        debugAbbrevZoneExecutablePointer,
-        debugInfoZoneExecutablePointer,
-        objectFileContentExecutablePointer,
-        (sysbvm_jit_x64_elfContentFooter_t*) (objectFileContentPointer + jit->objectFileContent.size - sizeof(sysbvm_jit_x64_elfContentFooter_t))
-    );
-
-    sysbvm_jit_emitPerfSymbolFor(jit, instructionsPointers);
+    if(jit->dwarfEhBuilder.buffer.size > 0)
+        sysbvm_jit_fixupEhFrame(jit, instructionsExecutablePointers, ehFrameZonePointer, ehFrameZoneExecutablePointer);
 
-#ifdef _WIN32
-    RUNTIME_FUNCTION *runtimeFunction = (RUNTIME_FUNCTION*)unwindInfoZoneExecutablePointer;
-    runtimeFunction->UnwindInfoAddress = (DWORD)(sizeof(RUNTIME_FUNCTION) + unwindInfoZoneExecutablePointer - instructionsExecutablePointers);
-    if(RtlAddFunctionTable(runtimeFunction, 1, (DWORD64)(uintptr_t)instructionsExecutablePointers))
+    if(jit->objectFileHeader.size > 0)
     {
-        // Store the handle in the context for cleanup.
+        sysbvm_jit_fixupObjectFile(jit,
+            (sysbvm_elf64_header_t*)objectFileHeaderPointer,
+            (sysbvm_elf64_header_t*)objectFileHeaderExecutablePointer,
+            instructionsExecutablePointers,
+            ehFrameZoneExecutablePointer,
+            debugLineZoneExecutablePointer,
+            debugStrZoneExecutablePointer,
+            debugAbbrevZoneExecutablePointer,
+            debugInfoZoneExecutablePointer,
+            objectFileContentExecutablePointer,
+            (sysbvm_jit_x64_elfContentFooter_t*) (objectFileContentPointer + jit->objectFileContent.size - sizeof(sysbvm_jit_x64_elfContentFooter_t))
+        );
     }
+
+    if(jit->emitsPerfMapSymbol || jit->emitsPerfJitDump)
+        sysbvm_jit_emitPerfSymbolFor(jit, instructionsPointers, instructionsExecutablePointers);
+
+#ifdef _WIN32
+    size_t runtimeFunctionCount = 1 + jit->secondaryPrologueCount;
+    RUNTIME_FUNCTION *runtimeFunction = (RUNTIME_FUNCTION*)unwindInfoZoneExecutablePointer;
+    for(size_t i = 0; i < runtimeFunctionCount; ++i)
+        runtimeFunction[i].UnwindInfoAddress = (DWORD)(runtimeFunctionCount*sizeof(RUNTIME_FUNCTION) + unwindInfoZoneExecutablePointer - instructionsExecutablePointers);
+    if(RtlAddFunctionTable(runtimeFunction, (DWORD)runtimeFunctionCount, (DWORD64)(uintptr_t)instructionsExecutablePointers))
+        jit->codeBlock->registeredFrame = runtimeFunction;
 #else
     (void)unwindInfoZoneExecutablePointer;
     if(jit->dwarfEhBuilder.buffer.size > 0)
@@ -1813,12 +3251,12 @@ SYSBVM_API uint8_t *sysbvm_jit_installIn(sysbvm_bytecodeJit_t *jit, uint8_t *cod
         if(jit->dwarfEhBuilder.fdeOffset > 0)
         {
             void *fdePointer = ehFrameZoneExecutablePointer + jit->dwarfEhBuilder.fdeOffset;
-            sysbvm_dynarray_add(&jit->context->jittedRegisteredFrames, &fdePointer);
+            jit->codeBlock->registeredFrame = fdePointer;
             __register_frame(fdePointer);
         }
 #   else
         // Send the eh_frame section.
-        sysbvm_dynarray_add(&jit->context->jittedRegisteredFrames, &ehFrameZoneExecutablePointer);
+        jit->codeBlock->registeredFrame = ehFrameZoneExecutablePointer;
         __register_frame(ehFrameZoneExecutablePointer);
 #   endif
     }
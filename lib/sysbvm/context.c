@@ -4,21 +4,17 @@
 #include "sysbvm/orderedCollection.h"
 #include "sysbvm/environment.h"
 #include "sysbvm/gc.h"
-#include "sysbvm/gdb.h"
 #include "sysbvm/stackFrame.h"
 #include "sysbvm/string.h"
 #include "sysbvm/set.h"
 #include "sysbvm/system.h"
 #include "sysbvm/function.h"
+#include "sysbvm/gdb.h"
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
-#ifndef _WIN32
-extern void __deregister_frame(const void*);
-#endif
-
 static bool sysbvm_context_default_jitEnabled = true;
 
 extern void sysbvm_array_registerPrimitives(void);
@@ -73,6 +69,8 @@ extern void sysbvm_time_setupPrimitives(sysbvm_context_t *context);
 extern void sysbvm_tuple_setupPrimitives(sysbvm_context_t *context);
 extern void sysbvm_type_setupPrimitives(sysbvm_context_t *context);
 
+extern void sysbvm_symbol_releaseRetiredTables(sysbvm_context_t *context);
+
 void sysbvm_context_registerPrimitives(void)
 {
     sysbvm_primitiveTable_registerFunction(sysbvm_tuple_primitive_identityEquals, "==");
@@ -189,7 +187,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_context_createIntrinsicType(sysbvm_context_t *c
     sysbvm_tuple_t nameSymbol = sysbvm_symbol_internWithCString(context, name);
     sysbvm_tuple_t type = sysbvm_type_createWithName(context, nameSymbol);
     if(supertype)
-        sysbvm_type_setSupertype(type, supertype);
+        sysbvm_type_setSupertype(context, type, supertype);
     sysbvm_environment_setNewSymbolBindingWithValue(context, context->roots.globalNamespace, nameSymbol, type);
     sysbvm_orderedCollection_add(context, context->roots.intrinsicTypes, type);
 
@@ -236,7 +234,7 @@ static void sysbvm_context_setIntrinsicTypeMetadata(sysbvm_context_t *context, s
     sysbvm_tuple_t nameSymbol = sysbvm_symbol_internWithCString(context, name);
     sysbvm_type_setName(type, nameSymbol);
     if(supertype)
-        sysbvm_type_setSupertype(type, supertype);
+        sysbvm_type_setSupertype(context, type, supertype);
     sysbvm_environment_setNewSymbolBindingWithValue(context, context->roots.globalNamespace, nameSymbol, type);
     sysbvm_orderedCollection_add(context, context->roots.intrinsicTypes, type);
 
@@ -361,7 +359,7 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     context->roots.anyValueType = sysbvm_type_createAnonymousAndMetatype(context);
     context->roots.typeType = sysbvm_type_createAnonymous(context);
     sysbvm_tuple_setType((sysbvm_object_tuple_t*)context->roots.typeType, context->roots.typeType);
-    sysbvm_type_setSupertype(context->roots.anyValueType, context->roots.untypedType);
+    sysbvm_type_setSupertype(context, context->roots.anyValueType, context->roots.untypedType);
 
     sysbvm_type_setFlags(context, context->roots.anyValueType, SYSBVM_TYPE_FLAGS_NULLABLE | SYSBVM_TYPE_FLAGS_DYNAMIC);
     sysbvm_type_setFlags(context, context->roots.untypedType, SYSBVM_TYPE_FLAGS_NULLABLE | SYSBVM_TYPE_FLAGS_DYNAMIC);
@@ -370,23 +368,23 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     context->roots.objectType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.anyValueType);
     context->roots.lookupKeyType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.objectType);
     context->roots.programEntityType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.lookupKeyType);
-    sysbvm_type_setSupertype(context->roots.typeType, context->roots.programEntityType);
-    sysbvm_type_setSupertype(sysbvm_tuple_getType(context, context->roots.lookupKeyType), sysbvm_tuple_getType(context, context->roots.objectType));
-    sysbvm_type_setSupertype(sysbvm_tuple_getType(context, context->roots.programEntityType), sysbvm_tuple_getType(context, context->roots.lookupKeyType));
+    sysbvm_type_setSupertype(context, context->roots.typeType, context->roots.programEntityType);
+    sysbvm_type_setSupertype(context, sysbvm_tuple_getType(context, context->roots.lookupKeyType), sysbvm_tuple_getType(context, context->roots.objectType));
+    sysbvm_type_setSupertype(context, sysbvm_tuple_getType(context, context->roots.programEntityType), sysbvm_tuple_getType(context, context->roots.lookupKeyType));
 
     context->roots.metatypeType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.typeType);
 
     sysbvm_tuple_setType((sysbvm_object_tuple_t*)sysbvm_tuple_getType(context, context->roots.untypedType), context->roots.metatypeType);
-    sysbvm_type_setSupertype(sysbvm_tuple_getType(context, context->roots.untypedType), context->roots.typeType);
+    sysbvm_type_setSupertype(context, sysbvm_tuple_getType(context, context->roots.untypedType), context->roots.typeType);
 
     sysbvm_tuple_setType((sysbvm_object_tuple_t*)sysbvm_tuple_getType(context, context->roots.anyValueType), context->roots.metatypeType);
-    sysbvm_type_setSupertype(sysbvm_tuple_getType(context, context->roots.anyValueType), context->roots.typeType);
+    sysbvm_type_setSupertype(context, sysbvm_tuple_getType(context, context->roots.anyValueType), context->roots.typeType);
 
     context->roots.classType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.typeType);
     context->roots.metaclassType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.metatypeType);
 
     sysbvm_tuple_setType((sysbvm_object_tuple_t*)sysbvm_tuple_getType(context, context->roots.objectType), context->roots.metaclassType);
-    sysbvm_type_setSupertype(sysbvm_tuple_getType(context, context->roots.objectType), context->roots.classType);
+    sysbvm_type_setSupertype(context, sysbvm_tuple_getType(context, context->roots.objectType), context->roots.classType);
 
     sysbvm_tuple_setType((sysbvm_object_tuple_t*)sysbvm_tuple_getType(context, context->roots.lookupKeyType), context->roots.metaclassType);
 
@@ -586,9 +584,9 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     
     context->roots.anyPointerType = sysbvm_type_createAnonymous(context);
     context->roots.anyReferenceType = sysbvm_type_createAnonymous(context);
-    sysbvm_type_setSupertype(context->roots.anyReferenceType, context->roots.untypedType);
+    sysbvm_type_setSupertype(context, context->roots.anyReferenceType, context->roots.untypedType);
     context->roots.anyTemporaryReferenceType = sysbvm_type_createAnonymous(context);
-    sysbvm_type_setSupertype(context->roots.anyTemporaryReferenceType, context->roots.untypedType);
+    sysbvm_type_setSupertype(context, context->roots.anyTemporaryReferenceType, context->roots.untypedType);
 
     context->roots.pointerLikeType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.primitiveValueType);
     context->roots.pointerType = sysbvm_type_createAnonymousClassAndMetaclass(context, context->roots.pointerLikeType);
@@ -681,7 +679,7 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
         "children", SYSBVM_TYPE_SLOT_FLAG_PROTECTED, context->roots.orderedCollectionType,
         NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.typeType, "Type", SYSBVM_NULL_TUPLE,
-        "supertype", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_NO_RTTI_EXCLUDED, context->roots.typeType,
+        "supertype", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_READONLY | SYSBVM_TYPE_SLOT_FLAG_NO_RTTI_EXCLUDED, context->roots.typeType,
         "slots", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.arrayType,
         "slotsWithBasicInitialization", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.arrayType,
         "allSlots", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.arrayType,
@@ -695,7 +693,7 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
         "slotDictionary", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.methodDictionaryType,
 
         "macroMethodDictionary", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.methodDictionaryType,
-        "methodDictionary", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.methodDictionaryType,
+        "methodDictionary", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_READONLY | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.methodDictionaryType,
         "fallbackMethodDictionary", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.methodDictionaryType,
         "virtualMethodSelectorList", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.orderedCollectionType,
         "virtualTableLayout", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_TARGET_GENERATED | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.virtualTableLayoutType,
@@ -706,6 +704,8 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
         "pendingSlots", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, SYSBVM_NULL_TUPLE,
         "subtypes", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, SYSBVM_NULL_TUPLE,
         "children", SYSBVM_TYPE_SLOT_FLAG_PROTECTED, context->roots.orderedCollectionType,
+        "supertypeDisplay", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_CACHE | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.arrayType,
+        "dispatchTable", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_CACHE | SYSBVM_TYPE_SLOT_FLAG_MIN_RTTI_EXCLUDED, context->roots.arrayType,
         NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.classType, "Class", SYSBVM_NULL_TUPLE, NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.metatypeType, "Metatype", SYSBVM_NULL_TUPLE,
@@ -913,6 +913,14 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
         "jittedCodeTrampoline", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.systemHandleType,
         "jittedCodeTrampolineWritePointer", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.systemHandleType,
         "jittedCodeTrampolineSessionToken", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.systemHandleType,
+
+        "jittedOsrEntryPoint", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.systemHandleType,
+        "jittedOsrTargets", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.arrayType,
+
+        "jittedRegisterArgumentsEntryPoint", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.systemHandleType,
+
+        "invocationCount", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.uint32Type,
+        "backEdgeCount", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_JIT_SPECIFIC, context->roots.uint32Type,
         NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.functionNativeCodeType, "FunctionNativeCodeDefinition", SYSBVM_NULL_TUPLE,
         "definition", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.functionDefinitionType,
@@ -1126,6 +1134,7 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
         "storage", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.arrayType,
         NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.identityDictionaryType, "IdentityDictionary", SYSBVM_NULL_TUPLE,
+        "controlBytes", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_CACHE, context->roots.byteArrayType,
         NULL);
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.weakKeyDictionaryType, "WeakKeyDictionary", SYSBVM_NULL_TUPLE,
         NULL);
@@ -1134,6 +1143,7 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     sysbvm_context_setIntrinsicTypeMetadata(context, context->roots.methodDictionaryType, "MethodDictionary", SYSBVM_NULL_TUPLE,
         "size", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.sizeType,
         "storage", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.arrayType,
+        "controlBytes", SYSBVM_TYPE_SLOT_FLAG_PUBLIC | SYSBVM_TYPE_SLOT_FLAG_CACHE, context->roots.byteArrayType,
         NULL);
     context->roots.generatedSymbolType = sysbvm_context_createIntrinsicClass(context, "GeneratedSymbol", context->roots.symbolType,
         "value", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.symbolType,
@@ -1164,6 +1174,8 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     context->roots.stringStreamType = sysbvm_context_createIntrinsicClass(context, "StringStream", context->roots.streamType,
         "size", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.sizeType,
         "storage", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.stringType,
+        "chunks", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.orderedCollectionType,
+        "chunkedSize", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.sizeType,
         NULL);
     context->roots.valueBoxType = sysbvm_context_createIntrinsicClass(context, "ValueBox", SYSBVM_NULL_TUPLE,
         "value", SYSBVM_TYPE_SLOT_FLAG_PUBLIC, context->roots.untypedType,
@@ -1513,16 +1525,38 @@ static void sysbvm_context_createBasicTypes(sysbvm_context_t *context)
     context->roots.immediateTrivialTypeTable[SYSBVM_TUPLE_IMMEDIATE_TRIVIAL_INDEX_PENDING_MEMOIZATION_VALUE] = context->roots.pendingMemoizationValueType;
 }
 
+static void sysbvm_context_allocateGlobalMethodLookupCache(sysbvm_context_t *context, size_t entryCount)
+{
+    size_t setCount = GLOBAL_LOOKUP_CACHE_MIN_SELECTOR_GROUP_SET_COUNT;
+    while(setCount * GLOBAL_LOOKUP_CACHE_WAY_COUNT < entryCount)
+        setCount <<= 1;
+
+    // Balance the entries that a single selector may use against the sets that are scanned when flushing it.
+    size_t selectorGroupSetCount = GLOBAL_LOOKUP_CACHE_MIN_SELECTOR_GROUP_SET_COUNT;
+    while(selectorGroupSetCount * selectorGroupSetCount < setCount)
+        selectorGroupSetCount <<= 1;
+
+    context->globalMethodLookupCacheSetCount = setCount;
+    context->globalMethodLookupCacheSelectorGroupSetCount = selectorGroupSetCount;
+    context->globalMethodLookupCache = (sysbvm_globalLookupCacheSet_t*)calloc(setCount, sizeof(sysbvm_globalLookupCacheSet_t));
+}
+
 SYSBVM_API sysbvm_context_t *sysbvm_context_createWithOptions(sysbvm_contextCreationOptions_t *contextOptions)
 {
     sysbvm_context_t *context = (sysbvm_context_t*)calloc(1, sizeof(sysbvm_context_t));
     context->targetWordSize = contextOptions->targetWordSize ? contextOptions->targetWordSize : sizeof(void*);
     context->identityHashSeed = 1;
     context->jitEnabled = sysbvm_context_default_jitEnabled && !contextOptions->nojit;
+    context->jitInvocationThreshold = contextOptions->jitInvocationThreshold ? contextOptions->jitInvocationThreshold : SYSBVM_JIT_DEFAULT_INVOCATION_THRESHOLD;
+    context->jitBackEdgeThreshold = contextOptions->jitBackEdgeThreshold ? contextOptions->jitBackEdgeThreshold : SYSBVM_JIT_DEFAULT_BACK_EDGE_THRESHOLD;
+    context->jitDebugInfoLevel = contextOptions->jitDebugInfoLevel ? contextOptions->jitDebugInfoLevel : SYSBVM_JIT_DEBUG_INFO_FULL;
+    // Probing for the debugger is expensive, so it is only done once instead of on every compilation.
+    context->jitFullDebugInfoRequested = context->jitDebugInfoLevel == SYSBVM_JIT_DEBUG_INFO_FULL && sysbvm_gdb_isDebuggerAttached();
+    context->jitPerfMap = contextOptions->jitPerfMap;
+    context->jitPerfJitDump = contextOptions->jitPerfJitDump;
     context->gcDisabled = contextOptions->gcType == SYSBVM_GC_TYPE_DISABLED;
-    sysbvm_dynarray_initialize(&context->jittedObjectFileEntries, sizeof(sysbvm_gdb_jit_code_entry_t*), 1024);
-    sysbvm_dynarray_initialize(&context->jittedRegisteredFrames, sizeof(void*), 1024);
     sysbvm_dynarray_initialize(&context->markingStack, sizeof(sysbvm_tuple_t), 1<<20);
+    sysbvm_context_allocateGlobalMethodLookupCache(context, contextOptions->methodLookupCacheSize ? contextOptions->methodLookupCacheSize : SYSBVM_DEFAULT_METHOD_LOOKUP_CACHE_SIZE);
 
     sysbvm_heap_initialize(&context->heap);
     context->analyzeASTWithEnvironmentPIC = (sysbvm_pic_t*)sysbvm_chunkedAllocator_allocate(&context->heap.picTableAllocator, sizeof(sysbvm_pic_t), sizeof(uintptr_t));
@@ -1644,34 +1678,13 @@ SYSBVM_API void sysbvm_context_destroy(sysbvm_context_t *context)
 {
     if(!context) return;
 
-    // Unregister the jitted object codes.
-    {
-        sysbvm_gdb_jit_code_entry_t **registeredEntries = (sysbvm_gdb_jit_code_entry_t**)context->jittedObjectFileEntries.data;
-        for(size_t i = 0; i < context->jittedObjectFileEntries.size; ++i)
-        {
-            sysbvm_gdb_jit_code_entry_t *entry = registeredEntries[i];
-            sysbvm_gdb_unregisterObjectFile(entry);
-            free(entry);
-        }
-        sysbvm_dynarray_destroy(&context->jittedObjectFileEntries);
-    }
-
-    // Unregister the jitted registered frames.
-    {
-        void **registeredFrames = (void **)context->jittedRegisteredFrames.data;
-        for(size_t i = 0; i < context->jittedRegisteredFrames.size; ++i)
-        {
-#ifdef _WIN32
-#else
-            __deregister_frame(registeredFrames[i]);
-#endif
-        }
-        sysbvm_dynarray_destroy(&context->jittedRegisteredFrames);
-    }
-
-    // Destroy the context heap.
+    // Destroy the context heap. This also unregisters the jitted code.
     sysbvm_dynarray_destroy(&context->markingStack);
     sysbvm_heap_destroy(&context->heap);
+    free(context->globalMethodLookupCache);
+    free(context->picDependencyBuckets);
+    sysbvm_symbol_releaseRetiredTables(context);
+    free(atomic_load(&context->symbolTable));
     free(context);
 }
 
@@ -1707,6 +1720,11 @@ SYSBVM_API sysbvm_context_t *sysbvm_context_loadImageFromFileNamed(const char *f
     }
     
     context->jitEnabled = sysbvm_context_default_jitEnabled;
+    context->jitInvocationThreshold = SYSBVM_JIT_DEFAULT_INVOCATION_THRESHOLD;
+    context->jitBackEdgeThreshold = SYSBVM_JIT_DEFAULT_BACK_EDGE_THRESHOLD;
+    context->jitDebugInfoLevel = SYSBVM_JIT_DEBUG_INFO_FULL;
+    context->jitFullDebugInfoRequested = sysbvm_gdb_isDebuggerAttached();
+    sysbvm_context_allocateGlobalMethodLookupCache(context, SYSBVM_DEFAULT_METHOD_LOOKUP_CACHE_SIZE);
 
     fclose(inputFile);
 
@@ -1776,6 +1794,28 @@ sysbvm_object_tuple_t *sysbvm_context_allocatePointerTuple(sysbvm_context_t *con
     return result;
 }
 
+sysbvm_object_tuple_t *sysbvm_context_allocateByteTupleInAllocationBuffer(sysbvm_context_t *context, sysbvm_tuple_t type, size_t byteSize)
+{
+    if(!context) return 0;
+
+    sysbvm_object_tuple_t *result = sysbvm_heap_allocateByteTupleInAllocationBuffer(&context->heap, byteSize);
+    sysbvm_tuple_setIdentityHash(result, sysbvm_context_generateIdentityHash(context));
+    if(result)
+        sysbvm_tuple_setType(result, type);
+    return result;
+}
+
+sysbvm_object_tuple_t *sysbvm_context_allocatePointerTupleInAllocationBuffer(sysbvm_context_t *context, sysbvm_tuple_t type, size_t slotCount)
+{
+    if(!context) return 0;
+
+    sysbvm_object_tuple_t *result = sysbvm_heap_allocatePointerTupleInAllocationBuffer(&context->heap, slotCount);
+    sysbvm_tuple_setIdentityHash(result, sysbvm_context_generateIdentityHash(context));
+    if(result)
+        sysbvm_tuple_setType(result, type);
+    return result;
+}
+
 /**
  * Print memory usage statistics.
  */
@@ -1785,6 +1825,8 @@ SYSBVM_API void sysbvm_context_printMemoryUsageStats(sysbvm_context_t *context)
         return;
 
     printf("Heap Size: %lld\n", (long long)context->heap.totalSize);
+    printf("Code Size: %lld\n", (long long)context->heap.codeSize);
+    printf("Free Code Size: %lld\n", (long long)context->heap.codeFreeSize);
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_context_shallowCopy(sysbvm_context_t *context, sysbvm_tuple_t tuple)
@@ -4,9 +4,25 @@
 #include "sysbvm/dictionary.h"
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
+#include "sysbvm/hash.h"
+#include "sysbvm/integer.h"
 #include "sysbvm/stackFrame.h"
+#include "sysbvm/type.h"
 #include "internal/context.h"
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SYSBVM_HASHTABLE_CONTROL_USE_SSE2 1
+#endif
+
+// The control bytes of an open addressing table hold a 7-bit fragment of the hash of each occupied slot.
+// They are stored after the element count they were computed for, and padded with sentinels for the group loads.
+#define SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE 16
+#define SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE sizeof(uint64_t)
+#define SYSBVM_HASHTABLE_CONTROL_EMPTY 0x80
+#define SYSBVM_HASHTABLE_CONTROL_SENTINEL 0xFF
 
 SYSBVM_API sysbvm_tuple_t sysbvm_dictionary_create(sysbvm_context_t *context)
 {
@@ -28,26 +44,59 @@ SYSBVM_API sysbvm_tuple_t sysbvm_dictionary_createWithCapacity(sysbvm_context_t
 
 static intptr_t sysbvm_dictionary_scanFor(sysbvm_context_t *context, sysbvm_dictionary_t **dictionary, sysbvm_tuple_t *element)
 {
+    size_t capacity = sysbvm_tuple_getSizeInSlots((*dictionary)->storage);
+    if(capacity == 0)
+        return -1;
+
+    // Resolve the comparison functions once per scan instead of once per probe.
+    sysbvm_tuple_t elementType = sysbvm_tuple_getType(context, *element);
+    sysbvm_tuple_t hashFunction = elementType ? sysbvm_type_getHashFunction(context, elementType) : SYSBVM_NULL_TUPLE;
+    sysbvm_tuple_t equalsFunction = elementType ? sysbvm_type_getEqualsFunction(context, elementType) : SYSBVM_NULL_TUPLE;
+    sysbvm_tuple_comparisonKind_t equalsKind = sysbvm_tuple_getComparisonKindOfFunction(context, equalsFunction);
+
     struct {
+        sysbvm_tuple_t hashFunction;
+        sysbvm_tuple_t equalsFunction;
         sysbvm_array_t *storage;
         sysbvm_association_t *association;
-    } gcFrame = {0};
+    } gcFrame = {
+        .hashFunction = hashFunction,
+        .equalsFunction = equalsFunction,
+    };
     SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
 
-    size_t capacity = sysbvm_tuple_getSizeInSlots((*dictionary)->storage);
-    if(capacity == 0)
+    size_t hashIndex = sysbvm_tuple_hashWith(context, gcFrame.hashFunction, sysbvm_tuple_getComparisonKindOfFunction(context, gcFrame.hashFunction), *element) % capacity;
+    gcFrame.storage = (sysbvm_array_t*)(*dictionary)->storage;
+
+    // Identity and bytewise keys are compared in C, so the probe cannot trigger a collection.
+    if(equalsKind != SYSBVM_TUPLE_COMPARISON_KIND_GENERIC)
     {
+        sysbvm_tuple_t key = *element;
+        sysbvm_tuple_t *elements = gcFrame.storage->elements;
         SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+
+        for(size_t i = hashIndex; i < capacity; ++i)
+        {
+            sysbvm_association_t *association = (sysbvm_association_t*)elements[i];
+            if(!association || sysbvm_tuple_equalsWith(context, SYSBVM_NULL_TUPLE, equalsKind, key, association->key))
+                return (intptr_t)i;
+        }
+
+        for(size_t i = 0; i < hashIndex; ++i)
+        {
+            sysbvm_association_t *association = (sysbvm_association_t*)elements[i];
+            if(!association || sysbvm_tuple_equalsWith(context, SYSBVM_NULL_TUPLE, equalsKind, key, association->key))
+                return (intptr_t)i;
+        }
+
         return -1;
     }
 
-    gcFrame.storage = (sysbvm_array_t*)(*dictionary)->storage;
-    size_t hashIndex = sysbvm_tuple_hash(context, *element) % capacity;
     for(size_t i = hashIndex; i < capacity; ++i)
     {
         gcFrame.association = (sysbvm_association_t*)gcFrame.storage->elements[i];
         if(!gcFrame.association ||
-            sysbvm_tuple_equals(context, *element, gcFrame.association->key))
+            sysbvm_tuple_equalsWith(context, gcFrame.equalsFunction, equalsKind, *element, gcFrame.association->key))
         {
             SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
             return (intptr_t)i;
@@ -58,13 +107,14 @@ static intptr_t sysbvm_dictionary_scanFor(sysbvm_context_t *context, sysbvm_dict
     {
         gcFrame.association = (sysbvm_association_t*)gcFrame.storage->elements[i];
         if(!gcFrame.association ||
-            sysbvm_tuple_equals(context, *element, gcFrame.association->key))
+            sysbvm_tuple_equalsWith(context, gcFrame.equalsFunction, equalsKind, *element, gcFrame.association->key))
         {
             SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
             return (intptr_t)i;
         }
     }
 
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
     return -1;
 }
 
@@ -149,6 +199,7 @@ static void sysbvm_dictionary_increaseCapacity(sysbvm_context_t *context, sysbvm
 
     // We need to recompute the size due to deleted weak objects.
     (*dictionary)->size = sysbvm_tuple_size_encode(context, newSize);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
 }
 
 SYSBVM_API void sysbvm_dictionary_add(sysbvm_context_t *context, sysbvm_tuple_t dictionary, sysbvm_tuple_t association)
@@ -360,6 +411,7 @@ static void sysbvm_weakValueDictionary_increaseCapacity(sysbvm_context_t *contex
 
     // We need to recompute the size due to deleted weak objects.
     (*dictionary)->size = sysbvm_tuple_size_encode(context, newSize);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
 }
 
 SYSBVM_API void sysbvm_weakValueDictionary_atPut(sysbvm_context_t *context, sysbvm_tuple_t dictionary, sysbvm_tuple_t key, sysbvm_tuple_t value)
@@ -409,10 +461,147 @@ SYSBVM_API void sysbvm_weakValueDictionary_atPut(sysbvm_context_t *context, sysb
     SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
 }
 
+static uint8_t sysbvm_hashtableControl_fragmentForHash(size_t hash)
+{
+    return (uint8_t)((sysbvm_hashMultiply(hash) >> 16) & 0x7F);
+}
+
+static uint8_t *sysbvm_hashtableControl_getValidBytes(sysbvm_tuple_t controlBytes, size_t capacity, size_t size)
+{
+    // The Sysmel side does not maintain the control bytes, so its mutators discard them. The element count check also catches
+    // the control bytes that were not updated by the last insertion.
+    if(!sysbvm_tuple_isBytes(controlBytes) || sysbvm_tuple_getSizeInBytes(controlBytes) != SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE + capacity + SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE)
+        return NULL;
+
+    uint8_t *bytes = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(controlBytes)->bytes;
+    uint64_t controlSize;
+    memcpy(&controlSize, bytes, sizeof(controlSize));
+    if(controlSize != size)
+        return NULL;
+
+    return bytes + SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE;
+}
+
+static void sysbvm_hashtableControl_setSize(uint8_t *controlBytes, size_t size)
+{
+    uint64_t controlSize = size;
+    memcpy(controlBytes - SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE, &controlSize, sizeof(controlSize));
+}
+
+static uint8_t *sysbvm_hashtableControl_create(sysbvm_context_t *context, sysbvm_tuple_t *controlBytes, size_t capacity)
+{
+    *controlBytes = (sysbvm_tuple_t)sysbvm_context_allocateByteTuple(context, context->roots.byteArrayType, SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE + capacity + SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE);
+    uint8_t *bytes = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(*controlBytes)->bytes + SYSBVM_HASHTABLE_CONTROL_HEADER_SIZE;
+    memset(bytes, SYSBVM_HASHTABLE_CONTROL_EMPTY, capacity);
+    memset(bytes + capacity, SYSBVM_HASHTABLE_CONTROL_SENTINEL, SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE);
+    sysbvm_hashtableControl_setSize(bytes, 0);
+    return bytes;
+}
+
+static uint32_t sysbvm_hashtableControl_matchGroup(const uint8_t *group, uint8_t value)
+{
+#ifdef SYSBVM_HASHTABLE_CONTROL_USE_SSE2
+    __m128i groupBytes = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(groupBytes, _mm_set1_epi8((char)value)));
+#else
+    uint32_t mask = 0;
+    for(uint32_t i = 0; i < SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE; ++i)
+        mask |= (uint32_t)(group[i] == value) << i;
+    return mask;
+#endif
+}
+
+/**
+ * Scans the slots in [startIndex, endIndex) a group at a time. This visits the same slots as the linear probing
+ * of the Sysmel side, so it returns the first slot that is empty or that holds the key.
+ */
+static bool sysbvm_hashtableControl_scanRange(const uint8_t *controlBytes, size_t startIndex, size_t endIndex, uint8_t fragment, sysbvm_tuple_t *elements, size_t elementStride, bool hasAssociations, sysbvm_tuple_t key, intptr_t *outIndex)
+{
+    for(size_t groupIndex = startIndex; groupIndex < endIndex; groupIndex += SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE)
+    {
+        const uint8_t *group = controlBytes + groupIndex;
+        size_t remainingCount = endIndex - groupIndex;
+        uint32_t validMask = remainingCount >= SYSBVM_HASHTABLE_CONTROL_GROUP_SIZE ? 0xFFFF : ((uint32_t)1 << remainingCount) - 1;
+        uint32_t emptyMask = sysbvm_hashtableControl_matchGroup(group, SYSBVM_HASHTABLE_CONTROL_EMPTY) & validMask;
+        uint32_t candidateMask = sysbvm_hashtableControl_matchGroup(group, fragment) & validMask;
+
+        // Only the candidates before the first empty slot are part of the probe sequence.
+        if(emptyMask)
+            candidateMask &= (emptyMask & (~emptyMask + 1)) - 1;
+
+        while(candidateMask)
+        {
+            size_t elementIndex = groupIndex + sysbvm_uint32_lowBit(candidateMask) - 1;
+            sysbvm_tuple_t element = elements[elementIndex*elementStride];
+            if(hasAssociations)
+                element = sysbvm_association_getKey(element);
+            if(sysbvm_tuple_identityEquals(key, element))
+            {
+                *outIndex = (intptr_t)elementIndex;
+                return true;
+            }
+
+            candidateMask &= candidateMask - 1;
+        }
+
+        if(emptyMask)
+        {
+            *outIndex = (intptr_t)(groupIndex + sysbvm_uint32_lowBit(emptyMask) - 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static intptr_t sysbvm_hashtableControl_scanFor(const uint8_t *controlBytes, size_t capacity, size_t hash, sysbvm_tuple_t *elements, size_t elementStride, bool hasAssociations, sysbvm_tuple_t key)
+{
+    size_t hashIndex = hash % capacity;
+    uint8_t fragment = sysbvm_hashtableControl_fragmentForHash(hash);
+    intptr_t result = -1;
+    if(sysbvm_hashtableControl_scanRange(controlBytes, hashIndex, capacity, fragment, elements, elementStride, hasAssociations, key, &result)
+        || sysbvm_hashtableControl_scanRange(controlBytes, 0, hashIndex, fragment, elements, elementStride, hasAssociations, key, &result))
+        return result;
+
+    return -1;
+}
+
+static void sysbvm_hashtableControl_rebuild(sysbvm_context_t *context, sysbvm_tuple_t *controlBytesSlot, size_t capacity, sysbvm_tuple_t *elements, size_t elementStride, bool hasAssociations, sysbvm_tuple_t emptyElement)
+{
+    uint8_t *controlBytes = sysbvm_hashtableControl_create(context, controlBytesSlot, capacity);
+    size_t size = 0;
+    for(size_t i = 0; i < capacity; ++i)
+    {
+        sysbvm_tuple_t element = elements[i*elementStride];
+        if(element == emptyElement)
+            continue;
+
+        if(hasAssociations)
+            element = sysbvm_association_getKey(element);
+        controlBytes[i] = sysbvm_hashtableControl_fragmentForHash(sysbvm_tuple_identityHash(element));
+        ++size;
+    }
+
+    sysbvm_hashtableControl_setSize(controlBytes, size);
+}
+
+static void sysbvm_hashtableControl_insertedElement(sysbvm_context_t *context, sysbvm_tuple_t *controlBytesSlot, size_t capacity, size_t oldSize, size_t elementIndex, sysbvm_tuple_t key, sysbvm_tuple_t *elements, size_t elementStride, bool hasAssociations, sysbvm_tuple_t emptyElement)
+{
+    uint8_t *controlBytes = sysbvm_hashtableControl_getValidBytes(*controlBytesSlot, capacity, oldSize);
+    if(!controlBytes)
+    {
+        sysbvm_hashtableControl_rebuild(context, controlBytesSlot, capacity, elements, elementStride, hasAssociations, emptyElement);
+        return;
+    }
+
+    controlBytes[elementIndex] = sysbvm_hashtableControl_fragmentForHash(sysbvm_tuple_identityHash(key));
+    sysbvm_hashtableControl_setSize(controlBytes, oldSize + 1);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_identityDictionary_create(sysbvm_context_t *context)
 {
     sysbvm_identityDictionary_t *result = (sysbvm_identityDictionary_t*)sysbvm_context_allocatePointerTuple(context, context->roots.identityDictionaryType, SYSBVM_SLOT_COUNT_FOR_STRUCTURE_TYPE(sysbvm_identityDictionary_t));
-    result->size = sysbvm_tuple_size_encode(context, 0);
+    result->super.size = sysbvm_tuple_size_encode(context, 0);
     return (sysbvm_tuple_t)result;
 }
 
@@ -434,6 +623,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_methodDictionary_createWithCapacity(sysbvm_cont
         result->storage = sysbvm_array_create(context, entryCount);
         for(size_t i = 0; i < entryCount; ++i)
             sysbvm_array_atPut(result->storage, i, SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE);
+        sysbvm_hashtableControl_create(context, &result->controlBytes, requiredStorageCapacity);
     }
 
     return (sysbvm_tuple_t)result;
@@ -444,13 +634,19 @@ static intptr_t sysbvm_identityDictionary_scanFor(sysbvm_tuple_t dictionary, sys
     if(!sysbvm_tuple_isNonNullPointer(dictionary))
         return -1;
 
-    sysbvm_dictionary_t *dictionaryObject = (sysbvm_dictionary_t*)dictionary;
-    size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage);
+    sysbvm_identityDictionary_t *dictionaryObject = (sysbvm_identityDictionary_t*)dictionary;
+    size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->super.storage);
     if(capacity == 0)
         return -1;
 
-    sysbvm_array_t *storage = (sysbvm_array_t*)dictionaryObject->storage;
-    size_t hashIndex = sysbvm_tuple_identityHash(element) % capacity;
+    // The control bytes avoid loading the associations whose key has a different hash.
+    sysbvm_array_t *storage = (sysbvm_array_t*)dictionaryObject->super.storage;
+    size_t hash = sysbvm_tuple_identityHash(element);
+    const uint8_t *controlBytes = sysbvm_hashtableControl_getValidBytes(dictionaryObject->controlBytes, capacity, sysbvm_tuple_size_decode(dictionaryObject->super.size));
+    if(controlBytes)
+        return sysbvm_hashtableControl_scanFor(controlBytes, capacity, hash, storage->elements, 1, true, element);
+
+    size_t hashIndex = hash % capacity;
     for(size_t i = hashIndex; i < capacity; ++i)
     {
         sysbvm_tuple_t association = storage->elements[i];
@@ -537,6 +733,8 @@ static void sysbvm_identityDictionary_increaseCapacity(sysbvm_context_t *context
         if(association)
             sysbvm_identityDictionary_insertNoCheck(dictionary, association);
     }
+
+    sysbvm_hashtableControl_rebuild(context, &((sysbvm_identityDictionary_t*)dictionary)->controlBytes, newCapacity, newStorage->elements, 1, true, SYSBVM_NULL_TUPLE);
 }
 
 SYSBVM_API void sysbvm_identityDictionary_add(sysbvm_context_t *context, sysbvm_tuple_t dictionary, sysbvm_tuple_t association)
@@ -566,6 +764,7 @@ SYSBVM_API void sysbvm_identityDictionary_add(sysbvm_context_t *context, sysbvm_
         size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage);
         size_t newSize = sysbvm_tuple_size_decode(dictionaryObject->size) + 1;
         dictionaryObject->size = sysbvm_tuple_size_encode(context, newSize);
+        sysbvm_hashtableControl_insertedElement(context, &((sysbvm_identityDictionary_t*)dictionary)->controlBytes, capacity, newSize - 1, elementIndex, key, storage->elements, 1, true, SYSBVM_NULL_TUPLE);
         size_t capacityThreshold = capacity * 4 / 5;
 
         // Make sure the maximum occupancy rate is not greater than 80%.
@@ -600,6 +799,7 @@ SYSBVM_API void sysbvm_identityDictionary_atPut(sysbvm_context_t *context, sysbv
         size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage);
         size_t newSize = sysbvm_tuple_size_decode(dictionaryObject->size) + 1;
         dictionaryObject->size = sysbvm_tuple_size_encode(context, newSize);
+        sysbvm_hashtableControl_insertedElement(context, &((sysbvm_identityDictionary_t*)dictionary)->controlBytes, capacity, newSize - 1, elementIndex, key, storage->elements, 1, true, SYSBVM_NULL_TUPLE);
         size_t capacityThreshold = capacity * 4 / 5;
 
         // Make sure the maximum occupancy rate is not greater than 80%.
@@ -613,13 +813,18 @@ static intptr_t sysbvm_methodDictionary_scanFor(sysbvm_tuple_t dictionary, sysbv
     if(!sysbvm_tuple_isNonNullPointer(dictionary))
         return -1;
 
-    sysbvm_dictionary_t *dictionaryObject = (sysbvm_dictionary_t*)dictionary;
+    sysbvm_methodDictionary_t *dictionaryObject = (sysbvm_methodDictionary_t*)dictionary;
     size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage) / 2;
     if(capacity == 0)
         return -1;
 
     sysbvm_array_t *storage = (sysbvm_array_t*)dictionaryObject->storage;
-    size_t hashIndex = sysbvm_tuple_identityHash(element) % capacity;
+    size_t hash = sysbvm_tuple_identityHash(element);
+    const uint8_t *controlBytes = sysbvm_hashtableControl_getValidBytes(dictionaryObject->controlBytes, capacity, sysbvm_tuple_size_decode(dictionaryObject->size));
+    if(controlBytes)
+        return sysbvm_hashtableControl_scanFor(controlBytes, capacity, hash, storage->elements, 2, false, element);
+
+    size_t hashIndex = hash % capacity;
     for(size_t i = hashIndex; i < capacity; ++i)
     {
         sysbvm_tuple_t dictionaryKey = storage->elements[i*2];
@@ -691,6 +896,8 @@ static void sysbvm_methodDictionary_increaseCapacity(sysbvm_context_t *context,
         if(key != SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE)
             sysbvm_methodDictionary_insertNoCheck(dictionary, key, value);
     }
+
+    sysbvm_hashtableControl_rebuild(context, &((sysbvm_methodDictionary_t*)dictionary)->controlBytes, newCapacity, newStorage->elements, 2, false, SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE);
 }
 
 SYSBVM_API void sysbvm_methodDictionary_atPut(sysbvm_context_t *context, sysbvm_tuple_t dictionary, sysbvm_tuple_t key, sysbvm_tuple_t value)
@@ -710,7 +917,7 @@ SYSBVM_API void sysbvm_methodDictionary_atPut(sysbvm_context_t *context, sysbvm_
            sysbvm_error("Dictionary out of memory.");
     }
 
-    sysbvm_dictionary_t *dictionaryObject = (sysbvm_dictionary_t*)dictionary;
+    sysbvm_methodDictionary_t *dictionaryObject = (sysbvm_methodDictionary_t*)dictionary;
     sysbvm_array_t *storage = (sysbvm_array_t*)dictionaryObject->storage;
     bool isNewElement = storage->elements[elementIndex*2] == SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE;
     storage->elements[elementIndex*2] = key;
@@ -722,11 +929,15 @@ SYSBVM_API void sysbvm_methodDictionary_atPut(sysbvm_context_t *context, sysbvm_
         size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage) / 2;
         size_t newSize = sysbvm_tuple_size_decode(dictionaryObject->size) + 1;
         dictionaryObject->size = sysbvm_tuple_size_encode(context, newSize);
+        sysbvm_hashtableControl_insertedElement(context, &dictionaryObject->controlBytes, capacity, newSize - 1, elementIndex, key, storage->elements, 2, false, SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE);
         size_t capacityThreshold = capacity * 3 / 4;
 
         // Make sure the maximum occupancy rate is not greater than 80%.
         if(newSize >= capacityThreshold)
             sysbvm_methodDictionary_increaseCapacity(context, dictionary);
+
+        // A new selector invalidates the cached failed method lookups.
+        atomic_fetch_add_explicit(&context->methodDictionaryEpoch, 1, memory_order_release);
     }
 }
 
@@ -312,6 +312,50 @@ SYSBVM_API void sysbvm_dwarf_cfi_endPrologue(sysbvm_dwarf_cfi_builder_t *cfi)
     cfi->isInPrologue = false;
 }
 
+SYSBVM_API void sysbvm_dwarf_cfi_restoreRegister(sysbvm_dwarf_cfi_builder_t *cfi, uintptr_t reg)
+{
+    if(reg <= 63) {
+        sysbvm_dwarf_encodeByte(&cfi->buffer, (DW_OP_CFA_restore << 6) | (uint8_t)reg);
+    } else {
+        sysbvm_dwarf_encodeByte(&cfi->buffer, DW_OP_CFA_restore_extended);
+        sysbvm_dwarf_encodeULEB128(&cfi->buffer, reg);
+    }
+}
+
+SYSBVM_API void sysbvm_dwarf_cfi_beginSecondaryPrologue(sysbvm_dwarf_cfi_builder_t *cfi, size_t pc)
+{
+    SYSBVM_ASSERT(!cfi->isInPrologue);
+
+    // A secondary entry point placed after the body starts again from the state at the function entry.
+    sysbvm_dwarf_cfi_setPC(cfi, pc);
+    sysbvm_dwarf_encodeByte(&cfi->buffer, DW_OP_CFA_remember_state);
+    cfi->rememberedStackFrameSize = cfi->stackFrameSize;
+    cfi->rememberedFramePointerRegister = cfi->framePointerRegister;
+    cfi->rememberedStackFrameSizeAtFramePointer = cfi->stackFrameSizeAtFramePointer;
+    cfi->rememberedHasFramePointerRegister = cfi->hasFramePointerRegister;
+
+    cfi->stackFrameSize = cfi->initialStackFrameSize;
+    cfi->framePointerRegister = 0;
+    cfi->stackFrameSizeAtFramePointer = 0;
+    cfi->hasFramePointerRegister = false;
+    cfi->isInPrologue = true;
+    sysbvm_dwarf_cfi_cfaInRegisterWithFactoredOffset(cfi, cfi->stackPointerRegister, cfi->stackFrameSize);
+}
+
+SYSBVM_API void sysbvm_dwarf_cfi_endSecondaryPrologue(sysbvm_dwarf_cfi_builder_t *cfi, size_t pc)
+{
+    SYSBVM_ASSERT(cfi->isInPrologue);
+
+    // The secondary prologue ends with the same frame as the regular one.
+    sysbvm_dwarf_cfi_setPC(cfi, pc);
+    sysbvm_dwarf_encodeByte(&cfi->buffer, DW_OP_CFA_restore_state);
+    cfi->stackFrameSize = cfi->rememberedStackFrameSize;
+    cfi->framePointerRegister = cfi->rememberedFramePointerRegister;
+    cfi->stackFrameSizeAtFramePointer = cfi->rememberedStackFrameSizeAtFramePointer;
+    cfi->hasFramePointerRegister = cfi->rememberedHasFramePointerRegister;
+    cfi->isInPrologue = false;
+}
+
 SYSBVM_API void sysbvm_dwarf_debugInfo_create(sysbvm_dwarf_debugInfo_builder_t *builder)
 {
     memset(builder, 0, sizeof(sysbvm_dwarf_debugInfo_builder_t));
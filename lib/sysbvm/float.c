@@ -2,6 +2,7 @@
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
 #include "sysbvm/string.h"
+#include "sysbvm/stringStream.h"
 #include "sysbvm/type.h"
 #include "internal/context.h"
 #include <string.h>
@@ -134,6 +135,20 @@ static sysbvm_tuple_t sysbvm_float32_primitive_printString(sysbvm_context_t *con
         return sysbvm_string_createWithString(context, stringSize, buffer);
 }
 
+static sysbvm_tuple_t sysbvm_float32_primitive_printOn(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    char buffer[32] = {0};
+    sysbvm_float32_t value = sysbvm_tuple_float32_decode(arguments[0]);
+
+    int stringSize = snprintf(buffer, sizeof(buffer), "%g", value);
+    if(stringSize > 0)
+        sysbvm_stream_nextPutStringWithSize(context, arguments[1], stringSize, buffer);
+    return SYSBVM_VOID_TUPLE;
+}
+
 static sysbvm_tuple_t sysbvm_float32_primitive_fromFloat64(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
 {
     (void)context;
@@ -430,6 +445,20 @@ static sysbvm_tuple_t sysbvm_float64_primitive_printString(sysbvm_context_t *con
         return sysbvm_string_createWithString(context, stringSize, buffer);
 }
 
+static sysbvm_tuple_t sysbvm_float64_primitive_printOn(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    char buffer[32] = {0};
+    sysbvm_float64_t value = sysbvm_tuple_float64_decode(arguments[0]);
+
+    int stringSize = snprintf(buffer, sizeof(buffer), "%g", value);
+    if(stringSize > 0)
+        sysbvm_stream_nextPutStringWithSize(context, arguments[1], stringSize, buffer);
+    return SYSBVM_VOID_TUPLE;
+}
+
 static sysbvm_tuple_t sysbvm_float64_primitive_fromFloat32(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
 {
     (void)context;
@@ -715,6 +744,7 @@ void sysbvm_float_registerPrimitives(void)
     // Float32
     sysbvm_primitiveTable_registerFunction(sysbvm_float32_primitive_parseString, "Float32::parseString");
     sysbvm_primitiveTable_registerFunction(sysbvm_float32_primitive_printString, "Float32::printString");
+    sysbvm_primitiveTable_registerFunction(sysbvm_float32_primitive_printOn, "Float32::printOn:");
     sysbvm_primitiveTable_registerFunction(sysbvm_float32_primitive_fromFloat64, "Float32::fromFloat64");
 
     sysbvm_primitiveTable_registerFunction(sysbvm_float32_primitive_add, "Float32::+");
@@ -750,6 +780,7 @@ void sysbvm_float_registerPrimitives(void)
     // Float64
     sysbvm_primitiveTable_registerFunction(sysbvm_float64_primitive_parseString, "Float64::parseString");
     sysbvm_primitiveTable_registerFunction(sysbvm_float64_primitive_printString, "Float64::printString");
+    sysbvm_primitiveTable_registerFunction(sysbvm_float64_primitive_printOn, "Float64::printOn:");
     sysbvm_primitiveTable_registerFunction(sysbvm_float64_primitive_fromFloat32, "Float64::fromFloat32");
 
     sysbvm_primitiveTable_registerFunction(sysbvm_float64_primitive_add, "Float64::+");
@@ -787,6 +818,7 @@ void sysbvm_float_setupPrimitives(sysbvm_context_t *context)
 {
     // Float32
     sysbvm_type_setPrintStringFunction(context, context->roots.float32Type, sysbvm_function_createPrimitive(context, 1, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float32_primitive_printString));
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.float32Type, "printOn:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float32_primitive_printOn);
 
     sysbvm_context_setIntrinsicPrimitiveMethod(context, sysbvm_tuple_getType(context, context->roots.float32Type), "parseString:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float32_primitive_parseString);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.float64Type, "f32", 1, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float32_primitive_fromFloat64);
@@ -825,6 +857,7 @@ void sysbvm_float_setupPrimitives(sysbvm_context_t *context)
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.float32Type, "asFloat64", 1, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float64_primitive_fromFloat32);
 
     sysbvm_type_setPrintStringFunction(context, context->roots.float64Type, sysbvm_function_createPrimitive(context, 1, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float64_primitive_printString));
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.float64Type, "printOn:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float64_primitive_printOn);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, sysbvm_tuple_getType(context, context->roots.float64Type), "parseString:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float64_primitive_parseString);
 
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.float64Type, "+", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_float64_primitive_add);
@@ -602,6 +602,10 @@ static sysbvm_tuple_t sysbvm_function_primitive_adoptDefinitionOf(sysbvm_context
     sysbvm_function_t **functionObject = (sysbvm_function_t**)function;
     sysbvm_function_t **definitionFunctionObject = (sysbvm_function_t**)definitionFunction;
 
+    // The jitted code that calls this function directly must find its new definition.
+    if((*functionObject)->definition && (*functionObject)->definition != (*definitionFunctionObject)->definition)
+        sysbvm_functionBytecode_unlinkJittedCode(context, ((sysbvm_functionDefinition_t*)(*functionObject)->definition)->bytecode);
+
     (*functionObject)->definition = (*definitionFunctionObject)->definition;
     (*functionObject)->captureVector = (*definitionFunctionObject)->captureVector;
     (*functionObject)->captureEnvironment = (*definitionFunctionObject)->captureEnvironment;
@@ -4,6 +4,9 @@
 #include "internal/context.h"
 #include <stdio.h>
 
+extern void sysbvm_symbol_releaseRetiredTables(sysbvm_context_t *context);
+extern void sysbvm_string_flushHashCache(sysbvm_context_t *context);
+
 SYSBVM_THREAD_LOCAL uint32_t sysbvm_gc_perThreadLockCount;
 
 static void sysbvm_gc_markPointer(void *userdata, sysbvm_tuple_t *pointerAddress)
@@ -63,6 +66,64 @@ static void sysbvm_gc_markUntilStackIsEmpty(sysbvm_context_t *context)
     }
 }
 
+static void sysbvm_gc_iteratePICReferences(sysbvm_pic_t *pic, void *userdata, sysbvm_GCRootIterationFunction_t iterationFunction)
+{
+    for(size_t i = 0; i < SYSBVM_PIC_ENTRY_COUNT; ++i)
+    {
+        sysbvm_picEntry_t *picEntry = pic->entries + i;
+        iterationFunction(userdata, &picEntry->selector);
+        iterationFunction(userdata, &picEntry->type);
+        iterationFunction(userdata, &picEntry->method);
+    }
+
+    iterationFunction(userdata, &pic->inlineCacheEntry.selector);
+    iterationFunction(userdata, &pic->inlineCacheEntry.type);
+    iterationFunction(userdata, &pic->inlineCacheEntry.method);
+    iterationFunction(userdata, &pic->inlineCacheEntryPointOwner);
+    iterationFunction(userdata, &pic->dependencySelector);
+}
+
+static void sysbvm_gc_markCodeBlockReferences(sysbvm_context_t *context)
+{
+    // The references of a code block are only kept alive by its owner, which may itself only be reachable through the references of another code block.
+    bool hasMarkedObjects = true;
+    while(hasMarkedObjects)
+    {
+        hasMarkedObjects = false;
+        for(sysbvm_heap_codeBlock_t *codeBlock = context->heap.firstCodeBlock; codeBlock; codeBlock = codeBlock->next)
+        {
+            if(sysbvm_tuple_isNonNullPointer(codeBlock->owner) && sysbvm_tuple_getGCColor(codeBlock->owner) == context->heap.gcWhiteColor)
+                continue;
+
+            sysbvm_gc_markPointer(context, &codeBlock->literalVector);
+            sysbvm_tuple_t *retainedObjects = (sysbvm_tuple_t*)codeBlock->retainedObjects.data;
+            for(size_t i = 0; i < codeBlock->retainedObjects.size; ++i)
+                sysbvm_gc_markPointer(context, retainedObjects + i);
+
+            sysbvm_pic_t **pics = (sysbvm_pic_t**)codeBlock->pics.data;
+            for(size_t i = 0; i < codeBlock->pics.size; ++i)
+                sysbvm_gc_iteratePICReferences(pics[i], context, sysbvm_gc_markPointer);
+
+            if(context->markingStack.size > 0)
+            {
+                sysbvm_gc_markUntilStackIsEmpty(context);
+                hasMarkedObjects = true;
+            }
+        }
+    }
+}
+
+static void sysbvm_gc_releaseDeadCodeBlocks(sysbvm_context_t *context)
+{
+    sysbvm_heap_codeBlock_t *codeBlock = context->heap.firstCodeBlock;
+    while(codeBlock)
+    {
+        sysbvm_heap_codeBlock_t *nextCodeBlock = codeBlock->next;
+        if(sysbvm_tuple_isNonNullPointer(codeBlock->owner) && sysbvm_tuple_getGCColor(codeBlock->owner) == context->heap.gcWhiteColor)
+            sysbvm_heap_destroyCodeBlock(&context->heap, codeBlock);
+        codeBlock = nextCodeBlock;
+    }
+}
 
 SYSBVM_API void sysbvm_gc_collect(sysbvm_context_t *context)
 {
@@ -79,15 +140,23 @@ static void sysbvm_gc_performCycle(sysbvm_context_t *context)
     // Phase 1: marking phase
     sysbvm_gc_iterateRoots(context, context, sysbvm_gc_markPointer);
     sysbvm_gc_markUntilStackIsEmpty(context);
+    sysbvm_gc_markCodeBlockReferences(context);
 
     // Phase 2: Replace the weak references with their tombstones.
     sysbvm_heap_replaceWeakReferencesWithTombstones(&context->heap);
 
-    // Phase 3: Sweep
+    // Phase 3: Release the code of the dead functions, and sweep.
+    sysbvm_gc_releaseDeadCodeBlocks(context);
     sysbvm_heap_sweep(&context->heap);
 
     // Phase 4: Swap the GC colors.
     sysbvm_heap_swapGCColors(&context->heap);
+
+    // Phase 5: Release the replaced symbol tables. No lookup can be traversing them at a safepoint.
+    sysbvm_symbol_releaseRetiredTables(context);
+
+    // Phase 6: Flush the string hashes that are keyed by address.
+    sysbvm_string_flushHashCache(context);
 }
 
 SYSBVM_API void sysbvm_gc_safepoint(sysbvm_context_t *context)
@@ -147,7 +216,7 @@ SYSBVM_API void sysbvm_gc_iterateRoots(sysbvm_context_t *context, void *userdata
         }
     }
 
-    // PIC table
+    // PIC table. The PICs of the jitted code are owned by their code block instead.
     {
         sysbvm_chunkedAllocatorIterator_t iterator;
         for(sysbvm_chunkedAllocatorIterator_begin(&context->heap.picTableAllocator, &iterator);
@@ -157,19 +226,30 @@ SYSBVM_API void sysbvm_gc_iterateRoots(sysbvm_context_t *context, void *userdata
             size_t picCount = iterator.size / sizeof(sysbvm_pic_t);
             sysbvm_pic_t *pics = (sysbvm_pic_t*)iterator.data;
             for(size_t i = 0; i < picCount; ++i)
-            {
-                sysbvm_pic_t *pic = pics + i;
-                for(size_t j = 0; j < SYSBVM_PIC_ENTRY_COUNT; ++j)
-                {
-                    sysbvm_picEntry_t *picEntry = pic->entries + j;
-                    iterationFunction(userdata, &picEntry->selector);
-                    iterationFunction(userdata, &picEntry->type);
-                    iterationFunction(userdata, &picEntry->method);
-                }
-            }
+                sysbvm_gc_iteratePICReferences(pics + i, userdata, iterationFunction);
         }
     }
 
+    // Global method lookup cache
+    for(size_t i = 0; i < context->globalMethodLookupCacheSetCount; ++i)
+    {
+        sysbvm_globalLookupCacheSet_t *cacheSet = context->globalMethodLookupCache + i;
+        for(size_t j = 0; j < GLOBAL_LOOKUP_CACHE_WAY_COUNT; ++j)
+        {
+            sysbvm_globalLookupCacheEntry_t *cacheEntry = cacheSet->entries + j;
+            iterationFunction(userdata, &cacheEntry->type);
+            iterationFunction(userdata, &cacheEntry->selector);
+            iterationFunction(userdata, &cacheEntry->method);
+        }
+    }
+
+    // Interned symbol index
+    {
+        sysbvm_symbolTable_t *symbolTable = atomic_load_explicit(&context->symbolTable, memory_order_relaxed);
+        for(size_t i = 0; symbolTable && i < symbolTable->capacity; ++i)
+            iterationFunction(userdata, (sysbvm_tuple_t*)&symbolTable->entries[i].symbol);
+    }
+
     // Stack roots.
     sysbvm_stackFrame_iterateGCRootsInStackWith(sysbvm_stackFrame_getActiveRecord(), userdata, iterationFunction);
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include "sysbvm/gdb.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
 #ifdef _MSC_VER
 #define SYSBVM_NOINLINE __declspec(noinline)
 #else
@@ -48,3 +54,31 @@ SYSBVM_API void sysbvm_gdb_unregisterObjectFile(sysbvm_gdb_jit_code_entry_t *ent
     __jit_debug_descriptor.action_flag = SYSBVM_GDB_JIT_UNREGISTER_FN;
     __jit_debug_register_code();
 }
+
+SYSBVM_API bool sysbvm_gdb_isDebuggerAttached(void)
+{
+#if defined(_WIN32)
+    return IsDebuggerPresent();
+#elif defined(__linux__)
+    FILE *statusFile = fopen("/proc/self/status", "r");
+    if(!statusFile)
+        return false;
+
+    // The tracer pid is zero when no debugger is attached.
+    char line[256];
+    int tracerPid = 0;
+    while(fgets(line, sizeof(line), statusFile))
+    {
+        if(!strncmp(line, "TracerPid:", 10))
+        {
+            tracerPid = atoi(line + 10);
+            break;
+        }
+    }
+
+    fclose(statusFile);
+    return tracerPid != 0;
+#else
+    return false;
+#endif
+}
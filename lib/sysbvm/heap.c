@@ -1,16 +1,33 @@
 #include "internal/heap.h"
 #include "internal/virtualMemory.h"
 #include "sysbvm/assert.h"
+#include "sysbvm/gdb.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+extern void __deregister_frame(const void*);
+#endif
+
 #define SYSBVM_HEAP_MIN_CHUNK_SIZE (2<<20)
 #define SYSBVM_HEAP_STARTUP_HEAP_SIZE (SYSBVM_HEAP_MIN_CHUNK_SIZE*4)
 #define SYSBVM_HEAP_COLLECTION_GAMMA_FACTOR 3
 
 #define SYSBVM_HEAP_CODE_ZONE_SIZE (16<<20)
 
+#define SYSBVM_HEAP_CODE_ALLOCATION_GRANULARITY 16
+#define SYSBVM_HEAP_CODE_MIN_ALLOCATION_SIZE 32
+#define SYSBVM_HEAP_CODE_MIN_SPLIT_SIZE 128
+
+// A buffer is only released when all of its objects are dead, so it is kept small to bound the space retained by a few survivors.
+#define SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE (8<<10)
+#define SYSBVM_HEAP_ALLOCATION_BUFFER_MAX_OBJECT_SIZE (1<<10)
+
 static void sysbvm_heap_checkForGCThreshold(sysbvm_heap_t *heap)
 {
     if(heap->shouldAttemptToCollect)
@@ -22,6 +39,83 @@ static void sysbvm_heap_checkForGCThreshold(sysbvm_heap_t *heap)
     //    printf("heap->shouldAttemptToCollect %zu > %zu | %zu\n", heap->totalSize, heap->nextGCSizeThreshold, heap->totalCapacity);
 }
 
+static void sysbvm_heap_linkObject(sysbvm_heap_t *heap, sysbvm_heap_mallocObjectHeader_t *objectHeader)
+{
+    if(heap->firstMallocObject)
+    {
+        heap->lastMallocObject->next = objectHeader;
+        heap->lastMallocObject = objectHeader;
+    }
+    else
+    {
+        heap->firstMallocObject = heap->lastMallocObject = objectHeader;
+    }
+}
+
+static void sysbvm_heap_releaseAllocationBuffer(sysbvm_heap_t *heap, sysbvm_heap_allocationBuffer_t *buffer)
+{
+    SYSBVM_ASSERT(heap->totalSize >= SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE);
+    heap->totalSize -= SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE;
+    free(buffer);
+}
+
+static void sysbvm_heap_freeObject(sysbvm_heap_t *heap, sysbvm_heap_mallocObjectHeader_t *objectHeader)
+{
+    if(!objectHeader->allocationBufferOffset)
+    {
+        SYSBVM_ASSERT(heap->totalSize >= objectHeader->size);
+        heap->totalSize -= objectHeader->size;
+        free(objectHeader);
+        return;
+    }
+
+    // Objects from an allocation buffer are released together with their buffer.
+    sysbvm_heap_allocationBuffer_t *buffer = (sysbvm_heap_allocationBuffer_t*)((uintptr_t)objectHeader - objectHeader->allocationBufferOffset);
+    SYSBVM_ASSERT(buffer != heap->currentAllocationBuffer);
+    SYSBVM_ASSERT(buffer->objectCount > 0);
+    if(--buffer->objectCount == 0)
+        sysbvm_heap_releaseAllocationBuffer(heap, buffer);
+}
+
+static void sysbvm_heap_sealAllocationBuffer(sysbvm_heap_t *heap)
+{
+    sysbvm_heap_allocationBuffer_t *buffer = heap->currentAllocationBuffer;
+    if(!buffer)
+        return;
+
+    // The jitted allocation fast path does not count objects, so count them here by walking the buffer.
+    size_t objectCount = 0;
+    uintptr_t position = (uintptr_t)(buffer + 1);
+    while(position < heap->allocationBufferPosition)
+    {
+        position += ((sysbvm_heap_mallocObjectHeader_t*)position)->size;
+        ++objectCount;
+    }
+
+    heap->currentAllocationBuffer = NULL;
+    heap->allocationBufferPosition = 0;
+    heap->allocationBufferLimit = 0;
+
+    buffer->objectCount = objectCount;
+    if(objectCount == 0)
+        sysbvm_heap_releaseAllocationBuffer(heap, buffer);
+}
+
+static void sysbvm_heap_refillAllocationBuffer(sysbvm_heap_t *heap)
+{
+    sysbvm_heap_sealAllocationBuffer(heap);
+
+    sysbvm_heap_allocationBuffer_t *buffer = malloc(SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE);
+    buffer->objectCount = 0;
+    heap->currentAllocationBuffer = buffer;
+    heap->allocationBufferPosition = (uintptr_t)(buffer + 1);
+    heap->allocationBufferLimit = (uintptr_t)buffer + SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE;
+
+    // The whole buffer is retained until all of its objects are dead, so it is accounted at once for the GC threshold.
+    heap->totalSize += SYSBVM_HEAP_ALLOCATION_BUFFER_SIZE;
+    sysbvm_heap_checkForGCThreshold(heap);
+}
+
 static sysbvm_object_tuple_t *sysbvm_heap_allocateTupleWithRawSize(sysbvm_heap_t *heap, size_t allocationSize, size_t allocationAlignment)
 {
     (void)allocationAlignment;
@@ -32,15 +126,8 @@ static sysbvm_object_tuple_t *sysbvm_heap_allocateTupleWithRawSize(sysbvm_heap_t
     sysbvm_heap_mallocObjectHeader_t *resultHeader = malloc(allocationWithHeaderSize);
     resultHeader->next = NULL;
     resultHeader->size = allocationWithHeaderSize;
-    if(heap->firstMallocObject)
-    {
-        heap->lastMallocObject->next = resultHeader;
-        heap->lastMallocObject = resultHeader;
-    }
-    else
-    {
-        heap->firstMallocObject = heap->lastMallocObject = resultHeader;
-    }
+    resultHeader->allocationBufferOffset = 0;
+    sysbvm_heap_linkObject(heap, resultHeader);
 
     result = (sysbvm_object_tuple_t *)((uintptr_t)resultHeader + 16);
     heap->totalSize += allocationWithHeaderSize;
@@ -50,6 +137,28 @@ static sysbvm_object_tuple_t *sysbvm_heap_allocateTupleWithRawSize(sysbvm_heap_t
     return result;
 }
 
+static sysbvm_object_tuple_t *sysbvm_heap_allocateTupleInAllocationBufferWithRawSize(sysbvm_heap_t *heap, size_t allocationSize)
+{
+    SYSBVM_ASSERT(allocationSize >= sizeof(sysbvm_object_tuple_t));
+    size_t allocationWithHeaderSize = (sizeof(sysbvm_heap_mallocObjectHeader_t) + allocationSize + 15) & (~(size_t)15);
+    if(allocationWithHeaderSize > SYSBVM_HEAP_ALLOCATION_BUFFER_MAX_OBJECT_SIZE)
+        return sysbvm_heap_allocateTupleWithRawSize(heap, allocationSize, 16);
+
+    if(heap->allocationBufferPosition + allocationWithHeaderSize > heap->allocationBufferLimit)
+        sysbvm_heap_refillAllocationBuffer(heap);
+
+    sysbvm_heap_mallocObjectHeader_t *resultHeader = (sysbvm_heap_mallocObjectHeader_t*)heap->allocationBufferPosition;
+    heap->allocationBufferPosition += allocationWithHeaderSize;
+    resultHeader->next = NULL;
+    resultHeader->size = allocationWithHeaderSize;
+    resultHeader->allocationBufferOffset = (uint32_t)((uintptr_t)resultHeader - (uintptr_t)heap->currentAllocationBuffer);
+    sysbvm_heap_linkObject(heap, resultHeader);
+
+    sysbvm_object_tuple_t *result = (sysbvm_object_tuple_t *)(resultHeader + 1);
+    memset(result, 0, allocationWithHeaderSize - sizeof(sysbvm_heap_mallocObjectHeader_t));
+    return result;
+}
+
 SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocateByteTuple(sysbvm_heap_t *heap, size_t byteSize)
 {
     size_t allocationSize = sizeof(sysbvm_object_tuple_t) + byteSize;
@@ -73,6 +182,29 @@ SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocatePointerTuple(sysbvm_heap_t
     return result;
 }
 
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocateByteTupleInAllocationBuffer(sysbvm_heap_t *heap, size_t byteSize)
+{
+    size_t allocationSize = sizeof(sysbvm_object_tuple_t) + byteSize;
+    sysbvm_object_tuple_t *result = sysbvm_heap_allocateTupleInAllocationBufferWithRawSize(heap, allocationSize);
+    if(!result) return 0;
+
+    result->header.identityHashAndFlags = (SYSBVM_TUPLE_OBJECT_KIND_BYTES << SYSBVM_TUPLE_OBJECT_KIND_SHIFT) | (heap->gcWhiteColor << SYSBVM_TUPLE_GC_COLOR_SHIFT);
+    result->header.objectSize = byteSize;
+    return result;
+}
+
+SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_allocatePointerTupleInAllocationBuffer(sysbvm_heap_t *heap, size_t slotCount)
+{
+    size_t objectSize = slotCount*sizeof(sysbvm_object_tuple_t*);
+    size_t allocationSize = sizeof(sysbvm_object_tuple_t) + objectSize;
+    sysbvm_object_tuple_t *result = sysbvm_heap_allocateTupleInAllocationBufferWithRawSize(heap, allocationSize);
+    if(!result) return 0;
+
+    result->header.identityHashAndFlags = (SYSBVM_TUPLE_OBJECT_KIND_POINTERS << SYSBVM_TUPLE_OBJECT_KIND_SHIFT) | (heap->gcWhiteColor << SYSBVM_TUPLE_GC_COLOR_SHIFT);
+    result->header.objectSize = objectSize;
+    return result;
+}
+
 sysbvm_tuple_t *sysbvm_heap_allocateGCRootTableEntry(sysbvm_heap_t *heap)
 {
     sysbvm_tuple_t *result = sysbvm_chunkedAllocator_allocate(&heap->gcRootTableAllocator, sizeof(sysbvm_tuple_t), sizeof(sysbvm_tuple_t));
@@ -80,6 +212,170 @@ sysbvm_tuple_t *sysbvm_heap_allocateGCRootTableEntry(sysbvm_heap_t *heap)
     return result;
 }
 
+static size_t sysbvm_heap_alignedCodeSize(size_t size)
+{
+    if(size < SYSBVM_HEAP_CODE_MIN_ALLOCATION_SIZE)
+        return SYSBVM_HEAP_CODE_MIN_ALLOCATION_SIZE;
+    return (size + SYSBVM_HEAP_CODE_ALLOCATION_GRANULARITY - 1) & (~(size_t)(SYSBVM_HEAP_CODE_ALLOCATION_GRANULARITY - 1));
+}
+
+static size_t sysbvm_heap_codeFreeListIndexForSize(size_t size)
+{
+    size_t index = 0;
+    size_t classSize = SYSBVM_HEAP_CODE_MIN_ALLOCATION_SIZE*2;
+    while(index + 1 < SYSBVM_HEAP_CODE_FREE_LIST_COUNT && size >= classSize)
+    {
+        ++index;
+        classSize <<= 1;
+    }
+
+    return index;
+}
+
+static void sysbvm_heap_releaseCodeSpan(sysbvm_heap_t *heap, uint8_t *writeableMapping, uint8_t *executableMapping, size_t size)
+{
+    // Poison the released code with int3, so that a stale jump into it traps.
+    memset(writeableMapping, 0xcc, size);
+
+    sysbvm_heap_freeCodeSpan_t *span = (sysbvm_heap_freeCodeSpan_t*)writeableMapping;
+    span->executableMapping = executableMapping;
+    span->size = size;
+
+    size_t freeListIndex = sysbvm_heap_codeFreeListIndexForSize(size);
+    span->next = heap->codeFreeLists[freeListIndex];
+    heap->codeFreeLists[freeListIndex] = span;
+    heap->codeFreeSize += size;
+}
+
+static bool sysbvm_heap_allocateCodeFromFreeLists(sysbvm_heap_t *heap, size_t *allocationSize, uint8_t **writeableMapping, uint8_t **executableMapping)
+{
+    size_t size = *allocationSize;
+
+    // First fit in the size class, and then take any span from the larger classes.
+    size_t freeListIndex = sysbvm_heap_codeFreeListIndexForSize(size);
+    sysbvm_heap_freeCodeSpan_t **spanLink = &heap->codeFreeLists[freeListIndex];
+    while(*spanLink && (*spanLink)->size < size)
+        spanLink = &(*spanLink)->next;
+
+    while(!*spanLink && ++freeListIndex < SYSBVM_HEAP_CODE_FREE_LIST_COUNT)
+        spanLink = &heap->codeFreeLists[freeListIndex];
+
+    sysbvm_heap_freeCodeSpan_t *span = *spanLink;
+    if(!span)
+        return false;
+
+    *spanLink = span->next;
+    heap->codeFreeSize -= span->size;
+
+    uint8_t *spanWriteableMapping = (uint8_t*)span;
+    uint8_t *spanExecutableMapping = span->executableMapping;
+    size_t spanSize = span->size;
+    if(spanSize - size >= SYSBVM_HEAP_CODE_MIN_SPLIT_SIZE)
+        sysbvm_heap_releaseCodeSpan(heap, spanWriteableMapping + size, spanExecutableMapping + size, spanSize - size);
+    else
+        size = spanSize;
+
+    *allocationSize = size;
+    *writeableMapping = spanWriteableMapping;
+    *executableMapping = spanExecutableMapping;
+    return true;
+}
+
+sysbvm_heap_codeBlock_t *sysbvm_heap_createCodeBlock(sysbvm_heap_t *heap, sysbvm_tuple_t owner)
+{
+    sysbvm_heap_codeBlock_t *codeBlock = (sysbvm_heap_codeBlock_t*)calloc(1, sizeof(sysbvm_heap_codeBlock_t));
+    codeBlock->owner = owner;
+    sysbvm_dynarray_initialize(&codeBlock->retainedObjects, sizeof(sysbvm_tuple_t), 0);
+    sysbvm_dynarray_initialize(&codeBlock->pics, sizeof(sysbvm_pic_t*), 0);
+
+    codeBlock->previous = heap->lastCodeBlock;
+    if(heap->lastCodeBlock)
+        heap->lastCodeBlock->next = codeBlock;
+    else
+        heap->firstCodeBlock = codeBlock;
+    heap->lastCodeBlock = codeBlock;
+    return codeBlock;
+}
+
+void sysbvm_heap_addCodeBlockRetainedObject(sysbvm_heap_codeBlock_t *codeBlock, sysbvm_tuple_t object)
+{
+    if(!sysbvm_tuple_isNonNullPointer(object) || object == codeBlock->owner)
+        return;
+
+    sysbvm_tuple_t *retainedObjects = (sysbvm_tuple_t*)codeBlock->retainedObjects.data;
+    for(size_t i = 0; i < codeBlock->retainedObjects.size; ++i)
+    {
+        if(retainedObjects[i] == object)
+            return;
+    }
+
+    sysbvm_dynarray_add(&codeBlock->retainedObjects, &object);
+}
+
+sysbvm_pic_t *sysbvm_heap_createCodeBlockPIC(sysbvm_heap_codeBlock_t *codeBlock)
+{
+    sysbvm_pic_t *pic = (sysbvm_pic_t*)calloc(1, sizeof(sysbvm_pic_t));
+    sysbvm_dynarray_add(&codeBlock->pics, &pic);
+    return pic;
+}
+
+void sysbvm_heap_allocateCodeBlockMemory(sysbvm_heap_t *heap, sysbvm_heap_codeBlock_t *codeBlock, size_t size)
+{
+    SYSBVM_ASSERT(!codeBlock->writeableMapping);
+
+    size = sysbvm_heap_alignedCodeSize(size);
+    if(!sysbvm_heap_allocateCodeFromFreeLists(heap, &size, &codeBlock->writeableMapping, &codeBlock->executableMapping))
+        sysbvm_chunkedAllocator_allocateWithDualMapping(&heap->codeAllocator, size, SYSBVM_HEAP_CODE_ALLOCATION_GRANULARITY, (void**)&codeBlock->writeableMapping, (void**)&codeBlock->executableMapping);
+
+    codeBlock->size = size;
+    heap->codeSize += size;
+}
+
+void sysbvm_heap_destroyCodeBlock(sysbvm_heap_t *heap, sysbvm_heap_codeBlock_t *codeBlock)
+{
+    if(codeBlock->gdbEntry)
+    {
+        sysbvm_gdb_unregisterObjectFile((sysbvm_gdb_jit_code_entry_t*)codeBlock->gdbEntry);
+        free(codeBlock->gdbEntry);
+    }
+
+    if(codeBlock->registeredFrame)
+    {
+#ifdef _WIN32
+        RtlDeleteFunctionTable((PRUNTIME_FUNCTION)codeBlock->registeredFrame);
+#else
+        __deregister_frame(codeBlock->registeredFrame);
+#endif
+    }
+
+    if(codeBlock->writeableMapping)
+    {
+        sysbvm_heap_releaseCodeSpan(heap, codeBlock->writeableMapping, codeBlock->executableMapping, codeBlock->size);
+        heap->codeSize -= codeBlock->size;
+    }
+
+    if(codeBlock->previous)
+        codeBlock->previous->next = codeBlock->next;
+    else
+        heap->firstCodeBlock = codeBlock->next;
+
+    if(codeBlock->next)
+        codeBlock->next->previous = codeBlock->previous;
+    else
+        heap->lastCodeBlock = codeBlock->previous;
+
+    sysbvm_pic_t **pics = (sysbvm_pic_t**)codeBlock->pics.data;
+    for(size_t i = 0; i < codeBlock->pics.size; ++i)
+    {
+        sysbvm_pic_unregisterDependencies(pics[i]);
+        free(pics[i]);
+    }
+
+    sysbvm_dynarray_destroy(&codeBlock->retainedObjects);
+    sysbvm_dynarray_destroy(&codeBlock->pics);
+    free(codeBlock);
+}
+
 SYSBVM_API sysbvm_object_tuple_t *sysbvm_heap_shallowCopyTuple(sysbvm_heap_t *heap, sysbvm_object_tuple_t *tupleToCopy)
 {
     size_t objectSize = tupleToCopy->header.objectSize;
@@ -106,13 +402,18 @@ void sysbvm_heap_initialize(sysbvm_heap_t *heap)
 
 void sysbvm_heap_destroy(sysbvm_heap_t *heap)
 {
+    // The code blocks are destroyed first, because unregistering their PICs reads the selectors.
+    while(heap->firstCodeBlock)
+        sysbvm_heap_destroyCodeBlock(heap, heap->firstCodeBlock);
+
+    sysbvm_heap_sealAllocationBuffer(heap);
     {
         sysbvm_heap_mallocObjectHeader_t *position = heap->firstMallocObject;
         while(position)
         {
             sysbvm_heap_mallocObjectHeader_t *objectToFree = position;
             position = position->next;
-            free(objectToFree);
+            sysbvm_heap_freeObject(heap, objectToFree);
         }
     }
 
@@ -159,6 +460,9 @@ void sysbvm_heap_replaceWeakReferencesWithTombstones(sysbvm_heap_t *heap)
 
 static void sysbvm_heap_performSweep(sysbvm_heap_t *heap)
 {
+    // Objects in the current allocation buffer may die, so it can not be reused after sweeping.
+    sysbvm_heap_sealAllocationBuffer(heap);
+
     sysbvm_heap_mallocObjectHeader_t *position = heap->firstMallocObject;
     heap->firstMallocObject = heap->lastMallocObject = NULL;
 
@@ -170,21 +474,11 @@ static void sysbvm_heap_performSweep(sysbvm_heap_t *heap)
         sysbvm_object_tuple_t *object = (sysbvm_object_tuple_t*) (position + 1);
         if(sysbvm_tuple_getGCColor((sysbvm_tuple_t)object) == heap->gcBlackColor)
         {
-            if(heap->firstMallocObject)
-            {
-                heap->lastMallocObject->next = position;
-                heap->lastMallocObject = position;
-            }
-            else
-            {
-                heap->firstMallocObject = heap->lastMallocObject = position;
-            }
+            sysbvm_heap_linkObject(heap, position);
         }
         else
         {
-            SYSBVM_ASSERT(heap->totalSize >= position->size);
-            heap->totalSize -= position->size;
-            free(position);
+            sysbvm_heap_freeObject(heap, position);
         }
 
         position = next;
@@ -2,8 +2,11 @@
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
 #include "sysbvm/string.h"
+#include "sysbvm/stackFrame.h"
+#include "sysbvm/stringStream.h"
 #include "sysbvm/type.h"
 #include "internal/context.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -144,7 +147,7 @@ static sysbvm_tuple_t sysbvm_integer_normalize(sysbvm_context_t *context, sysbvm
     // Counte the required number of normalized words.
     size_t wordCount = sysbvm_tuple_getSizeInBytes((sysbvm_tuple_t)integer) / 4;
     size_t normalizedWordCount = wordCount;
-    while(normalizedWordCount > 0 && integer->words[normalizedWordCount - 1])
+    while(normalizedWordCount > 0 && integer->words[normalizedWordCount - 1] == 0)
         --normalizedWordCount;
 
     // Trivial cases.
@@ -178,7 +181,7 @@ static sysbvm_tuple_t sysbvm_integer_normalize(sysbvm_context_t *context, sysbvm
     // Make a newer smaller large integer.
     sysbvm_integer_t *normalizedResult = (sysbvm_integer_t*)sysbvm_context_allocateByteTuple(context, largeIntegerType, normalizedWordCount*4);
     memcpy(normalizedResult->words, integer->words, 4*normalizedWordCount);
-    return (sysbvm_tuple_t)normalizedWordCount;
+    return (sysbvm_tuple_t)normalizedResult;
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_tuple_integer_encodeBigInt32(sysbvm_context_t *context, int32_t value)
@@ -665,7 +668,45 @@ SYSBVM_API sysbvm_tuple_t sysbvm_integer_printString(sysbvm_context_t *context,
         return sysbvm_string_createWithReversedString(context, bufferSize, buffer);
     }
 
-    return sysbvm_string_createWithCString(context, "TODO: sysbvm_integer_printString for large integer.");
+    sysbvm_decoded_integer_t decodedInteger = {0};
+    sysbvm_integer_decodeLargeOrImmediate(context, &decodedInteger, integer);
+
+    // Work on a copy of the magnitude, dividing it by 10^9 to extract nine digits at a time.
+    size_t wordCount = decodedInteger.wordCount;
+    uint32_t *words = (uint32_t*)malloc(wordCount * sizeof(uint32_t));
+    memcpy(words, decodedInteger.words, wordCount * sizeof(uint32_t));
+
+    size_t bufferCapacity = wordCount * 10 + 2;
+    char *buffer = (char*)malloc(bufferCapacity);
+    size_t bufferSize = 0;
+    while(wordCount > 0)
+    {
+        uint64_t remainder = 0;
+        for(size_t i = wordCount; i > 0; --i)
+        {
+            uint64_t dividend = (remainder << 32) | words[i - 1];
+            words[i - 1] = (uint32_t)(dividend / 1000000000u);
+            remainder = dividend % 1000000000u;
+        }
+
+        while(wordCount > 0 && words[wordCount - 1] == 0)
+            --wordCount;
+
+        // Emit all of the nine digits, except for the most significant chunk.
+        for(int digit = 0; digit < 9 && (wordCount > 0 || remainder != 0 || bufferSize == 0); ++digit)
+        {
+            buffer[bufferSize++] = '0' + (remainder % 10);
+            remainder /= 10;
+        }
+    }
+
+    if(decodedInteger.isNegative)
+        buffer[bufferSize++] = '-';
+
+    sysbvm_tuple_t result = sysbvm_string_createWithReversedString(context, bufferSize, buffer);
+    free(buffer);
+    free(words);
+    return result;
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_integer_toHexString(sysbvm_context_t *context, sysbvm_tuple_t integer)
@@ -739,6 +780,24 @@ static sysbvm_tuple_t sysbvm_integer_primitive_printString(sysbvm_context_t *con
     return sysbvm_integer_printString(context, arguments[0]);
 }
 
+static sysbvm_tuple_t sysbvm_integer_primitive_printOn(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    struct {
+        sysbvm_tuple_t stream;
+        sysbvm_tuple_t string;
+    } gcFrame = {
+        .stream = arguments[1]
+    };
+    SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
+    gcFrame.string = sysbvm_integer_printString(context, arguments[0]);
+    sysbvm_stream_nextPutString(context, gcFrame.stream, gcFrame.string);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+    return SYSBVM_VOID_TUPLE;
+}
+
 static sysbvm_tuple_t sysbvm_integer_primitive_add(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
 {
     (void)context;
@@ -869,6 +928,7 @@ void sysbvm_integer_registerPrimitives(void)
 {
     sysbvm_primitiveTable_registerFunction(sysbvm_integer_primitive_parseString, "Integer::parseString:");
     sysbvm_primitiveTable_registerFunction(sysbvm_integer_primitive_printString, "Integer::printString");
+    sysbvm_primitiveTable_registerFunction(sysbvm_integer_primitive_printOn, "Integer::printOn:");
 
     sysbvm_primitiveTable_registerFunction(sysbvm_integer_primitive_add, "Integer::+");
     sysbvm_primitiveTable_registerFunction(sysbvm_integer_primitive_subtract, "Integer::-");
@@ -894,6 +954,7 @@ void sysbvm_integer_setupPrimitives(sysbvm_context_t *context)
     sysbvm_type_setPrintStringFunction(context, context->roots.integerType, printString);
     sysbvm_type_setPrintStringFunction(context, context->roots.largePositiveIntegerType, printString);
     sysbvm_type_setPrintStringFunction(context, context->roots.largeNegativeIntegerType, printString);
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.integerType, "printOn:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_integer_primitive_printOn);
     
     sysbvm_context_setIntrinsicPrimitiveMethod(context, sysbvm_tuple_getType(context, context->roots.integerType), "parseString:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_integer_primitive_parseString);
     
@@ -8,16 +8,54 @@
 #include "heap.h"
 #include "sysbvm/dynarray.h"
 
-#define GLOBAL_LOOKUP_CACHE_ENTRY_COUNT 256
+#define GLOBAL_LOOKUP_CACHE_WAY_COUNT 4
+#define GLOBAL_LOOKUP_CACHE_MIN_SELECTOR_GROUP_SET_COUNT 16
+#define PIC_DEPENDENCY_INITIAL_BUCKET_COUNT 1024
 #define PIC_ENTRY_COUNT 16
+#define SYMBOL_TABLE_INITIAL_CAPACITY 4096
+#define STRING_HASH_CACHE_ENTRY_COUNT 1024
 
 typedef struct sysbvm_globalLookupCacheEntry_s
 {
     sysbvm_tuple_t type;
     sysbvm_tuple_t selector;
     sysbvm_tuple_t method;
+
+    // A null method caches a failed lookup, which is only valid during the method dictionary epoch in which it was made.
+    size_t missEpoch;
 }sysbvm_globalLookupCacheEntry_t;
 
+typedef struct sysbvm_globalLookupCacheSet_s
+{
+    // Odd while a writer is replacing an entry.
+    atomic_uint sequence;
+    sysbvm_globalLookupCacheEntry_t entries[GLOBAL_LOOKUP_CACHE_WAY_COUNT];
+}sysbvm_globalLookupCacheSet_t;
+
+typedef struct sysbvm_symbolTableEntry_s
+{
+    // The full string hash is written before the symbol is published.
+    size_t hash;
+    _Atomic(sysbvm_tuple_t) symbol;
+} sysbvm_symbolTableEntry_t;
+
+typedef struct sysbvm_symbolTable_s
+{
+    // The capacity is a power of two, and the table is replaced instead of resized in place.
+    size_t capacity;
+    size_t size;
+    struct sysbvm_symbolTable_s *nextRetiredTable;
+    sysbvm_symbolTableEntry_t entries[];
+} sysbvm_symbolTable_t;
+
+typedef struct sysbvm_stringHashCacheEntry_s
+{
+    // Odd while a writer is replacing the entry.
+    atomic_uint sequence;
+    sysbvm_tuple_t string;
+    size_t hash;
+} sysbvm_stringHashCacheEntry_t;
+
 typedef struct sysbvm_context_roots_s
 {
     sysbvm_tuple_t immediateTypeTable[SYSBVM_TUPLE_TAG_COUNT];
@@ -338,8 +376,7 @@ typedef struct sysbvm_context_roots_s
     sysbvm_tuple_t globalNamespace;
     sysbvm_tuple_t defaultAnalysisQueueValueBox;
     sysbvm_tuple_t intrinsicTypes;
-    
-    sysbvm_globalLookupCacheEntry_t globalMethodLookupCache[GLOBAL_LOOKUP_CACHE_ENTRY_COUNT];
+    sysbvm_tuple_t typesWithDispatchTable;
 } sysbvm_context_roots_t;
 
 struct sysbvm_context_s
@@ -350,9 +387,36 @@ struct sysbvm_context_s
     size_t identityHashSeed;
     bool jitEnabled;
     bool gcDisabled;
+    uint32_t jitInvocationThreshold;
+    uint32_t jitBackEdgeThreshold;
+    int jitDebugInfoLevel;
+    bool jitPerfMap;
+    bool jitPerfJitDump;
+    bool jitFullDebugInfoRequested;
     sysbvm_dynarray_t markingStack;
-    sysbvm_dynarray_t jittedObjectFileEntries;
-    sysbvm_dynarray_t jittedRegisteredFrames;
+
+    // The global method lookup cache is set associative. Its set count is a power of two.
+    // The entries of each selector are placed in a group of sets, whose size grows with the square root of the cache size.
+    size_t globalMethodLookupCacheSetCount;
+    size_t globalMethodLookupCacheSelectorGroupSetCount;
+    sysbvm_globalLookupCacheSet_t *globalMethodLookupCache;
+    atomic_size_t methodDictionaryEpoch;
+
+    // Registry of the PICs that have cached each selector, hashed by the selector identity hash.
+    atomic_flag picDependencyLock;
+    size_t picDependencyBucketCount;
+    size_t picDependencyCount;
+    sysbvm_pic_t **picDependencyBuckets;
+    sysbvm_pic_t *multipleSelectorPICs;
+
+    // Index of the interned symbols. Lookups are lock-free, insertions are serialized by the lock,
+    // and the replaced tables are released by the next collection.
+    _Atomic(sysbvm_symbolTable_t*) symbolTable;
+    atomic_flag symbolTableLock;
+    sysbvm_symbolTable_t *retiredSymbolTables;
+
+    // Hashes of the immutable strings, keyed by their address. The entries are weak, so they are flushed by each collection.
+    sysbvm_stringHashCacheEntry_t stringHashCache[STRING_HASH_CACHE_ENTRY_COUNT];
 
     sysbvm_pic_t *analyzeASTWithEnvironmentPIC;
     sysbvm_pic_t *evaluateASTWithEnvironment;
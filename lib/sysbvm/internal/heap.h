@@ -5,6 +5,8 @@
 
 #include "sysbvm/heap.h"
 #include "sysbvm/chunkedAllocator.h"
+#include "sysbvm/dynarray.h"
+#include "sysbvm/pic.h"
 #include <stdio.h>
 
 typedef struct sysbvm_heap_mallocObjectHeader_s
@@ -15,17 +17,68 @@ typedef struct sysbvm_heap_mallocObjectHeader_s
         {
             struct sysbvm_heap_mallocObjectHeader_s *next;
             uint32_t size;
+            uint32_t allocationBufferOffset;
         };
 
         uint32_t words[4];
     };
 } sysbvm_heap_mallocObjectHeader_t;
 
+#define SYSBVM_HEAP_CODE_FREE_LIST_COUNT 16
+
+/**
+ * A block of jitted code, together with the data that is released with it.
+ */
+typedef struct sysbvm_heap_codeBlock_s
+{
+    struct sysbvm_heap_codeBlock_s *previous;
+    struct sysbvm_heap_codeBlock_s *next;
+
+    uint8_t *writeableMapping;
+    uint8_t *executableMapping;
+    size_t size;
+
+    // Weak reference to the function bytecode that owns the code.
+    sysbvm_tuple_t owner;
+
+    // Read by the jitted code. It is only kept alive together with the owner.
+    sysbvm_tuple_t literalVector;
+
+    // The owners of the code that is called directly from this block, which are also kept alive together with the owner.
+    sysbvm_dynarray_t retainedObjects;
+
+    // The PICs of the send sites in this block. Their content is only kept alive together with the owner, and they are freed with the block.
+    sysbvm_dynarray_t pics;
+
+    void *gdbEntry;
+    void *registeredFrame;
+} sysbvm_heap_codeBlock_t;
+
+typedef struct sysbvm_heap_freeCodeSpan_s
+{
+    struct sysbvm_heap_freeCodeSpan_s *next;
+    uint8_t *executableMapping;
+    size_t size;
+} sysbvm_heap_freeCodeSpan_t;
+
+typedef struct sysbvm_heap_allocationBuffer_s
+{
+    union
+    {
+        size_t objectCount;
+        uint32_t words[4];
+    };
+} sysbvm_heap_allocationBuffer_t;
+
 struct sysbvm_heap_s
 {
     sysbvm_heap_mallocObjectHeader_t *firstMallocObject;
     sysbvm_heap_mallocObjectHeader_t *lastMallocObject;
 
+    uintptr_t allocationBufferPosition;
+    uintptr_t allocationBufferLimit;
+    sysbvm_heap_allocationBuffer_t *currentAllocationBuffer;
+
     bool shouldAttemptToCollect;
 
     size_t totalSize;
@@ -39,6 +92,12 @@ struct sysbvm_heap_s
     sysbvm_chunkedAllocator_t gcRootTableAllocator;
     sysbvm_chunkedAllocator_t picTableAllocator;
     sysbvm_chunkedAllocator_t codeAllocator;
+
+    sysbvm_heap_codeBlock_t *firstCodeBlock;
+    sysbvm_heap_codeBlock_t *lastCodeBlock;
+    sysbvm_heap_freeCodeSpan_t *codeFreeLists[SYSBVM_HEAP_CODE_FREE_LIST_COUNT];
+    size_t codeSize;
+    size_t codeFreeSize;
 };
 
 typedef struct sysbvm_heap_relocationRecord_s
@@ -66,6 +125,12 @@ void sysbvm_heap_destroy(sysbvm_heap_t *heap);
 
 sysbvm_tuple_t *sysbvm_heap_allocateGCRootTableEntry(sysbvm_heap_t *heap);
 
+sysbvm_heap_codeBlock_t *sysbvm_heap_createCodeBlock(sysbvm_heap_t *heap, sysbvm_tuple_t owner);
+sysbvm_pic_t *sysbvm_heap_createCodeBlockPIC(sysbvm_heap_codeBlock_t *codeBlock);
+void sysbvm_heap_addCodeBlockRetainedObject(sysbvm_heap_codeBlock_t *codeBlock, sysbvm_tuple_t object);
+void sysbvm_heap_allocateCodeBlockMemory(sysbvm_heap_t *heap, sysbvm_heap_codeBlock_t *codeBlock, size_t size);
+void sysbvm_heap_destroyCodeBlock(sysbvm_heap_t *heap, sysbvm_heap_codeBlock_t *codeBlock);
+
 void sysbvm_heap_replaceWeakReferencesWithTombstones(sysbvm_heap_t *heap);
 void sysbvm_heap_sweep(sysbvm_heap_t *heap);
 void sysbvm_heap_swapGCColors(sysbvm_heap_t *heap);
@@ -1219,6 +1219,7 @@ static void sysbvm_functionDefinition_analyzeType(sysbvm_context_t *context, sys
     gcFrame.sourceAnalyzedDefinition->resultTypeNode = gcFrame.analyzedResultTypeNode;
     gcFrame.analysisEnvironmentObject->returnTypeExpression = gcFrame.sourceAnalyzedDefinition->resultTypeNode;
 
+    sysbvm_functionBytecode_unlinkJittedCode(context, (*functionDefinition)->bytecode);
     (*functionDefinition)->bytecode = SYSBVM_NULL_TUPLE;
     (*functionDefinition)->nativeCodeDefinition = SYSBVM_NULL_TUPLE;
 
@@ -1273,6 +1274,7 @@ static void sysbvm_functionDefinition_analyze(sysbvm_context_t *context, sysbvm_
 
     (*functionDefinition)->captureVectorType = sysbvm_type_createSequenceTupleType(context, gcFrame.captureTypes);
 
+    sysbvm_functionBytecode_unlinkJittedCode(context, (*functionDefinition)->bytecode);
     (*functionDefinition)->bytecode = SYSBVM_NULL_TUPLE;
     (*functionDefinition)->nativeCodeDefinition = SYSBVM_NULL_TUPLE;
     if(!sysbvm_tuple_boolean_decode(gcFrame.analysisEnvironmentObject->keepSourceDefinition))
@@ -5022,6 +5024,7 @@ static sysbvm_tuple_t sysbvm_astWhileContinueWithNode_primitiveAnalyzeAndEvaluat
 
     sysbvm_stackFrame_popRecord((sysbvm_stackFrameRecord_t*)&breakTargetRecord);  
     SYSBVM_STACKFRAME_POP_SOURCE_POSITION(sourcePositionRecord);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
 
     return SYSBVM_VOID_TUPLE;
 }
@@ -5862,6 +5865,8 @@ SYSBVM_API sysbvm_tuple_t sysbvm_interpreter_loadSourceCodeWithSolvedPath(sysbvm
             sysbvm_symbol_internWithCString(context, "Failed to load source file from: "),
             gcFrame.filename));
 
+    // The file contents are owned by the source code and never modified, so they can keep their hash.
+    sysbvm_tuple_markImmutable(gcFrame.sourceString);
     gcFrame.sourceDirectory = sysbvm_filesystem_dirname(context, gcFrame.filename);
     gcFrame.sourceName = sysbvm_filesystem_basename(context, gcFrame.filename);
     gcFrame.sourceLanguage = sysbvm_sourceCode_inferLanguageFromSourceName(context, gcFrame.sourceName);
@@ -13,6 +13,13 @@ SYSBVM_API sysbvm_tuple_t sysbvm_orderedCollection_create(sysbvm_context_t *cont
     return (sysbvm_tuple_t)result;
 }
 
+SYSBVM_API sysbvm_tuple_t sysbvm_weakOrderedCollection_create(sysbvm_context_t *context)
+{
+    sysbvm_orderedCollection_t *result = (sysbvm_orderedCollection_t*)sysbvm_context_allocatePointerTuple(context, context->roots.weakOrderedCollectionType, SYSBVM_SLOT_COUNT_FOR_STRUCTURE_TYPE(sysbvm_orderedCollection_t));
+    result->size = sysbvm_tuple_size_encode(context, 0);
+    return (sysbvm_tuple_t)result;
+}
+
 static void sysbvm_orderedCollection_increaseCapacity(sysbvm_context_t *context, sysbvm_tuple_t orderedCollection)
 {
     sysbvm_orderedCollection_t *orderedCollectionObject = (sysbvm_orderedCollection_t*)orderedCollection;
@@ -0,0 +1,225 @@
+#include "sysbvm/perf.h"
+#include "sysbvm/dwarf.h"
+#include "sysbvm/dynarray.h"
+#include "sysbvm/time.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#define SYSBVM_PERF_JITDUMP_MAGIC 0x4A695444
+#define SYSBVM_PERF_JITDUMP_VERSION 1
+
+// perf inject places the code right after the ELF header, and the eh_frame right after the code.
+#define SYSBVM_PERF_JITDUMP_ELF_TEXT_OFFSET 64
+#define SYSBVM_PERF_JITDUMP_EH_FRAME_HDR_SIZE 20
+
+typedef enum sysbvm_perf_jitDumpRecordType_e
+{
+    SYSBVM_PERF_JIT_CODE_LOAD = 0,
+    SYSBVM_PERF_JIT_CODE_MOVE = 1,
+    SYSBVM_PERF_JIT_CODE_DEBUG_INFO = 2,
+    SYSBVM_PERF_JIT_CODE_CLOSE = 3,
+    SYSBVM_PERF_JIT_CODE_UNWINDING_INFO = 4,
+} sysbvm_perf_jitDumpRecordType_t;
+
+typedef struct sysbvm_perf_jitDumpHeader_s
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMachine;
+    uint32_t padding;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} sysbvm_perf_jitDumpHeader_t;
+
+SYSBVM_API void sysbvm_perf_writeMapEntry(uint64_t codeAddress, size_t codeSize, const char *name)
+{
+#if defined(__linux__)
+    static int sysbvm_perf_mapFD;
+
+    char buffer[2048];
+
+    if(!sysbvm_perf_mapFD)
+    {
+        snprintf(buffer, sizeof(buffer), "/tmp/perf-%d.map", getpid());
+        sysbvm_perf_mapFD = open(buffer, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    if(sysbvm_perf_mapFD < 0) return;
+
+    int symbolRecordSize = snprintf(buffer, sizeof(buffer), "%llx %llx %s\n", (long long)codeAddress, (long long)codeSize, name);
+    if(symbolRecordSize >= (int)sizeof(buffer))
+        symbolRecordSize = (int)sizeof(buffer) - 1;
+
+    ssize_t writeSize = write(sysbvm_perf_mapFD, buffer, symbolRecordSize);
+    if(writeSize != symbolRecordSize)
+        perror("Failed write map file entry");
+#else
+    (void)codeAddress;
+    (void)codeSize;
+    (void)name;
+#endif
+}
+
+#if defined(__linux__)
+
+static int sysbvm_perf_jitDumpFD;
+static uint64_t sysbvm_perf_jitDumpCodeIndex;
+
+static bool sysbvm_perf_jitDump_ensureOpened(uint32_t elfMachine)
+{
+    if(sysbvm_perf_jitDumpFD)
+        return sysbvm_perf_jitDumpFD > 0;
+
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "/tmp/jit-%d.dump", getpid());
+    int fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        sysbvm_perf_jitDumpFD = -1;
+        return false;
+    }
+
+    // perf record finds the dump file through the mmap event of this executable mapping.
+    void *marker = mmap(NULL, (size_t)sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if(marker == MAP_FAILED)
+    {
+        close(fd);
+        sysbvm_perf_jitDumpFD = -1;
+        return false;
+    }
+
+    sysbvm_perf_jitDumpHeader_t header = {
+        .magic = SYSBVM_PERF_JITDUMP_MAGIC,
+        .version = SYSBVM_PERF_JITDUMP_VERSION,
+        .totalSize = sizeof(sysbvm_perf_jitDumpHeader_t),
+        .elfMachine = elfMachine,
+        .pid = (uint32_t)getpid(),
+        .timestamp = (uint64_t)sysbvm_time_nanosecondsTimestamp(),
+    };
+
+    if(write(fd, &header, sizeof(header)) != sizeof(header))
+    {
+        perror("Failed to write the jitdump header");
+        close(fd);
+        sysbvm_perf_jitDumpFD = -1;
+        return false;
+    }
+
+    sysbvm_perf_jitDumpFD = fd;
+    return true;
+}
+
+static size_t sysbvm_perf_jitDump_beginRecord(sysbvm_dynarray_t *buffer, sysbvm_perf_jitDumpRecordType_t type)
+{
+    size_t recordOffset = sysbvm_dwarf_encodeDWord(buffer, type);
+    sysbvm_dwarf_encodeDWord(buffer, 0);
+    sysbvm_dwarf_encodeQWord(buffer, (uint64_t)sysbvm_time_nanosecondsTimestamp());
+    return recordOffset;
+}
+
+static void sysbvm_perf_jitDump_endRecord(sysbvm_dynarray_t *buffer, size_t recordOffset)
+{
+    uint32_t recordSize = (uint32_t)(buffer->size - recordOffset);
+    memcpy(buffer->data + recordOffset + 4, &recordSize, 4);
+}
+
+static void sysbvm_perf_jitDump_emitDebugInfo(sysbvm_dynarray_t *buffer, const sysbvm_perf_jitDumpCodeLoad_t *codeLoad)
+{
+    size_t recordOffset = sysbvm_perf_jitDump_beginRecord(buffer, SYSBVM_PERF_JIT_CODE_DEBUG_INFO);
+    sysbvm_dwarf_encodeQWord(buffer, codeLoad->codeAddress);
+    sysbvm_dwarf_encodeQWord(buffer, codeLoad->lineEntryCount);
+    for(size_t i = 0; i < codeLoad->lineEntryCount; ++i)
+    {
+        const sysbvm_perf_jitDumpLineEntry_t *entry = codeLoad->lineEntries + i;
+        sysbvm_dwarf_encodeQWord(buffer, entry->address);
+        sysbvm_dwarf_encodeDWord(buffer, entry->line);
+        sysbvm_dwarf_encodeDWord(buffer, 0); // Discriminator
+        sysbvm_dwarf_encodeCString(buffer, entry->fileName ? entry->fileName : "");
+    }
+    sysbvm_perf_jitDump_endRecord(buffer, recordOffset);
+}
+
+static void sysbvm_perf_jitDump_emitUnwindingInfo(sysbvm_dynarray_t *buffer, const sysbvm_perf_jitDumpCodeLoad_t *codeLoad)
+{
+    // Addresses in the ELF file that is generated by perf inject.
+    uint64_t ehFrameAddress = (SYSBVM_PERF_JITDUMP_ELF_TEXT_OFFSET + codeLoad->codeSize + 7) & (~(uint64_t)7);
+    uint64_t ehFrameHdrAddress = ehFrameAddress + codeLoad->ehFrameSize;
+    uint64_t unwindingSize = codeLoad->ehFrameSize + SYSBVM_PERF_JITDUMP_EH_FRAME_HDR_SIZE;
+
+    size_t recordOffset = sysbvm_perf_jitDump_beginRecord(buffer, SYSBVM_PERF_JIT_CODE_UNWINDING_INFO);
+    sysbvm_dwarf_encodeQWord(buffer, unwindingSize);
+    sysbvm_dwarf_encodeQWord(buffer, SYSBVM_PERF_JITDUMP_EH_FRAME_HDR_SIZE);
+    sysbvm_dwarf_encodeQWord(buffer, (unwindingSize + 7) & (~(uint64_t)7));
+
+    // The eh_frame, with its FDE pointing to the code.
+    size_t ehFrameOffset = buffer->size;
+    sysbvm_dynarray_addAll(buffer, codeLoad->ehFrameSize, codeLoad->ehFrame);
+    if(codeLoad->ehFrameFdeInitialLocationOffset > 0)
+    {
+        int32_t initialLocation = (int32_t)(SYSBVM_PERF_JITDUMP_ELF_TEXT_OFFSET - (int64_t)(ehFrameAddress + codeLoad->ehFrameFdeInitialLocationOffset));
+        memcpy(buffer->data + ehFrameOffset + codeLoad->ehFrameFdeInitialLocationOffset, &initialLocation, 4);
+    }
+
+    // The eh_frame_hdr, with a single entry lookup table.
+    sysbvm_dwarf_encodeByte(buffer, 1);
+    sysbvm_dwarf_encodeByte(buffer, DW_EH_PE_pcrel | DW_EH_PE_sdata4);
+    sysbvm_dwarf_encodeByte(buffer, DW_EH_PE_udata4);
+    sysbvm_dwarf_encodeByte(buffer, DW_EH_PE_datarel | DW_EH_PE_sdata4);
+    sysbvm_dwarf_encodeDWord(buffer, (uint32_t)(int32_t)((int64_t)ehFrameAddress - (int64_t)(ehFrameHdrAddress + 4)));
+    sysbvm_dwarf_encodeDWord(buffer, 1);
+    sysbvm_dwarf_encodeDWord(buffer, (uint32_t)(int32_t)(SYSBVM_PERF_JITDUMP_ELF_TEXT_OFFSET - (int64_t)ehFrameHdrAddress));
+    sysbvm_dwarf_encodeDWord(buffer, (uint32_t)(int32_t)((int64_t)(ehFrameAddress + codeLoad->ehFrameFdeOffset) - (int64_t)ehFrameHdrAddress));
+
+    while((buffer->size - recordOffset) % 8 != 0)
+        sysbvm_dwarf_encodeByte(buffer, 0);
+    sysbvm_perf_jitDump_endRecord(buffer, recordOffset);
+}
+
+static void sysbvm_perf_jitDump_emitCodeLoad(sysbvm_dynarray_t *buffer, const sysbvm_perf_jitDumpCodeLoad_t *codeLoad)
+{
+    size_t recordOffset = sysbvm_perf_jitDump_beginRecord(buffer, SYSBVM_PERF_JIT_CODE_LOAD);
+    sysbvm_dwarf_encodeDWord(buffer, (uint32_t)getpid());
+    sysbvm_dwarf_encodeDWord(buffer, (uint32_t)syscall(SYS_gettid));
+    sysbvm_dwarf_encodeQWord(buffer, codeLoad->codeAddress);
+    sysbvm_dwarf_encodeQWord(buffer, codeLoad->codeAddress);
+    sysbvm_dwarf_encodeQWord(buffer, codeLoad->codeSize);
+    sysbvm_dwarf_encodeQWord(buffer, sysbvm_perf_jitDumpCodeIndex++);
+    sysbvm_dwarf_encodeCString(buffer, codeLoad->name);
+    sysbvm_dynarray_addAll(buffer, codeLoad->codeSize, codeLoad->code);
+    sysbvm_perf_jitDump_endRecord(buffer, recordOffset);
+}
+
+#endif
+
+SYSBVM_API void sysbvm_perf_writeJitDumpCodeLoad(const sysbvm_perf_jitDumpCodeLoad_t *codeLoad)
+{
+#if defined(__linux__)
+    if(!sysbvm_perf_jitDump_ensureOpened(codeLoad->elfMachine))
+        return;
+
+    // The debug and unwinding records must precede the code load record that they describe.
+    sysbvm_dynarray_t buffer;
+    sysbvm_dynarray_initialize(&buffer, 1, 256 + codeLoad->codeSize + codeLoad->ehFrameSize);
+    if(codeLoad->lineEntryCount > 0)
+        sysbvm_perf_jitDump_emitDebugInfo(&buffer, codeLoad);
+    if(codeLoad->ehFrameSize > 0)
+        sysbvm_perf_jitDump_emitUnwindingInfo(&buffer, codeLoad);
+    sysbvm_perf_jitDump_emitCodeLoad(&buffer, codeLoad);
+
+    ssize_t writeSize = write(sysbvm_perf_jitDumpFD, buffer.data, buffer.size);
+    if(writeSize != (ssize_t)buffer.size)
+        perror("Failed to write jitdump records");
+    sysbvm_dynarray_destroy(&buffer);
+#else
+    (void)codeLoad;
+#endif
+}
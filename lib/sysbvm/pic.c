@@ -1,4 +1,6 @@
 #include "sysbvm/pic.h"
+#include "internal/context.h"
+#include <stdlib.h>
 #include <string.h>
 
 SYSBVM_API bool sysbvm_pic_lookupTypeAndSelector(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t *outMethod)
@@ -20,8 +22,85 @@ SYSBVM_API bool sysbvm_pic_lookupTypeAndSelector(sysbvm_pic_t *pic, sysbvm_tuple
     return hasFoundEntry && entrySequence == exitSequence;
 }
 
-SYSBVM_API void sysbvm_pic_addSelectorTypeAndMethod(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method)
+static void sysbvm_pic_lockDependencies(sysbvm_context_t *context)
 {
+    while(atomic_flag_test_and_set_explicit(&context->picDependencyLock, memory_order_acquire))
+        ;
+}
+
+static void sysbvm_pic_unlockDependencies(sysbvm_context_t *context)
+{
+    atomic_flag_clear_explicit(&context->picDependencyLock, memory_order_release);
+}
+
+static sysbvm_pic_t **sysbvm_pic_dependencyBucketFor(sysbvm_context_t *context, sysbvm_tuple_t selector)
+{
+    return context->picDependencyBuckets + (sysbvm_tuple_identityHash(selector) & (context->picDependencyBucketCount - 1));
+}
+
+static void sysbvm_pic_growDependencyBuckets(sysbvm_context_t *context)
+{
+    size_t oldBucketCount = context->picDependencyBucketCount;
+    sysbvm_pic_t **oldBuckets = context->picDependencyBuckets;
+
+    context->picDependencyBucketCount = oldBucketCount ? oldBucketCount * 2 : PIC_DEPENDENCY_INITIAL_BUCKET_COUNT;
+    context->picDependencyBuckets = (sysbvm_pic_t**)calloc(context->picDependencyBucketCount, sizeof(sysbvm_pic_t*));
+    for(size_t i = 0; i < oldBucketCount; ++i)
+    {
+        sysbvm_pic_t *pic = oldBuckets[i];
+        while(pic)
+        {
+            sysbvm_pic_t *nextPic = pic->nextDependency;
+            sysbvm_pic_t **bucket = sysbvm_pic_dependencyBucketFor(context, pic->dependencySelector);
+            pic->nextDependency = *bucket;
+            *bucket = pic;
+            pic = nextPic;
+        }
+    }
+
+    free(oldBuckets);
+}
+
+static void sysbvm_pic_registerSelectorDependency(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector)
+{
+    sysbvm_pic_lockDependencies(context);
+    if(!pic->dependencySelector)
+    {
+        if(context->picDependencyCount >= context->picDependencyBucketCount * 2)
+            sysbvm_pic_growDependencyBuckets(context);
+
+        sysbvm_pic_t **bucket = sysbvm_pic_dependencyBucketFor(context, selector);
+        pic->dependencyContext = context;
+        pic->dependencySelector = selector;
+        pic->nextDependency = *bucket;
+        *bucket = pic;
+        ++context->picDependencyCount;
+    }
+    else if(pic->dependencySelector != selector && !pic->hasMultipleSelectorDependencies)
+    {
+        // Sites with a non-constant selector are flushed on every selector invalidation.
+        sysbvm_pic_t **link = sysbvm_pic_dependencyBucketFor(context, pic->dependencySelector);
+        while(*link != pic)
+            link = &(*link)->nextDependency;
+        *link = pic->nextDependency;
+        --context->picDependencyCount;
+
+        pic->hasMultipleSelectorDependencies = true;
+        pic->nextDependency = context->multipleSelectorPICs;
+        context->multipleSelectorPICs = pic;
+    }
+    sysbvm_pic_unlockDependencies(context);
+}
+
+SYSBVM_API void sysbvm_pic_addSelectorTypeAndMethod(sysbvm_context_t *context, sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method)
+{
+    // The failed lookups are left to the global cache, which discards them when the type hierarchy grows.
+    if(!method)
+        return;
+
+    if(pic->dependencySelector != selector && !pic->hasMultipleSelectorDependencies)
+        sysbvm_pic_registerSelectorDependency(context, pic, selector);
+
     unsigned int sequence = sysbvm_pic_writeLock(pic);
     unsigned int entryIndex = sequence % SYSBVM_PIC_ENTRY_COUNT;
     sysbvm_picEntry_t *entry = pic->entries + entryIndex;
@@ -41,9 +120,90 @@ SYSBVM_API void sysbvm_pic_flushSelector(sysbvm_pic_t *pic, sysbvm_tuple_t selec
         if(entry->selector == selector)
             memset(entry, 0, sizeof(sysbvm_picEntry_t));
     }
+
+    if(pic->inlineCacheEntry.selector == selector)
+        sysbvm_pic_setInlineCache(pic, SYSBVM_NULL_TUPLE, SYSBVM_NULL_TUPLE, SYSBVM_NULL_TUPLE, NULL, SYSBVM_NULL_TUPLE);
+    sysbvm_pic_writeUnlock(pic, sequence);
+}
+
+SYSBVM_API void sysbvm_pic_flushSelectorDependencies(sysbvm_context_t *context, sysbvm_tuple_t selector)
+{
+    sysbvm_pic_lockDependencies(context);
+    if(context->picDependencyBucketCount)
+    {
+        for(sysbvm_pic_t *pic = *sysbvm_pic_dependencyBucketFor(context, selector); pic; pic = pic->nextDependency)
+        {
+            if(pic->dependencySelector == selector)
+                sysbvm_pic_flushSelector(pic, selector);
+        }
+    }
+
+    for(sysbvm_pic_t *pic = context->multipleSelectorPICs; pic; pic = pic->nextDependency)
+        sysbvm_pic_flushSelector(pic, selector);
+    sysbvm_pic_unlockDependencies(context);
+}
+
+SYSBVM_API void sysbvm_pic_flush(sysbvm_pic_t *pic)
+{
+    uint32_t sequence = sysbvm_pic_writeLock(pic);
+    memset(pic->entries, 0, sizeof(pic->entries));
+    if(pic->inlineCacheEntry.type)
+        sysbvm_pic_setInlineCache(pic, SYSBVM_NULL_TUPLE, SYSBVM_NULL_TUPLE, SYSBVM_NULL_TUPLE, NULL, SYSBVM_NULL_TUPLE);
     sysbvm_pic_writeUnlock(pic, sequence);
 }
 
+SYSBVM_API void sysbvm_pic_flushAllDependencies(sysbvm_context_t *context)
+{
+    // Every PIC that has ever cached a lookup is registered, either under its selector or in the multiple selector list.
+    sysbvm_pic_lockDependencies(context);
+    for(size_t i = 0; i < context->picDependencyBucketCount; ++i)
+    {
+        for(sysbvm_pic_t *pic = context->picDependencyBuckets[i]; pic; pic = pic->nextDependency)
+            sysbvm_pic_flush(pic);
+    }
+
+    for(sysbvm_pic_t *pic = context->multipleSelectorPICs; pic; pic = pic->nextDependency)
+        sysbvm_pic_flush(pic);
+    sysbvm_pic_unlockDependencies(context);
+}
+
+SYSBVM_API void sysbvm_pic_unregisterDependencies(sysbvm_pic_t *pic)
+{
+    sysbvm_context_t *context = pic->dependencyContext;
+    if(!context)
+        return;
+
+    sysbvm_pic_lockDependencies(context);
+    sysbvm_pic_t **link = pic->hasMultipleSelectorDependencies
+        ? &context->multipleSelectorPICs
+        : sysbvm_pic_dependencyBucketFor(context, pic->dependencySelector);
+    while(*link != pic)
+        link = &(*link)->nextDependency;
+    *link = pic->nextDependency;
+    if(!pic->hasMultipleSelectorDependencies)
+        --context->picDependencyCount;
+    sysbvm_pic_unlockDependencies(context);
+
+    pic->dependencyContext = NULL;
+    pic->dependencySelector = SYSBVM_NULL_TUPLE;
+    pic->hasMultipleSelectorDependencies = false;
+    pic->nextDependency = NULL;
+}
+
+SYSBVM_API void sysbvm_pic_setInlineCache(sysbvm_pic_t *pic, sysbvm_tuple_t selector, sysbvm_tuple_t type, sysbvm_tuple_t method, void *entryPoint, sysbvm_tuple_t entryPointOwner)
+{
+    // The jitted code reads the type, the method, the entry point and then the type again.
+    // Invalidating the type first and publishing it last keeps concurrent readers from mixing two entries.
+    _Atomic(sysbvm_tuple_t) *inlineCacheType = (_Atomic(sysbvm_tuple_t)*)&pic->inlineCacheEntry.type;
+    atomic_store_explicit(inlineCacheType, SYSBVM_NULL_TUPLE, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    pic->inlineCacheEntry.selector = selector;
+    pic->inlineCacheEntry.method = method;
+    pic->inlineCacheEntryPoint = entryPoint;
+    pic->inlineCacheEntryPointOwner = entryPointOwner;
+    atomic_store_explicit(inlineCacheType, type, memory_order_release);
+}
+
 SYSBVM_API unsigned int sysbvm_pic_writeLock(sysbvm_pic_t *pic)
 {
     atomic_uint entrySequence;
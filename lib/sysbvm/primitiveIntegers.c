@@ -2,6 +2,7 @@
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
 #include "sysbvm/string.h"
+#include "sysbvm/stringStream.h"
 #include "sysbvm/type.h"
 #include "internal/context.h"
 #include <string.h>
@@ -11,49 +12,67 @@
 #define CONCAT_SYMBOLS(prefix, suffix) CONCAT_SYMBOLS_(prefix, suffix)
 #define PRIMITIVE_INTEGER_FUNCTION(name) CONCAT_SYMBOLS(FUNCTION_PREFIX, name)
 
-static sysbvm_tuple_t sysbvm_primitiveInteger_signed_printString(sysbvm_context_t *context, int64_t integer)
-{
-    char buffer[64];
-    size_t bufferSize = 0;
-
-    // Work with positive integers.
-    bool isNegative = false;
-    int64_t value = integer;
-    if(value < 0)
-    {
-        isNegative = true;
-        value = -value;
-    }
+#define SYSBVM_PRIMITIVE_INTEGER_PRINT_BUFFER_SIZE 32
 
-    // Extract each one of the digits.
-    while (value != 0 || bufferSize == 0)
+static char *sysbvm_primitiveInteger_formatDigits(char *bufferEnd, uint64_t magnitude, bool isNegative)
+{
+    // Extract each one of the digits, starting from the end of the buffer.
+    char *digits = bufferEnd;
+    do
     {
-        buffer[bufferSize++] = '0' + (value % 10);
-        value /= 10;
-    }
+        *--digits = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude != 0);
 
     // Add the sign.
     if(isNegative)
-        buffer[bufferSize++] = '-';
-    buffer[bufferSize] = 0;
-    return sysbvm_string_createWithReversedString(context, bufferSize, buffer);
+        *--digits = '-';
+    return digits;
+}
+
+static char *sysbvm_primitiveInteger_signed_format(char *bufferEnd, int64_t integer)
+{
+    // Work with the magnitude as an unsigned integer, which also handles the minimum value.
+    bool isNegative = integer < 0;
+    uint64_t magnitude = isNegative ? 0 - (uint64_t)integer : (uint64_t)integer;
+    return sysbvm_primitiveInteger_formatDigits(bufferEnd, magnitude, isNegative);
+}
+
+static char *sysbvm_primitiveInteger_unsigned_format(char *bufferEnd, uint64_t integer)
+{
+    return sysbvm_primitiveInteger_formatDigits(bufferEnd, integer, false);
+}
+
+static sysbvm_tuple_t sysbvm_primitiveInteger_signed_printString(sysbvm_context_t *context, int64_t integer)
+{
+    char buffer[SYSBVM_PRIMITIVE_INTEGER_PRINT_BUFFER_SIZE];
+    char *bufferEnd = buffer + sizeof(buffer);
+    char *digits = sysbvm_primitiveInteger_signed_format(bufferEnd, integer);
+    return sysbvm_string_createWithString(context, bufferEnd - digits, digits);
 }
 
 static sysbvm_tuple_t sysbvm_primitiveInteger_unsigned_printString(sysbvm_context_t *context, uint64_t integer)
 {
-    char buffer[64];
-    size_t bufferSize = 0;
+    char buffer[SYSBVM_PRIMITIVE_INTEGER_PRINT_BUFFER_SIZE];
+    char *bufferEnd = buffer + sizeof(buffer);
+    char *digits = sysbvm_primitiveInteger_unsigned_format(bufferEnd, integer);
+    return sysbvm_string_createWithString(context, bufferEnd - digits, digits);
+}
 
-    // Extract each one of the digits.
-    uint64_t value = integer;
-    while (value != 0 || bufferSize == 0)
-    {
-        buffer[bufferSize++] = '0' + (value % 10);
-        value /= 10;
-    }
+static void sysbvm_primitiveInteger_signed_printOn(sysbvm_context_t *context, int64_t integer, sysbvm_tuple_t stream)
+{
+    char buffer[SYSBVM_PRIMITIVE_INTEGER_PRINT_BUFFER_SIZE];
+    char *bufferEnd = buffer + sizeof(buffer);
+    char *digits = sysbvm_primitiveInteger_signed_format(bufferEnd, integer);
+    sysbvm_stream_nextPutStringWithSize(context, stream, bufferEnd - digits, digits);
+}
 
-    buffer[bufferSize] = 0;
-    return sysbvm_string_createWithReversedString(context, bufferSize, buffer);
+static void sysbvm_primitiveInteger_unsigned_printOn(sysbvm_context_t *context, uint64_t integer, sysbvm_tuple_t stream)
+{
+    char buffer[SYSBVM_PRIMITIVE_INTEGER_PRINT_BUFFER_SIZE];
+    char *bufferEnd = buffer + sizeof(buffer);
+    char *digits = sysbvm_primitiveInteger_unsigned_format(bufferEnd, integer);
+    sysbvm_stream_nextPutStringWithSize(context, stream, bufferEnd - digits, digits);
 }
 
 #define integer_t char
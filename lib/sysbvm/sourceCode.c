@@ -16,7 +16,14 @@ SYSBVM_API sysbvm_tuple_t sysbvm_sourceCode_create(sysbvm_context_t *context, sy
 
 SYSBVM_API sysbvm_tuple_t sysbvm_sourceCode_createWithCStrings(sysbvm_context_t *context, const char *text, const char *directory, const char *name, const char *language)
 {
-    return sysbvm_sourceCode_create(context, sysbvm_string_createWithCString(context, text), sysbvm_string_createWithCString(context, directory), sysbvm_string_createWithCString(context, name), sysbvm_symbol_internWithCString(context, language));
+    // These strings are not shared with the caller and they are never modified, so they can keep their hash.
+    sysbvm_tuple_t textString = sysbvm_string_createWithCString(context, text);
+    sysbvm_tuple_t directoryString = sysbvm_string_createWithCString(context, directory);
+    sysbvm_tuple_t nameString = sysbvm_string_createWithCString(context, name);
+    sysbvm_tuple_markImmutable(textString);
+    sysbvm_tuple_markImmutable(directoryString);
+    sysbvm_tuple_markImmutable(nameString);
+    return sysbvm_sourceCode_create(context, textString, directoryString, nameString, sysbvm_symbol_internWithCString(context, language));
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_sourceCode_inferLanguageFromSourceName(sysbvm_context_t *context, sysbvm_tuple_t sourceName)
@@ -103,6 +103,7 @@ SYSBVM_API void sysbvm_stackFrame_iterateGCRootsInRecordWith(sysbvm_stackFrameRe
             iterationFunction(userdata, &functionRecord->literalVector);
             iterationFunction(userdata, &functionRecord->captureVector);
             iterationFunction(userdata, &functionRecord->function);
+            iterationFunction(userdata, &functionRecord->functionBytecode);
 
             for(size_t i = 0; i < functionRecord->argumentCount; ++i)
                 iterationFunction(userdata, functionRecord->arguments + i);
@@ -2,9 +2,11 @@
 #include "sysbvm/context.h"
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
+#include "sysbvm/hash.h"
 #include "sysbvm/set.h"
 #include "sysbvm/type.h"
 #include "internal/context.h"
+#include <stdlib.h>
 #include <string.h>
 
 typedef struct sysbvm_stringSlice_s
@@ -124,28 +126,137 @@ SYSBVM_API sysbvm_tuple_t sysbvm_string_concat(sysbvm_context_t *context, sysbvm
     return result;
 }
 
+static sysbvm_tuple_t sysbvm_symbolTable_find(sysbvm_symbolTable_t *table, size_t hash, size_t stringSize, const char *string)
+{
+    size_t mask = table->capacity - 1;
+    for(size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        sysbvm_symbolTableEntry_t *entry = table->entries + i;
+        sysbvm_tuple_t symbol = atomic_load_explicit(&entry->symbol, memory_order_acquire);
+        if(!symbol)
+            return SYSBVM_NULL_TUPLE;
+
+        if(entry->hash == hash
+            && sysbvm_tuple_getSizeInBytes(symbol) == stringSize
+            && memcmp(SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(symbol)->bytes, string, stringSize) == 0)
+            return symbol;
+    }
+}
+
+static void sysbvm_symbolTable_insertNoCheck(sysbvm_symbolTable_t *table, size_t hash, sysbvm_tuple_t symbol)
+{
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while(atomic_load_explicit(&table->entries[i].symbol, memory_order_relaxed))
+        i = (i + 1) & mask;
+
+    table->entries[i].hash = hash;
+    atomic_store_explicit(&table->entries[i].symbol, symbol, memory_order_release);
+    ++table->size;
+}
+
+static sysbvm_symbolTable_t *sysbvm_symbolTable_create(size_t capacity)
+{
+    sysbvm_symbolTable_t *table = (sysbvm_symbolTable_t*)calloc(1, sizeof(sysbvm_symbolTable_t) + capacity * sizeof(sysbvm_symbolTableEntry_t));
+    if(table)
+        table->capacity = capacity;
+    return table;
+}
+
+static void sysbvm_symbol_addToTable(sysbvm_context_t *context, size_t hash, sysbvm_tuple_t symbol)
+{
+    // A symbol that is not published in the table is still found in the interned symbol set.
+    sysbvm_symbolTable_t *table = atomic_load_explicit(&context->symbolTable, memory_order_relaxed);
+    if(!table)
+    {
+        table = sysbvm_symbolTable_create(SYMBOL_TABLE_INITIAL_CAPACITY);
+        if(!table)
+            return;
+        atomic_store_explicit(&context->symbolTable, table, memory_order_release);
+    }
+    else if((table->size + 1) * 2 > table->capacity)
+    {
+        // Publish a larger copy. Concurrent readers may keep probing the old table until the next collection.
+        sysbvm_symbolTable_t *newTable = sysbvm_symbolTable_create(table->capacity * 2);
+        if(!newTable)
+        {
+            // Keep an empty entry, which terminates the probing.
+            if(table->size + 1 >= table->capacity)
+                return;
+        }
+        else
+        {
+            for(size_t i = 0; i < table->capacity; ++i)
+            {
+                sysbvm_tuple_t oldSymbol = atomic_load_explicit(&table->entries[i].symbol, memory_order_relaxed);
+                if(oldSymbol)
+                    sysbvm_symbolTable_insertNoCheck(newTable, table->entries[i].hash, oldSymbol);
+            }
+
+            atomic_store_explicit(&context->symbolTable, newTable, memory_order_release);
+            table->nextRetiredTable = context->retiredSymbolTables;
+            context->retiredSymbolTables = table;
+            table = newTable;
+        }
+    }
+
+    sysbvm_symbolTable_insertNoCheck(table, hash, symbol);
+}
+
+void sysbvm_symbol_releaseRetiredTables(sysbvm_context_t *context)
+{
+    while(context->retiredSymbolTables)
+    {
+        sysbvm_symbolTable_t *retiredTable = context->retiredSymbolTables;
+        context->retiredSymbolTables = retiredTable->nextRetiredTable;
+        free(retiredTable);
+    }
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_symbol_internWithString(sysbvm_context_t *context, size_t stringSize, const char *string)
 {
+    size_t hash = sysbvm_string_computeHashWithBytes(stringSize, (const uint8_t*)string);
+    sysbvm_symbolTable_t *table = atomic_load_explicit(&context->symbolTable, memory_order_acquire);
+    if(table)
+    {
+        sysbvm_tuple_t existent = sysbvm_symbolTable_find(table, hash, stringSize, string);
+        if(existent)
+            return existent;
+    }
+
+    // The candidate symbol is allocated before taking the lock, so that an allocation error cannot leave the lock taken.
+    sysbvm_object_tuple_t *candidateSymbol = sysbvm_context_allocateByteTuple(context, context->roots.stringSymbolType, stringSize);
+    if(!candidateSymbol)
+        return SYSBVM_NULL_TUPLE;
+
+    // In the case of symbols, make the identity hash match with the string hash.
+    sysbvm_tuple_setIdentityHash(candidateSymbol, hash);
+    memcpy(candidateSymbol->bytes, string, stringSize);
+
+    // Another thread may have interned the symbol meanwhile. It may also have been interned in the set by the Sysmel side without being published in the table.
+    while(atomic_flag_test_and_set_explicit(&context->symbolTableLock, memory_order_acquire))
+        ;
+
+    table = atomic_load_explicit(&context->symbolTable, memory_order_relaxed);
+    sysbvm_tuple_t result = table ? sysbvm_symbolTable_find(table, hash, stringSize, string) : SYSBVM_NULL_TUPLE;
+    if(!result)
     {
         sysbvm_stringSlice_t stringSlice = {
             .elements = string,
             .size = stringSize
         };
 
-        sysbvm_tuple_t existent;
-        if(sysbvm_identitySet_findWithExplicitHash(context, context->roots.internedSymbolSet, &stringSlice, sysbvm_stringSliceSymbol_hashFunction, sysbvm_stringSlice_equalsFunction, &existent))
-            return existent;
-    }
-
-    sysbvm_object_tuple_t *result = sysbvm_context_allocateByteTuple(context, context->roots.stringSymbolType, stringSize);
-    if(!result) return 0;
+        if(!sysbvm_identitySet_findWithExplicitHash(context, context->roots.internedSymbolSet, &stringSlice, sysbvm_stringSliceSymbol_hashFunction, sysbvm_stringSlice_equalsFunction, &result))
+        {
+            result = (sysbvm_tuple_t)candidateSymbol;
+            sysbvm_identitySet_insert(context, context->roots.internedSymbolSet, result);
+        }
 
-    // In the case of symbols, make the identity hash match with the string hash.
-    sysbvm_tuple_setIdentityHash(result, sysbvm_string_computeHashWithBytes(stringSize, (const uint8_t*)string));
+        sysbvm_symbol_addToTable(context, hash, result);
+    }
 
-    memcpy(result->bytes, string, stringSize);
-    sysbvm_identitySet_insert(context, context->roots.internedSymbolSet, (sysbvm_tuple_t)result);
-    return (sysbvm_tuple_t)result;
+    atomic_flag_clear_explicit(&context->symbolTableLock, memory_order_release);
+    return result;
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_symbol_internFromTuple(sysbvm_context_t *context, sysbvm_tuple_t byteTuple)
@@ -159,12 +270,39 @@ SYSBVM_API sysbvm_tuple_t sysbvm_symbol_internWithCString(sysbvm_context_t *cont
     return sysbvm_symbol_internWithString(context, strlen(cstring), cstring);
 }
 
+// Powers of the hash multiplication constant. They are folded by the compiler with wrap around size_t arithmetic.
+#define SYSBVM_STRING_HASH_POWER_1 SYSBVM_HASH_MULTIPLICATION_CONSTANT
+#define SYSBVM_STRING_HASH_POWER_2 (SYSBVM_STRING_HASH_POWER_1 * SYSBVM_STRING_HASH_POWER_1)
+#define SYSBVM_STRING_HASH_POWER_3 (SYSBVM_STRING_HASH_POWER_2 * SYSBVM_STRING_HASH_POWER_1)
+#define SYSBVM_STRING_HASH_POWER_4 (SYSBVM_STRING_HASH_POWER_2 * SYSBVM_STRING_HASH_POWER_2)
+#define SYSBVM_STRING_HASH_POWER_5 (SYSBVM_STRING_HASH_POWER_4 * SYSBVM_STRING_HASH_POWER_1)
+#define SYSBVM_STRING_HASH_POWER_6 (SYSBVM_STRING_HASH_POWER_4 * SYSBVM_STRING_HASH_POWER_2)
+#define SYSBVM_STRING_HASH_POWER_7 (SYSBVM_STRING_HASH_POWER_4 * SYSBVM_STRING_HASH_POWER_3)
+#define SYSBVM_STRING_HASH_POWER_8 (SYSBVM_STRING_HASH_POWER_4 * SYSBVM_STRING_HASH_POWER_4)
+
+// Strings shorter than this are cheaper to hash again than to look up in the hash cache.
+#define SYSBVM_STRING_HASH_CACHE_MINIMUM_SIZE 32
+
 SYSBVM_API size_t sysbvm_string_computeHashWithBytes(size_t size, const uint8_t *bytes)
 {
-    size_t result = sysbvm_hashMultiply(1);
-    for(size_t i = 0; i < size; ++i)
-        result = sysbvm_hashConcatenate(result, bytes[i]);
-    return result;
+    // The hash is the polynomial (((1*C + b0)*C + b1)*C + ...) modulo the hash bit mask, which is a power of two,
+    // so it can be evaluated with wrap around arithmetic and masked once at the end. Expanding eight steps at a
+    // time replaces the chain of dependent multiplications with independent ones.
+    size_t result = SYSBVM_HASH_MULTIPLICATION_CONSTANT;
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8)
+    {
+        const uint8_t *word = bytes + i;
+        result = result * SYSBVM_STRING_HASH_POWER_8
+            + word[0] * SYSBVM_STRING_HASH_POWER_7 + word[1] * SYSBVM_STRING_HASH_POWER_6
+            + word[2] * SYSBVM_STRING_HASH_POWER_5 + word[3] * SYSBVM_STRING_HASH_POWER_4
+            + word[4] * SYSBVM_STRING_HASH_POWER_3 + word[5] * SYSBVM_STRING_HASH_POWER_2
+            + word[6] * SYSBVM_STRING_HASH_POWER_1 + (size_t)word[7];
+    }
+
+    for(; i < size; ++i)
+        result = result * SYSBVM_HASH_MULTIPLICATION_CONSTANT + bytes[i];
+    return result & SYSBVM_HASH_BIT_MASK;
 }
 
 static size_t sysbvm_stringSliceSymbol_hashFunction(sysbvm_context_t *context, void *element)
@@ -182,6 +320,47 @@ SYSBVM_API size_t sysbvm_string_hash(sysbvm_tuple_t string)
     return sysbvm_string_computeHashWithBytes(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes);
 }
 
+SYSBVM_API size_t sysbvm_string_hashWithCache(sysbvm_context_t *context, sysbvm_tuple_t string)
+{
+    if(!sysbvm_tuple_isNonNullPointer(string))
+        return 0;
+
+    // Only the immutable strings can keep their hash.
+    size_t size = sysbvm_tuple_getSizeInBytes(string);
+    if(size < SYSBVM_STRING_HASH_CACHE_MINIMUM_SIZE || !sysbvm_tuple_isImmutable(string))
+        return sysbvm_string_computeHashWithBytes(size, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes);
+
+    sysbvm_stringHashCacheEntry_t *entry = context->stringHashCache + (sysbvm_tuple_identityHash(string) & (STRING_HASH_CACHE_ENTRY_COUNT - 1));
+    unsigned int entrySequence = atomic_load_explicit(&entry->sequence, memory_order_acquire);
+    if((entrySequence & 1) == 0 && entry->string == string)
+    {
+        size_t cachedHash = entry->hash;
+        atomic_thread_fence(memory_order_acquire);
+        if(atomic_load_explicit(&entry->sequence, memory_order_relaxed) == entrySequence)
+            return cachedHash;
+    }
+
+    size_t hash = sysbvm_string_computeHashWithBytes(size, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes);
+
+    // Concurrent writers skip the fill instead of waiting.
+    if((entrySequence & 1) == 0
+        && atomic_compare_exchange_strong_explicit(&entry->sequence, &entrySequence, entrySequence + 1, memory_order_acquire, memory_order_relaxed))
+    {
+        atomic_thread_fence(memory_order_release);
+        entry->string = string;
+        entry->hash = hash;
+        atomic_store_explicit(&entry->sequence, entrySequence + 2, memory_order_release);
+    }
+
+    return hash;
+}
+
+void sysbvm_string_flushHashCache(sysbvm_context_t *context)
+{
+    for(size_t i = 0; i < STRING_HASH_CACHE_ENTRY_COUNT; ++i)
+        context->stringHashCache[i].string = SYSBVM_NULL_TUPLE;
+}
+
 SYSBVM_API bool sysbvm_string_equals(sysbvm_tuple_t a, sysbvm_tuple_t b)
 {
     if(a == b)
@@ -232,7 +411,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_string_primitive_hash(sysbvm_context_t *context
 {
     (void)closure;
     (void)argumentCount;
-    return sysbvm_tuple_size_encode(context, sysbvm_string_hash(arguments[0]));
+    return sysbvm_tuple_size_encode(context, sysbvm_string_hashWithCache(context, arguments[0]));
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_string_primitive_equals(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
@@ -361,6 +540,122 @@ static sysbvm_tuple_t sysbvm_string_primitive_withoutSuffix(sysbvm_context_t *co
     return sysbvm_string_createWithString(context, stringSize - suffixLen, (const char*)(stringData));
 }
 
+static void sysbvm_string_checkBytesArgument(sysbvm_tuple_t argument)
+{
+    if(!sysbvm_tuple_isBytes(argument))
+        sysbvm_error("Expected a byte sequence.");
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_indexOfByteStartingAt(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 3) sysbvm_error_argumentCountMismatch(3, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    return sysbvm_tuple_intptr_encode(context, sysbvm_string_indexOfByte(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes, sysbvm_tuple_uint8_decode(arguments[1]), sysbvm_tuple_size_decode(arguments[2])));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_lastIndexOfByte(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    return sysbvm_tuple_intptr_encode(context, sysbvm_string_lastIndexOfByte(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes, sysbvm_tuple_uint8_decode(arguments[1])));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_occurrencesOfByte(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    return sysbvm_tuple_size_encode(context, sysbvm_string_countByte(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes, sysbvm_tuple_uint8_decode(arguments[1])));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_indexOfBytesStartingAt(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 3) sysbvm_error_argumentCountMismatch(3, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    sysbvm_tuple_t pattern = arguments[1];
+    sysbvm_string_checkBytesArgument(pattern);
+    return sysbvm_tuple_intptr_encode(context, sysbvm_string_indexOfSubstring(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes,
+        sysbvm_tuple_getSizeInBytes(pattern), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(pattern)->bytes, sysbvm_tuple_size_decode(arguments[2])));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_lastIndexOfBytes(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    sysbvm_tuple_t pattern = arguments[1];
+    sysbvm_string_checkBytesArgument(pattern);
+    return sysbvm_tuple_intptr_encode(context, sysbvm_string_lastIndexOfSubstring(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes,
+        sysbvm_tuple_getSizeInBytes(pattern), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(pattern)->bytes));
+}
+
+static sysbvm_tuple_t sysbvm_string_indexOfByteInClassWithArguments(sysbvm_context_t *context, size_t argumentCount, sysbvm_tuple_t *arguments, bool isMember)
+{
+    if(argumentCount != 3) sysbvm_error_argumentCountMismatch(3, argumentCount);
+
+    sysbvm_tuple_t string = arguments[0];
+    sysbvm_tuple_t byteClass = arguments[1];
+    sysbvm_string_checkBytesArgument(byteClass);
+    return sysbvm_tuple_intptr_encode(context, sysbvm_string_indexOfByteInClass(sysbvm_tuple_getSizeInBytes(string), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes,
+        sysbvm_tuple_getSizeInBytes(byteClass), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(byteClass)->bytes, isMember, sysbvm_tuple_size_decode(arguments[2])));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_indexOfByteInStartingAt(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    return sysbvm_string_indexOfByteInClassWithArguments(context, argumentCount, arguments, true);
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_indexOfByteNotInStartingAt(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    return sysbvm_string_indexOfByteInClassWithArguments(context, argumentCount, arguments, false);
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_compare(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_tuple_t first = arguments[0];
+    sysbvm_tuple_t second = arguments[1];
+    sysbvm_string_checkBytesArgument(second);
+    return sysbvm_tuple_int32_encode(context, sysbvm_string_compareBytes(sysbvm_tuple_getSizeInBytes(first), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(first)->bytes,
+        sysbvm_tuple_getSizeInBytes(second), SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(second)->bytes));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_equalsBytes(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)context;
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_string_checkBytesArgument(arguments[1]);
+    return sysbvm_tuple_boolean_encode(sysbvm_string_equals(arguments[0], arguments[1]));
+}
+
+static sysbvm_tuple_t sysbvm_string_primitive_equalsIgnoringCase(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)context;
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_tuple_t first = arguments[0];
+    sysbvm_tuple_t second = arguments[1];
+    sysbvm_string_checkBytesArgument(second);
+    size_t size = sysbvm_tuple_getSizeInBytes(first);
+    return sysbvm_tuple_boolean_encode(size == sysbvm_tuple_getSizeInBytes(second)
+        && sysbvm_string_equalsIgnoringCase(size, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(first)->bytes, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(second)->bytes));
+}
+
 static sysbvm_tuple_t sysbvm_symbol_primitive_intern(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
 {
     (void)context;
@@ -380,6 +675,16 @@ void sysbvm_string_registerPrimitives(void)
     sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_concat, "String::--");
     sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_withoutSuffix, "String::withoutSuffix:");
     sysbvm_primitiveTable_registerFunction(sysbvm_symbol_primitive_intern, "String::intern");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_indexOfByteStartingAt, "String::indexOfByte:startingAt:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_lastIndexOfByte, "String::lastIndexOfByte:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_occurrencesOfByte, "String::occurrencesOfByte:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_indexOfBytesStartingAt, "String::indexOfBytes:startingAt:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_lastIndexOfBytes, "String::lastIndexOfBytes:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_indexOfByteInStartingAt, "String::indexOfByteIn:startingAt:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_indexOfByteNotInStartingAt, "String::indexOfByteNotIn:startingAt:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_compare, "String::<=>");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_equalsBytes, "String::equalsStringSymbol:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_string_primitive_equalsIgnoringCase, "String::equalsIgnoringCase:");
 }
 
 void sysbvm_string_setupPrimitives(sysbvm_context_t *context)
@@ -402,4 +707,22 @@ void sysbvm_string_setupPrimitives(sysbvm_context_t *context)
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "--", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_concat);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "withoutSuffix:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_withoutSuffix);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "asSymbol", 1, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_symbol_primitive_intern);
+
+    // Byte searching primitives, which are shared by the strings and the byte arrays.
+    sysbvm_tuple_t byteSequenceTypes[] = {context->roots.stringType, context->roots.byteArrayType};
+    for(size_t i = 0; i < sizeof(byteSequenceTypes) / sizeof(byteSequenceTypes[0]); ++i)
+    {
+        sysbvm_tuple_t type = byteSequenceTypes[i];
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "indexOfByte:startingAt:", 3, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_indexOfByteStartingAt);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "lastIndexOfByte:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_lastIndexOfByte);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "occurrencesOfByte:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_occurrencesOfByte);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "indexOfBytes:startingAt:", 3, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_indexOfBytesStartingAt);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "lastIndexOfBytes:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_lastIndexOfBytes);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "indexOfByteIn:startingAt:", 3, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_indexOfByteInStartingAt);
+        sysbvm_context_setIntrinsicPrimitiveMethod(context, type, "indexOfByteNotIn:startingAt:", 3, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_indexOfByteNotInStartingAt);
+    }
+
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "<=>", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE, NULL, sysbvm_string_primitive_compare);
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "equalsStringSymbol:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_equalsBytes);
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.stringType, "equalsIgnoringCase:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_PURE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_string_primitive_equalsIgnoringCase);
 }
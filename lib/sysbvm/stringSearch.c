@@ -0,0 +1,332 @@
+#include "sysbvm/string.h"
+#include "sysbvm/integer.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SYSBVM_STRING_SEARCH_USE_SSE2 1
+
+// The AVX2 variants are compiled for their own target, and selected at runtime.
+#   if defined(__GNUC__) && !defined(_MSC_VER)
+#       include <immintrin.h>
+#       define SYSBVM_STRING_SEARCH_USE_AVX2 1
+#       define SYSBVM_STRING_SEARCH_AVX2_FUNCTION __attribute__((target("avx2")))
+#   endif
+#endif
+
+#ifdef SYSBVM_STRING_SEARCH_USE_AVX2
+static bool sysbvm_string_hasAVX2(void)
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+SYSBVM_STRING_SEARCH_AVX2_FUNCTION static size_t sysbvm_string_indexOfByteAVX2(size_t size, const uint8_t *bytes, uint8_t byte, size_t startIndex)
+{
+    __m256i pattern = _mm256_set1_epi8((char)byte);
+    size_t i = startIndex;
+    for(; i + 32 <= size; i += 32)
+    {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(bytes + i)), pattern));
+        if(mask)
+            return i + sysbvm_uint32_lowBit(mask) - 1;
+    }
+
+    return i;
+}
+
+SYSBVM_STRING_SEARCH_AVX2_FUNCTION static size_t sysbvm_string_countByteAVX2(size_t size, const uint8_t *bytes, uint8_t byte, size_t *outCount)
+{
+    __m256i pattern = _mm256_set1_epi8((char)byte);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i totals = zero;
+    size_t i = 0;
+    while(i + 32 <= size)
+    {
+        // The byte counters are flushed before they can overflow.
+        __m256i counters = zero;
+        for(size_t j = 0; j < 255 && i + 32 <= size; ++j, i += 32)
+            counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(bytes + i)), pattern));
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(counters, zero));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, totals);
+    *outCount = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return i;
+}
+
+SYSBVM_STRING_SEARCH_AVX2_FUNCTION static size_t sysbvm_string_mismatchIndexAVX2(size_t size, const uint8_t *first, const uint8_t *second)
+{
+    size_t i = 0;
+    for(; i + 32 <= size; i += 32)
+    {
+        __m256i equals = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(first + i)), _mm256_loadu_si256((const __m256i*)(second + i)));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(equals);
+        if(mask)
+            return i + sysbvm_uint32_lowBit(mask) - 1;
+    }
+
+    return i;
+}
+
+SYSBVM_STRING_SEARCH_AVX2_FUNCTION static size_t sysbvm_string_indexOfSubstringAVX2(size_t size, const uint8_t *bytes, size_t substringSize, const uint8_t *substring, size_t startIndex, intptr_t *outFoundIndex)
+{
+    // Filter the candidates by their first and last bytes before comparing them.
+    __m256i firstPattern = _mm256_set1_epi8((char)substring[0]);
+    __m256i lastPattern = _mm256_set1_epi8((char)substring[substringSize - 1]);
+    size_t i = startIndex;
+    for(; i + substringSize - 1 + 32 <= size; i += 32)
+    {
+        __m256i firstBlock = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        __m256i lastBlock = _mm256_loadu_si256((const __m256i*)(bytes + i + substringSize - 1));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(firstBlock, firstPattern), _mm256_cmpeq_epi8(lastBlock, lastPattern)));
+        while(mask)
+        {
+            size_t candidate = i + sysbvm_uint32_lowBit(mask) - 1;
+            if(memcmp(bytes + candidate + 1, substring + 1, substringSize - 2) == 0)
+            {
+                *outFoundIndex = (intptr_t)candidate;
+                return i;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    return i;
+}
+#endif
+
+SYSBVM_API intptr_t sysbvm_string_indexOfByte(size_t size, const uint8_t *bytes, uint8_t byte, size_t startIndex)
+{
+    size_t i = startIndex;
+#ifdef SYSBVM_STRING_SEARCH_USE_AVX2
+    if(sysbvm_string_hasAVX2())
+        i = sysbvm_string_indexOfByteAVX2(size, bytes, byte, i);
+#endif
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    __m128i pattern = _mm_set1_epi8((char)byte);
+    for(; i + 16 <= size; i += 16)
+    {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)), pattern));
+        if(mask)
+            return (intptr_t)(i + sysbvm_uint32_lowBit(mask) - 1);
+    }
+#endif
+
+    for(; i < size; ++i)
+    {
+        if(bytes[i] == byte)
+            return (intptr_t)i;
+    }
+
+    return -1;
+}
+
+SYSBVM_API intptr_t sysbvm_string_lastIndexOfByte(size_t size, const uint8_t *bytes, uint8_t byte)
+{
+    size_t end = size;
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    __m128i pattern = _mm_set1_epi8((char)byte);
+    for(; end >= 16; end -= 16)
+    {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(bytes + end - 16)), pattern));
+        if(mask)
+            return (intptr_t)(end - 16 + sysbvm_uint32_highBit(mask) - 1);
+    }
+#endif
+
+    while(end > 0)
+    {
+        --end;
+        if(bytes[end] == byte)
+            return (intptr_t)end;
+    }
+
+    return -1;
+}
+
+SYSBVM_API size_t sysbvm_string_countByte(size_t size, const uint8_t *bytes, uint8_t byte)
+{
+    size_t count = 0;
+    size_t i = 0;
+#ifdef SYSBVM_STRING_SEARCH_USE_AVX2
+    if(sysbvm_string_hasAVX2())
+        i = sysbvm_string_countByteAVX2(size, bytes, byte, &count);
+#endif
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    __m128i pattern = _mm_set1_epi8((char)byte);
+    __m128i zero = _mm_setzero_si128();
+    while(i + 16 <= size)
+    {
+        // The byte counters are flushed before they can overflow.
+        __m128i counters = zero;
+        for(size_t j = 0; j < 255 && i + 16 <= size; ++j, i += 16)
+            counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)), pattern));
+
+        __m128i sums = _mm_sad_epu8(counters, zero);
+        count += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+#endif
+
+    for(; i < size; ++i)
+        count += bytes[i] == byte;
+    return count;
+}
+
+SYSBVM_API intptr_t sysbvm_string_indexOfSubstring(size_t size, const uint8_t *bytes, size_t substringSize, const uint8_t *substring, size_t startIndex)
+{
+    if(substringSize == 0)
+        return startIndex <= size ? (intptr_t)startIndex : -1;
+    if(startIndex >= size || size - startIndex < substringSize)
+        return -1;
+    if(substringSize == 1)
+        return sysbvm_string_indexOfByte(size, bytes, substring[0], startIndex);
+
+    size_t i = startIndex;
+#ifdef SYSBVM_STRING_SEARCH_USE_AVX2
+    if(sysbvm_string_hasAVX2())
+    {
+        intptr_t foundIndex = -1;
+        i = sysbvm_string_indexOfSubstringAVX2(size, bytes, substringSize, substring, i, &foundIndex);
+        if(foundIndex >= 0)
+            return foundIndex;
+    }
+#endif
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    // Filter the candidates by their first and last bytes before comparing them.
+    __m128i firstPattern = _mm_set1_epi8((char)substring[0]);
+    __m128i lastPattern = _mm_set1_epi8((char)substring[substringSize - 1]);
+    for(; i + substringSize - 1 + 16 <= size; i += 16)
+    {
+        __m128i firstBlock = _mm_loadu_si128((const __m128i*)(bytes + i));
+        __m128i lastBlock = _mm_loadu_si128((const __m128i*)(bytes + i + substringSize - 1));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstPattern), _mm_cmpeq_epi8(lastBlock, lastPattern)));
+        while(mask)
+        {
+            size_t candidate = i + sysbvm_uint32_lowBit(mask) - 1;
+            if(memcmp(bytes + candidate + 1, substring + 1, substringSize - 2) == 0)
+                return (intptr_t)candidate;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for(; i + substringSize <= size; ++i)
+    {
+        if(bytes[i] == substring[0] && memcmp(bytes + i + 1, substring + 1, substringSize - 1) == 0)
+            return (intptr_t)i;
+    }
+
+    return -1;
+}
+
+SYSBVM_API intptr_t sysbvm_string_lastIndexOfSubstring(size_t size, const uint8_t *bytes, size_t substringSize, const uint8_t *substring)
+{
+    if(substringSize > size)
+        return -1;
+    if(substringSize == 0)
+        return (intptr_t)size;
+
+    // Scan backwards for the first byte, in the prefix where a whole match still fits.
+    size_t searchSize = size - substringSize + 1;
+    for(;;)
+    {
+        intptr_t candidate = sysbvm_string_lastIndexOfByte(searchSize, bytes, substring[0]);
+        if(candidate < 0)
+            return -1;
+        if(memcmp(bytes + candidate + 1, substring + 1, substringSize - 1) == 0)
+            return candidate;
+        searchSize = (size_t)candidate;
+    }
+}
+
+SYSBVM_API size_t sysbvm_string_mismatchIndex(size_t size, const uint8_t *first, const uint8_t *second)
+{
+    size_t i = 0;
+#ifdef SYSBVM_STRING_SEARCH_USE_AVX2
+    if(sysbvm_string_hasAVX2())
+        i = sysbvm_string_mismatchIndexAVX2(size, first, second);
+#endif
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    for(; i + 16 <= size; i += 16)
+    {
+        __m128i equals = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(first + i)), _mm_loadu_si128((const __m128i*)(second + i)));
+        uint32_t mask = ~(uint32_t)_mm_movemask_epi8(equals) & 0xFFFF;
+        if(mask)
+            return i + sysbvm_uint32_lowBit(mask) - 1;
+    }
+#endif
+
+    for(; i < size; ++i)
+    {
+        if(first[i] != second[i])
+            return i;
+    }
+
+    return size;
+}
+
+SYSBVM_API int32_t sysbvm_string_compareBytes(size_t firstSize, const uint8_t *first, size_t secondSize, const uint8_t *second)
+{
+    size_t commonSize = firstSize < secondSize ? firstSize : secondSize;
+    size_t mismatchIndex = sysbvm_string_mismatchIndex(commonSize, first, second);
+    if(mismatchIndex < commonSize)
+        return first[mismatchIndex] < second[mismatchIndex] ? -1 : 1;
+    if(firstSize == secondSize)
+        return 0;
+    return firstSize < secondSize ? -1 : 1;
+}
+
+static uint8_t sysbvm_string_asciiLowercase(uint8_t byte)
+{
+    return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+}
+
+SYSBVM_API bool sysbvm_string_equalsIgnoringCase(size_t size, const uint8_t *first, const uint8_t *second)
+{
+    size_t i = 0;
+#ifdef SYSBVM_STRING_SEARCH_USE_SSE2
+    // Lowercase both blocks by adding 32 to the bytes in the signed range of 'A' to 'Z'.
+    __m128i upperBegin = _mm_set1_epi8('A' - 1);
+    __m128i upperEnd = _mm_set1_epi8('Z' + 1);
+    __m128i caseBit = _mm_set1_epi8('a' - 'A');
+    for(; i + 16 <= size; i += 16)
+    {
+        __m128i firstBlock = _mm_loadu_si128((const __m128i*)(first + i));
+        __m128i secondBlock = _mm_loadu_si128((const __m128i*)(second + i));
+        __m128i firstIsUpper = _mm_and_si128(_mm_cmpgt_epi8(firstBlock, upperBegin), _mm_cmplt_epi8(firstBlock, upperEnd));
+        __m128i secondIsUpper = _mm_and_si128(_mm_cmpgt_epi8(secondBlock, upperBegin), _mm_cmplt_epi8(secondBlock, upperEnd));
+        firstBlock = _mm_add_epi8(firstBlock, _mm_and_si128(firstIsUpper, caseBit));
+        secondBlock = _mm_add_epi8(secondBlock, _mm_and_si128(secondIsUpper, caseBit));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(firstBlock, secondBlock)) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    for(; i < size; ++i)
+    {
+        if(sysbvm_string_asciiLowercase(first[i]) != sysbvm_string_asciiLowercase(second[i]))
+            return false;
+    }
+
+    return true;
+}
+
+SYSBVM_API intptr_t sysbvm_string_indexOfByteInClass(size_t size, const uint8_t *bytes, size_t classSize, const uint8_t *classBytes, bool isMember, size_t startIndex)
+{
+    // A single byte is searched with the vectorized path.
+    if(isMember && classSize == 1)
+        return sysbvm_string_indexOfByte(size, bytes, classBytes[0], startIndex);
+
+    bool byteClass[256] = {0};
+    for(size_t i = 0; i < classSize; ++i)
+        byteClass[classBytes[i]] = true;
+
+    for(size_t i = startIndex; i < size; ++i)
+    {
+        if(byteClass[bytes[i]] == isMember)
+            return (intptr_t)i;
+    }
+
+    return -1;
+}
@@ -2,32 +2,46 @@
 #include "sysbvm/array.h"
 #include "sysbvm/errors.h"
 #include "sysbvm/function.h"
+#include "sysbvm/orderedCollection.h"
+#include "sysbvm/stackFrame.h"
 #include "sysbvm/string.h"
 #include "internal/context.h"
 #include <string.h>
 
+#define SYSBVM_STRING_STREAM_MINIMUM_CHUNK_SIZE 16
+#define SYSBVM_STRING_STREAM_MAXIMUM_CHUNK_SIZE (64*1024)
+
 SYSBVM_API sysbvm_tuple_t sysbvm_stringStream_create(sysbvm_context_t *context)
 {
     sysbvm_stringStream_t *result = (sysbvm_stringStream_t*)sysbvm_context_allocatePointerTuple(context, context->roots.stringStreamType, SYSBVM_SLOT_COUNT_FOR_STRUCTURE_TYPE(sysbvm_stringStream_t));
     result->size = sysbvm_tuple_size_encode(context, 0);
+    result->chunkedSize = sysbvm_tuple_size_encode(context, 0);
     return (sysbvm_tuple_t)result;
 }
 
-static void sysbvm_stringStream_increaseCapacityToAtLeast(sysbvm_context_t *context, sysbvm_tuple_t stringStream, size_t requiredCapacity)
+static void sysbvm_stringStream_startNewChunk(sysbvm_context_t *context, sysbvm_tuple_t stringStream, size_t requiredCapacity)
 {
+    // The current chunk is full, so it is moved into the chunk list instead of being copied.
     sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
     size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
-    size_t oldCapacity = sysbvm_tuple_getSizeInBytes(stringStreamObject->storage);
-    size_t newCapacity = oldCapacity * 2;
-    if(newCapacity < 16)
-        newCapacity = 16;
-    while(newCapacity < requiredCapacity)
-        newCapacity *= 2;
-
-    sysbvm_object_tuple_t *newStorage = (sysbvm_object_tuple_t*)sysbvm_string_createEmptyWithSize(context, newCapacity);
-    sysbvm_object_tuple_t *oldStorage = (sysbvm_object_tuple_t*)stringStreamObject->storage;
-    memcpy(newStorage->bytes, oldStorage->bytes, size);
-    stringStreamObject->storage = (sysbvm_tuple_t)newStorage;
+    if(sysbvm_tuple_getSizeInBytes(stringStreamObject->storage) != 0)
+    {
+        if(!sysbvm_tuple_isNonNullPointer(stringStreamObject->chunks))
+            stringStreamObject->chunks = sysbvm_orderedCollection_create(context);
+        sysbvm_orderedCollection_add(context, stringStreamObject->chunks, stringStreamObject->storage);
+        stringStreamObject->chunkedSize = sysbvm_tuple_size_encode(context, size);
+    }
+
+    // Grow the chunks geometrically until they reach the maximum chunk size.
+    size_t newCapacity = size;
+    if(newCapacity < SYSBVM_STRING_STREAM_MINIMUM_CHUNK_SIZE)
+        newCapacity = SYSBVM_STRING_STREAM_MINIMUM_CHUNK_SIZE;
+    if(newCapacity > SYSBVM_STRING_STREAM_MAXIMUM_CHUNK_SIZE)
+        newCapacity = SYSBVM_STRING_STREAM_MAXIMUM_CHUNK_SIZE;
+    if(newCapacity < requiredCapacity)
+        newCapacity = requiredCapacity;
+
+    stringStreamObject->storage = sysbvm_string_createEmptyWithSize(context, newCapacity);
 }
 
 SYSBVM_API void sysbvm_stringStream_nextPut(sysbvm_context_t *context, sysbvm_tuple_t stringStream, uint8_t character)
@@ -37,15 +51,16 @@ SYSBVM_API void sysbvm_stringStream_nextPut(sysbvm_context_t *context, sysbvm_tu
 
     sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
     size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
-    size_t capacity = sysbvm_tuple_getSizeInBytes(stringStreamObject->storage);
-    size_t requiredCapacity = size + 1;
-    if(requiredCapacity > capacity)
-        sysbvm_stringStream_increaseCapacityToAtLeast(context, stringStream, requiredCapacity);
+    size_t chunkOffset = size - sysbvm_tuple_size_decode(stringStreamObject->chunkedSize);
+    if(chunkOffset >= sysbvm_tuple_getSizeInBytes(stringStreamObject->storage))
+    {
+        sysbvm_stringStream_startNewChunk(context, stringStream, 1);
+        chunkOffset = 0;
+    }
 
     sysbvm_object_tuple_t *storage = (sysbvm_object_tuple_t*)stringStreamObject->storage;
-    storage->bytes[size] = character;
+    storage->bytes[chunkOffset] = character;
     stringStreamObject->size = sysbvm_tuple_size_encode(context, size + 1);
-
 }
 
 SYSBVM_API void sysbvm_stringStream_nextPutStringWithSize(sysbvm_context_t *context, sysbvm_tuple_t stringStream, size_t stringSize, const char *string)
@@ -55,14 +70,28 @@ SYSBVM_API void sysbvm_stringStream_nextPutStringWithSize(sysbvm_context_t *cont
 
     sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
     size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
-    size_t capacity = sysbvm_tuple_getSizeInBytes(stringStreamObject->storage);
-    size_t requiredCapacity = size + stringSize;
-    if(requiredCapacity > capacity)
-        sysbvm_stringStream_increaseCapacityToAtLeast(context, stringStream, requiredCapacity);
+    size_t chunkOffset = size - sysbvm_tuple_size_decode(stringStreamObject->chunkedSize);
+    size_t chunkCapacity = sysbvm_tuple_getSizeInBytes(stringStreamObject->storage);
+
+    // Fill the remaining space in the current chunk.
+    size_t copySize = chunkCapacity - chunkOffset;
+    if(copySize > stringSize)
+        copySize = stringSize;
+    if(copySize > 0)
+    {
+        memcpy(SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(stringStreamObject->storage)->bytes + chunkOffset, string, copySize);
+        size += copySize;
+        stringStreamObject->size = sysbvm_tuple_size_encode(context, size);
+    }
+
+    // Put the rest of the string in a new chunk.
+    size_t remainingSize = stringSize - copySize;
+    if(remainingSize == 0)
+        return;
 
-    sysbvm_object_tuple_t *storage = (sysbvm_object_tuple_t*)stringStreamObject->storage;
-    memcpy(storage->bytes + size, string, stringSize);
-    stringStreamObject->size = sysbvm_tuple_size_encode(context, size + stringSize);
+    sysbvm_stringStream_startNewChunk(context, stringStream, remainingSize);
+    memcpy(SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(stringStreamObject->storage)->bytes, string + copySize, remainingSize);
+    stringStreamObject->size = sysbvm_tuple_size_encode(context, size + remainingSize);
 }
 
 SYSBVM_API void sysbvm_stringStream_nextPutString(sysbvm_context_t *context, sysbvm_tuple_t stringStream, sysbvm_tuple_t string)
@@ -78,6 +107,56 @@ SYSBVM_API void sysbvm_stringStream_nextPutCString(sysbvm_context_t *context, sy
     sysbvm_stringStream_nextPutStringWithSize(context, stringStream, strlen(cstring), cstring);
 }
 
+SYSBVM_API void sysbvm_stream_nextPutString(sysbvm_context_t *context, sysbvm_tuple_t stream, sysbvm_tuple_t string)
+{
+    if(sysbvm_tuple_getType(context, stream) == context->roots.stringStreamType)
+    {
+        sysbvm_stringStream_nextPutString(context, stream, string);
+        return;
+    }
+
+    sysbvm_tuple_send1(context, sysbvm_symbol_internWithCString(context, "nextPutAll:"), stream, string);
+}
+
+SYSBVM_API void sysbvm_stream_nextPutStringWithSize(sysbvm_context_t *context, sysbvm_tuple_t stream, size_t stringSize, const char *string)
+{
+    if(sysbvm_tuple_getType(context, stream) == context->roots.stringStreamType)
+    {
+        sysbvm_stringStream_nextPutStringWithSize(context, stream, stringSize, string);
+        return;
+    }
+
+    struct {
+        sysbvm_tuple_t stream;
+        sysbvm_tuple_t string;
+    } gcFrame = {
+        .stream = stream
+    };
+    SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
+    gcFrame.string = sysbvm_string_createWithString(context, stringSize, string);
+    sysbvm_stream_nextPutString(context, gcFrame.stream, gcFrame.string);
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+}
+
+static void sysbvm_stringStream_flattenInto(sysbvm_tuple_t stringStream, uint8_t *destination)
+{
+    sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
+    size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
+    size_t chunkedSize = sysbvm_tuple_size_decode(stringStreamObject->chunkedSize);
+
+    size_t chunkCount = sysbvm_orderedCollection_getSize(stringStreamObject->chunks);
+    for(size_t i = 0; i < chunkCount; ++i)
+    {
+        sysbvm_tuple_t chunk = sysbvm_orderedCollection_at(stringStreamObject->chunks, i);
+        size_t chunkSize = sysbvm_tuple_getSizeInBytes(chunk);
+        memcpy(destination, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(chunk)->bytes, chunkSize);
+        destination += chunkSize;
+    }
+
+    if(size > chunkedSize)
+        memcpy(destination, SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(stringStreamObject->storage)->bytes, size - chunkedSize);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_stringStream_asByteArray(sysbvm_context_t *context, sysbvm_tuple_t stringStream)
 {
     if(!sysbvm_tuple_isNonNullPointer(stringStream))
@@ -86,8 +165,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_stringStream_asByteArray(sysbvm_context_t *cont
     sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
     size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
     sysbvm_object_tuple_t *result = (sysbvm_object_tuple_t*)sysbvm_byteArray_create(context, size);
-    sysbvm_object_tuple_t *storage = (sysbvm_object_tuple_t*)stringStreamObject->storage;
-    memcpy(result->bytes, storage->bytes, size);
+    sysbvm_stringStream_flattenInto(stringStream, result->bytes);
     return (sysbvm_tuple_t)result;
 }
 
@@ -99,8 +177,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_stringStream_asString(sysbvm_context_t *context
     sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
     size_t size = sysbvm_tuple_size_decode(stringStreamObject->size);
     sysbvm_object_tuple_t *result = (sysbvm_object_tuple_t*)sysbvm_string_createEmptyWithSize(context, size);
-    sysbvm_object_tuple_t *storage = (sysbvm_object_tuple_t*)stringStreamObject->storage;
-    memcpy(result->bytes, storage->bytes, size);
+    sysbvm_stringStream_flattenInto(stringStream, result->bytes);
     return (sysbvm_tuple_t)result;
 }
 
@@ -118,7 +195,8 @@ SYSBVM_API size_t sysbvm_stringStream_getSize(sysbvm_tuple_t stringStream)
 SYSBVM_API size_t sysbvm_stringStream_getCapacity(sysbvm_tuple_t stringStream)
 {
     if(!sysbvm_tuple_isNonNullPointer(stringStream)) return 0;
-    return sysbvm_tuple_getSizeInSlots(((sysbvm_stringStream_t*)stringStream)->storage);
+    sysbvm_stringStream_t *stringStreamObject = (sysbvm_stringStream_t*)stringStream;
+    return sysbvm_tuple_size_decode(stringStreamObject->chunkedSize) + sysbvm_tuple_getSizeInBytes(stringStreamObject->storage);
 }
 
 static sysbvm_tuple_t sysbvm_stringStream_primitive_nextPut(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
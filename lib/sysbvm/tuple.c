@@ -54,14 +54,53 @@ SYSBVM_API sysbvm_tuple_t sysbvm_tuple_int64_encodeBig(sysbvm_context_t *context
     return (sysbvm_tuple_t)result;
 }
 
+SYSBVM_API sysbvm_tuple_comparisonKind_t sysbvm_tuple_getComparisonKindOfFunction(sysbvm_context_t *context, sysbvm_tuple_t function)
+{
+    if(!function)
+        return SYSBVM_TUPLE_COMPARISON_KIND_IDENTITY;
+    if(!sysbvm_tuple_isFunction(context, function))
+        return SYSBVM_TUPLE_COMPARISON_KIND_GENERIC;
+
+    // Methods are frequently copies of the root primitives, so compare their entry points instead of their identities.
+    sysbvm_function_t *functionObject = (sysbvm_function_t*)function;
+    if(!functionObject->primitiveTableIndex)
+        return SYSBVM_TUPLE_COMPARISON_KIND_GENERIC;
+
+    sysbvm_functionEntryPoint_t entryPoint = sysbvm_function_getNumberedPrimitiveEntryPoint(context, sysbvm_tuple_uint32_decode(functionObject->primitiveTableIndex));
+    if(entryPoint == sysbvm_tuple_primitive_identityEquals || entryPoint == sysbvm_tuple_primitive_identityHash)
+        return SYSBVM_TUPLE_COMPARISON_KIND_IDENTITY;
+    if(entryPoint == sysbvm_string_primitive_equals || entryPoint == sysbvm_string_primitive_hash)
+        return SYSBVM_TUPLE_COMPARISON_KIND_BYTES;
+    return SYSBVM_TUPLE_COMPARISON_KIND_GENERIC;
+}
+
+SYSBVM_API size_t sysbvm_tuple_hashWith(sysbvm_context_t *context, sysbvm_tuple_t hashFunction, sysbvm_tuple_comparisonKind_t hashKind, sysbvm_tuple_t tuple)
+{
+    switch(hashKind)
+    {
+    case SYSBVM_TUPLE_COMPARISON_KIND_IDENTITY: return sysbvm_tuple_identityHash(tuple);
+    case SYSBVM_TUPLE_COMPARISON_KIND_BYTES: return sysbvm_string_hashWithCache(context, tuple);
+    default: return sysbvm_tuple_size_decode(sysbvm_function_apply1(context, hashFunction, tuple));
+    }
+}
+
+SYSBVM_API bool sysbvm_tuple_equalsWith(sysbvm_context_t *context, sysbvm_tuple_t equalsFunction, sysbvm_tuple_comparisonKind_t equalsKind, sysbvm_tuple_t a, sysbvm_tuple_t b)
+{
+    switch(equalsKind)
+    {
+    case SYSBVM_TUPLE_COMPARISON_KIND_IDENTITY: return sysbvm_tuple_identityEquals(a, b);
+    case SYSBVM_TUPLE_COMPARISON_KIND_BYTES: return sysbvm_string_equals(a, b);
+    default: return sysbvm_tuple_boolean_decode(sysbvm_function_apply2(context, equalsFunction, a, b));
+    }
+}
+
 SYSBVM_API size_t sysbvm_tuple_hash(sysbvm_context_t *context, sysbvm_tuple_t tuple)
 {
     sysbvm_tuple_t type = sysbvm_tuple_getType(context, tuple);
     if(type)
     {
         sysbvm_tuple_t hashFunction = sysbvm_type_getHashFunction(context, type);
-        if(hashFunction)
-            return sysbvm_tuple_size_decode(sysbvm_function_apply1(context, hashFunction, tuple));
+        return sysbvm_tuple_hashWith(context, hashFunction, sysbvm_tuple_getComparisonKindOfFunction(context, hashFunction), tuple);
     }
 
     return sysbvm_tuple_identityHash(tuple);
@@ -73,8 +112,7 @@ SYSBVM_API bool sysbvm_tuple_equals(sysbvm_context_t *context, sysbvm_tuple_t a,
     if(type)
     {
         sysbvm_tuple_t equalsFunction = sysbvm_type_getEqualsFunction(context, type);
-        if(equalsFunction)
-            return sysbvm_tuple_boolean_decode(sysbvm_function_apply2(context, equalsFunction, a, b));
+        return sysbvm_tuple_equalsWith(context, equalsFunction, sysbvm_tuple_getComparisonKindOfFunction(context, equalsFunction), a, b);
     }
 
     return sysbvm_tuple_identityEquals(a, b);
@@ -356,7 +394,7 @@ bool sysbvm_tuple_isKindOf(sysbvm_context_t *context, sysbvm_tuple_t tuple, sysb
     sysbvm_tuple_t tupleType = sysbvm_tuple_getType(context, tuple);
     return tupleType == type
         || (!tupleType && type == context->roots.untypedType)
-        || sysbvm_type_isDirectSubtypeOf(tupleType, type);
+        || sysbvm_type_isSubtypeOf(context, tupleType, type);
 }
 
 SYSBVM_API bool sysbvm_tuple_isTypeSatisfiedWithValue(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t value)
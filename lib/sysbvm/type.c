@@ -15,6 +15,14 @@
 #include "internal/context.h"
 #include <string.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
 SYSBVM_API sysbvm_tuple_t sysbvm_typeSlot_create(sysbvm_context_t *context, sysbvm_tuple_t owner, sysbvm_tuple_t name, sysbvm_tuple_t flags, sysbvm_tuple_t type, size_t localIndex, size_t index)
 {
     sysbvm_typeSlot_t* result = (sysbvm_typeSlot_t*)sysbvm_context_allocatePointerTuple(context, context->roots.typeSlotType, SYSBVM_SLOT_COUNT_FOR_STRUCTURE_TYPE(sysbvm_typeSlot_t));
@@ -579,6 +587,7 @@ static sysbvm_tuple_t sysbvm_type_doCreateReferenceType(sysbvm_context_t *contex
     gcFrame.referenceToPointerFunction = sysbvm_pointerLikeType_createPointerLikeReinterpretCast(context, (sysbvm_tuple_t)gcFrame.result, gcFrame.pointerType, 0);
     sysbvm_type_setMethodWithSelector(context, (sysbvm_tuple_t)gcFrame.result, context->roots.addressSelector, gcFrame.referenceToPointerFunction);
 
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
     return (sysbvm_tuple_t)gcFrame.result;
 }
 
@@ -637,6 +646,7 @@ static sysbvm_tuple_t sysbvm_type_doCreateTemporaryReferenceType(sysbvm_context_
     gcFrame.temporaryReferenceToReferenceFunction = sysbvm_pointerLikeType_createPointerLikeReinterpretCast(context, (sysbvm_tuple_t)gcFrame.result, gcFrame.referenceType, 0);
     sysbvm_type_setMethodWithSelector(context, (sysbvm_tuple_t)gcFrame.result, context->roots.tempRefAsRefSelector, gcFrame.temporaryReferenceToReferenceFunction);
 
+    SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
     return (sysbvm_tuple_t)gcFrame.result;
 }
 
@@ -791,9 +801,240 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupMacroSelector(sysbvm_context_t *cont
     return sysbvm_type_lookupMacroSelector(context, sysbvm_type_getSupertype(type), selector);
 }
 
-static inline size_t computeLookupCacheEntryIndexFor(sysbvm_tuple_t type, sysbvm_tuple_t selector)
+static inline sysbvm_globalLookupCacheSet_t *computeLookupCacheSelectorGroupFor(sysbvm_context_t *context, sysbvm_tuple_t selector)
 {
-    return sysbvm_hashConcatenate(sysbvm_tuple_identityHash(type), sysbvm_tuple_identityHash(selector)) % GLOBAL_LOOKUP_CACHE_ENTRY_COUNT;
+    size_t groupSetCount = context->globalMethodLookupCacheSelectorGroupSetCount;
+    size_t groupCount = context->globalMethodLookupCacheSetCount / groupSetCount;
+    size_t groupIndex = sysbvm_tuple_identityHash(selector) & (groupCount - 1);
+    return context->globalMethodLookupCache + groupIndex * groupSetCount;
+}
+
+static inline sysbvm_globalLookupCacheSet_t *computeLookupCacheSetFor(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
+{
+    // The entries of a selector are confined to its group of sets, so that flushing it does not require scanning the whole cache.
+    size_t setIndexInGroup = sysbvm_hashConcatenate(sysbvm_tuple_identityHash(selector), sysbvm_tuple_identityHash(type)) & (context->globalMethodLookupCacheSelectorGroupSetCount - 1);
+    return computeLookupCacheSelectorGroupFor(context, selector) + setIndexInGroup;
+}
+
+static bool sysbvm_globalLookupCacheSet_find(sysbvm_globalLookupCacheSet_t *set, sysbvm_tuple_t type, sysbvm_tuple_t selector, size_t epoch, sysbvm_tuple_t *outMethod)
+{
+    unsigned int entrySequence = atomic_load_explicit(&set->sequence, memory_order_acquire);
+    if(entrySequence & 1)
+        return false;
+
+    bool hasFoundEntry = false;
+    for(int i = 0; i < GLOBAL_LOOKUP_CACHE_WAY_COUNT; ++i)
+    {
+        sysbvm_globalLookupCacheEntry_t *entry = set->entries + i;
+        if(entry->type == type && entry->selector == selector && (entry->method || entry->missEpoch == epoch))
+        {
+            *outMethod = entry->method;
+            hasFoundEntry = true;
+            break;
+        }
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    return hasFoundEntry && atomic_load_explicit(&set->sequence, memory_order_relaxed) == entrySequence;
+}
+
+static bool sysbvm_globalLookupCacheSet_writeLock(sysbvm_globalLookupCacheSet_t *set, unsigned int *outSequence)
+{
+    // Another writer is already replacing an entry of this set, so skip caching instead of waiting for it.
+    unsigned int entrySequence = atomic_load_explicit(&set->sequence, memory_order_relaxed);
+    if((entrySequence & 1)
+        || !atomic_compare_exchange_strong_explicit(&set->sequence, &entrySequence, entrySequence + 1, memory_order_acquire, memory_order_relaxed))
+        return false;
+
+    atomic_thread_fence(memory_order_release);
+    *outSequence = entrySequence + 1;
+    return true;
+}
+
+static void sysbvm_globalLookupCacheSet_writeUnlock(sysbvm_globalLookupCacheSet_t *set, unsigned int sequence)
+{
+    atomic_store_explicit(&set->sequence, sequence + 1, memory_order_release);
+}
+
+static void sysbvm_globalLookupCacheSet_add(sysbvm_globalLookupCacheSet_t *set, sysbvm_tuple_t type, sysbvm_tuple_t selector, sysbvm_tuple_t method, size_t epoch)
+{
+    unsigned int sequence;
+    if(!sysbvm_globalLookupCacheSet_writeLock(set, &sequence))
+        return;
+
+    // Reuse the stale entry for the same key or a free entry, and otherwise replace the entries in round robin order.
+    sysbvm_globalLookupCacheEntry_t *entry = set->entries + ((sequence >> 1) % GLOBAL_LOOKUP_CACHE_WAY_COUNT);
+    for(int i = 0; i < GLOBAL_LOOKUP_CACHE_WAY_COUNT; ++i)
+    {
+        sysbvm_globalLookupCacheEntry_t *candidate = set->entries + i;
+        if(!candidate->type || (candidate->type == type && candidate->selector == selector))
+        {
+            entry = candidate;
+            break;
+        }
+    }
+
+    entry->type = type;
+    entry->selector = selector;
+    entry->method = method;
+    entry->missEpoch = epoch;
+    sysbvm_globalLookupCacheSet_writeUnlock(set, sequence);
+}
+
+// Shared by every context, since the supertype displays are checked without one.
+static atomic_size_t sysbvm_type_supertypeHierarchyEpoch = 1;
+
+static void sysbvm_globalLookupCacheSet_waitWriteLock(sysbvm_globalLookupCacheSet_t *set, unsigned int *outSequence)
+{
+    // The writers only hold a set for a few stores, but the holder may have been preempted, so give up the processor after a short spin.
+    for(unsigned int spinCount = 0; !sysbvm_globalLookupCacheSet_writeLock(set, outSequence); ++spinCount)
+    {
+        if(spinCount < 64)
+            continue;
+
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+// The types with a dispatch table are registered weakly, so that a method change only visits the tables of the affected subtypes.
+static void sysbvm_type_registerDispatchTableOwner(sysbvm_context_t *context, sysbvm_tuple_t type)
+{
+    if(!context->roots.typesWithDispatchTable)
+        context->roots.typesWithDispatchTable = sysbvm_weakOrderedCollection_create(context);
+
+    // Drop the collected types before growing the registry.
+    sysbvm_orderedCollection_t *registry = (sysbvm_orderedCollection_t*)context->roots.typesWithDispatchTable;
+    size_t registrySize = sysbvm_tuple_size_decode(registry->size);
+    if(registrySize > 0 && registrySize >= sysbvm_tuple_getSizeInSlots(registry->storage))
+    {
+        sysbvm_tuple_t *registeredTypes = ((sysbvm_array_t*)registry->storage)->elements;
+        size_t liveCount = 0;
+        for(size_t i = 0; i < registrySize; ++i)
+        {
+            if(registeredTypes[i] != SYSBVM_TOMBSTONE_TUPLE)
+                registeredTypes[liveCount++] = registeredTypes[i];
+        }
+
+        for(size_t i = liveCount; i < registrySize; ++i)
+            registeredTypes[i] = SYSBVM_NULL_TUPLE;
+        registry->size = sysbvm_tuple_size_encode(context, liveCount);
+    }
+
+    sysbvm_orderedCollection_add(context, (sysbvm_tuple_t)registry, type);
+}
+
+static bool sysbvm_type_inheritsLookupsFrom(sysbvm_tuple_t type, sysbvm_tuple_t ancestor)
+{
+    for(; sysbvm_tuple_isNonNullPointer(type); type = ((sysbvm_type_tuple_t*)type)->supertype)
+    {
+        if(type == ancestor)
+            return true;
+    }
+
+    return false;
+}
+
+// Discards the dispatch table slots of the selector in the type and in the registered subtypes. A null selector discards all of their slots.
+static void sysbvm_type_invalidateDispatchTables(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
+{
+    sysbvm_orderedCollection_t *registry = (sysbvm_orderedCollection_t*)context->roots.typesWithDispatchTable;
+    if(!registry)
+        return;
+
+    size_t registrySize = sysbvm_tuple_size_decode(registry->size);
+    sysbvm_tuple_t *registeredTypes = registrySize ? ((sysbvm_array_t*)registry->storage)->elements : NULL;
+    for(size_t i = 0; i < registrySize; ++i)
+    {
+        sysbvm_tuple_t registeredType = registeredTypes[i];
+        if(registeredType == SYSBVM_TOMBSTONE_TUPLE || !sysbvm_type_inheritsLookupsFrom(registeredType, type))
+            continue;
+
+        sysbvm_tuple_t dispatchTable = ((sysbvm_type_tuple_t*)registeredType)->dispatchTable;
+        if(!dispatchTable)
+            continue;
+
+        size_t dispatchTableSize = sysbvm_tuple_getSizeInSlots(dispatchTable);
+        sysbvm_tuple_t *entries = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(dispatchTable)->pointers;
+        for(size_t j = 0; j + 1 < dispatchTableSize; j += 2)
+        {
+            if(!selector || entries[j] == selector)
+            {
+                entries[j] = SYSBVM_NULL_TUPLE;
+                entries[j + 1] = SYSBVM_NULL_TUPLE;
+            }
+        }
+    }
+}
+
+static void sysbvm_type_flushAllLookups(sysbvm_context_t *context)
+{
+    for(size_t i = 0; i < context->globalMethodLookupCacheSetCount; ++i)
+    {
+        sysbvm_globalLookupCacheSet_t *cacheSet = context->globalMethodLookupCache + i;
+        unsigned int sequence;
+        sysbvm_globalLookupCacheSet_waitWriteLock(cacheSet, &sequence);
+        memset(cacheSet->entries, 0, sizeof(cacheSet->entries));
+        sysbvm_globalLookupCacheSet_writeUnlock(cacheSet, sequence);
+    }
+
+    // The epoch discards the failed lookups.
+    atomic_fetch_add_explicit(&context->methodDictionaryEpoch, 1, memory_order_release);
+    sysbvm_pic_flushAllDependencies(context);
+}
+
+SYSBVM_API void sysbvm_type_setSupertype(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t supertype)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type)) return;
+    if(sysbvm_tuple_isDummyValue(type)) return;
+
+    sysbvm_type_tuple_t *typeObject = (sysbvm_type_tuple_t*)type;
+    sysbvm_tuple_t oldSupertype = typeObject->supertype;
+    if(oldSupertype == supertype)
+        return;
+
+    typeObject->supertype = supertype;
+    typeObject->supertypeDisplay = SYSBVM_NULL_TUPLE;
+
+    // Without a previous supertype, only the failed lookups can be stale.
+    // Otherwise, the lookups and the supertype displays of any subtype may have been computed through the previous supertype.
+    if(!oldSupertype)
+    {
+        atomic_fetch_add_explicit(&context->methodDictionaryEpoch, 1, memory_order_release);
+    }
+    else
+    {
+        atomic_fetch_add_explicit(&sysbvm_type_supertypeHierarchyEpoch, 1, memory_order_release);
+        sysbvm_type_flushAllLookups(context);
+    }
+
+    // Only the dispatch tables of this type and its subtypes are resolved through the supertype.
+    sysbvm_type_invalidateDispatchTables(context, type, SYSBVM_NULL_TUPLE);
+}
+
+SYSBVM_API void sysbvm_type_setMethodDictionary(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t methodDictionary)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type)) return;
+    if(sysbvm_tuple_isDummyValue(type)) return;
+
+    sysbvm_type_tuple_t *typeObject = (sysbvm_type_tuple_t*)type;
+    sysbvm_tuple_t oldMethodDictionary = typeObject->methodDictionary;
+    if(oldMethodDictionary == methodDictionary)
+        return;
+
+    typeObject->methodDictionary = methodDictionary;
+
+    // Installing the first empty dictionary does not change any lookup, and its new methods flush their own selectors.
+    bool isEmptyDictionary = !sysbvm_tuple_isNonNullPointer(methodDictionary)
+        || sysbvm_tuple_size_decode(((sysbvm_methodDictionary_t*)methodDictionary)->size) == 0;
+    if(!oldMethodDictionary && isEmptyDictionary)
+        return;
+
+    sysbvm_type_flushAllLookups(context);
+    sysbvm_type_invalidateDispatchTables(context, type, SYSBVM_NULL_TUPLE);
 }
 
 static sysbvm_tuple_t sysbvm_type_lookupSelectorRecursively(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
@@ -832,24 +1073,16 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelector(sysbvm_context_t *context,
     if(!sysbvm_tuple_isNonNullPointer(type)) return SYSBVM_NULL_TUPLE;
     if(sysbvm_tuple_isDummyValue(type)) return SYSBVM_NULL_TUPLE;
 
-    // FIXME: Make this cache atomic and thread safe.
-    size_t cacheEntryIndex = computeLookupCacheEntryIndexFor(type, selector);
-    sysbvm_globalLookupCacheEntry_t *cacheEntry = context->roots.globalMethodLookupCache + cacheEntryIndex;
-    if(cacheEntry->type != type || cacheEntry->selector != selector)
-    {
-        sysbvm_tuple_t method = sysbvm_type_lookupSelectorRecursively(context, type, selector);
-        if(method)
-        {
-            cacheEntry->type = type;
-            cacheEntry->selector = selector;
-            cacheEntry->method = method;
-        }
+    // The failed lookups are also cached, until a new method is added to any method dictionary.
+    sysbvm_globalLookupCacheSet_t *cacheSet = computeLookupCacheSetFor(context, type, selector);
+    size_t epoch = atomic_load_explicit(&context->methodDictionaryEpoch, memory_order_acquire);
+    sysbvm_tuple_t method = SYSBVM_NULL_TUPLE;
+    if(sysbvm_globalLookupCacheSet_find(cacheSet, type, selector, epoch, &method))
         return method;
-    }
-    else
-    {
-        return cacheEntry->method;
-    }
+
+    method = sysbvm_type_lookupSelectorRecursively(context, type, selector);
+    sysbvm_globalLookupCacheSet_add(cacheSet, type, selector, method, epoch);
+    return method;
 }
 
 SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelectorWithPIC(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector, sysbvm_pic_t *pic)
@@ -858,11 +1091,122 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelectorWithPIC(sysbvm_context_t *co
     if(!sysbvm_pic_lookupTypeAndSelector(pic, selector, type, &method))
     {
         method = sysbvm_type_lookupSelector(context, type, selector);
-        sysbvm_pic_addSelectorTypeAndMethod(pic, selector, type, method);
+        sysbvm_pic_addSelectorTypeAndMethod(context, pic, selector, type, method);
+    }
+    return method;
+}
+
+static void sysbvm_type_setDispatchTableSlot(sysbvm_context_t *context, sysbvm_tuple_t type, size_t virtualTableIndex, sysbvm_tuple_t selector, sysbvm_tuple_t method)
+{
+    sysbvm_type_tuple_t *typeObject = (sysbvm_type_tuple_t*)type;
+    size_t selectorIndex = virtualTableIndex*2;
+    sysbvm_tuple_t dispatchTable = typeObject->dispatchTable;
+    size_t dispatchTableSize = dispatchTable ? sysbvm_tuple_getSizeInSlots(dispatchTable) : 0;
+    sysbvm_tuple_t *entries = dispatchTable ? SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(dispatchTable)->pointers : NULL;
+    if(selectorIndex + 1 >= dispatchTableSize)
+    {
+        sysbvm_tuple_t newDispatchTable = sysbvm_array_create(context, selectorIndex + 2);
+        sysbvm_tuple_t *newEntries = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(newDispatchTable)->pointers;
+        if(dispatchTable)
+            memcpy(newEntries, entries, dispatchTableSize * sizeof(sysbvm_tuple_t));
+        else
+            sysbvm_type_registerDispatchTableOwner(context, type);
+        typeObject->dispatchTable = newDispatchTable;
+        entries = newEntries;
+    }
+
+    entries[selectorIndex] = selector;
+    entries[selectorIndex + 1] = method;
+}
+
+SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector, size_t virtualTableIndex)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type)) return SYSBVM_NULL_TUPLE;
+    if(sysbvm_tuple_isDummyValue(type)) return SYSBVM_NULL_TUPLE;
+
+    // The slots are tagged with their selector, so a stale or shared virtual table index only costs a regular lookup.
+    sysbvm_tuple_t dispatchTable = ((sysbvm_type_tuple_t*)type)->dispatchTable;
+    size_t selectorIndex = virtualTableIndex*2;
+    if(dispatchTable && selectorIndex + 1 < sysbvm_tuple_getSizeInSlots(dispatchTable))
+    {
+        sysbvm_tuple_t *entries = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(dispatchTable)->pointers;
+        sysbvm_tuple_t method = entries[selectorIndex + 1];
+        if(entries[selectorIndex] == selector && method)
+            return method;
     }
+
+    // Failed lookups are not stored, since they go through doesNotUnderstand:.
+    sysbvm_tuple_t method = sysbvm_type_lookupSelector(context, type, selector);
+    if(method)
+        sysbvm_type_setDispatchTableSlot(context, type, virtualTableIndex, selector, method);
     return method;
 }
 
+SYSBVM_API bool sysbvm_type_findVirtualTableIndexOfSelector(sysbvm_tuple_t type, sysbvm_tuple_t selector, size_t *outVirtualTableIndex)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type)) return false;
+    if(sysbvm_tuple_isDummyValue(type)) return false;
+
+    // Only the layouts that are already computed are used, to avoid fixing the layout of a type that is still being defined.
+    sysbvm_tuple_t layout = ((sysbvm_type_tuple_t*)type)->virtualTableLayout;
+    while(sysbvm_tuple_isNonNullPointer(layout))
+    {
+        sysbvm_virtualTableLayout_t *layoutObject = (sysbvm_virtualTableLayout_t*)layout;
+        sysbvm_tuple_t localIndex = SYSBVM_NULL_TUPLE;
+        if(layoutObject->selectorToIndexTable && sysbvm_methodDictionary_find(layoutObject->selectorToIndexTable, selector, &localIndex))
+        {
+            *outVirtualTableIndex = sysbvm_tuple_size_decode(layoutObject->baseIndex) + sysbvm_tuple_size_decode(localIndex);
+            return true;
+        }
+
+        layout = layoutObject->supertypeLayout;
+    }
+
+    return false;
+}
+
+// The slot of the new method is assigned eagerly in the type, but the subtypes may override it, so their slots are discarded.
+static void sysbvm_type_updateDispatchTablesForSelector(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type)) return;
+    if(sysbvm_tuple_isDummyValue(type)) return;
+
+    sysbvm_type_invalidateDispatchTables(context, type, selector);
+
+    sysbvm_tuple_t methodDictionary = ((sysbvm_type_tuple_t*)type)->methodDictionary;
+    sysbvm_tuple_t method = SYSBVM_NULL_TUPLE;
+    size_t virtualTableIndex = 0;
+    if(methodDictionary && sysbvm_methodDictionary_find(methodDictionary, selector, &method) && method
+        && sysbvm_type_findVirtualTableIndexOfSelector(type, selector, &virtualTableIndex))
+        sysbvm_type_setDispatchTableSlot(context, type, virtualTableIndex, selector, method);
+}
+
+static void sysbvm_type_flushLookupSelector(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
+{
+    sysbvm_globalLookupCacheSet_t *selectorGroup = computeLookupCacheSelectorGroupFor(context, selector);
+    for(size_t i = 0; i < context->globalMethodLookupCacheSelectorGroupSetCount; ++i)
+    {
+        sysbvm_globalLookupCacheSet_t *cacheSet = selectorGroup + i;
+        unsigned int sequence;
+        sysbvm_globalLookupCacheSet_waitWriteLock(cacheSet, &sequence);
+
+        for(int j = 0; j < GLOBAL_LOOKUP_CACHE_WAY_COUNT; ++j)
+        {
+            sysbvm_globalLookupCacheEntry_t *cacheEntry = cacheSet->entries + j;
+            if(cacheEntry->selector == selector)
+                memset(cacheEntry, 0, sizeof(sysbvm_globalLookupCacheEntry_t));
+        }
+        sysbvm_globalLookupCacheSet_writeUnlock(cacheSet, sequence);
+    }
+
+    // The failed lookups of any selector may also be affected by the new method.
+    atomic_fetch_add_explicit(&context->methodDictionaryEpoch, 1, memory_order_release);
+
+    // Only the PICs that have cached this selector need to be flushed.
+    sysbvm_pic_flushSelectorDependencies(context, selector);
+    sysbvm_type_updateDispatchTablesForSelector(context, type, selector);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_type_lookupFallbackSelector(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t selector)
 {
     if(!sysbvm_tuple_isNonNullPointer(type)) return SYSBVM_NULL_TUPLE;
@@ -893,9 +1237,10 @@ SYSBVM_API void sysbvm_type_setMethodWithSelector(sysbvm_context_t *context, sys
 
     sysbvm_type_tuple_t* typeObject = (sysbvm_type_tuple_t*)type;
     if(!typeObject->methodDictionary)
-        typeObject->methodDictionary = sysbvm_methodDictionary_create(context);
+        sysbvm_type_setMethodDictionary(context, type, sysbvm_methodDictionary_create(context));
     sysbvm_methodDictionary_atPut(context, typeObject->methodDictionary, selector, method);
     sysbvm_function_recordBindingWithOwnerAndName(context, method, type, selector);
+    sysbvm_type_flushLookupSelector(context, type, selector);
 
     if((sysbvm_function_getFlags(context, method) & SYSBVM_FUNCTION_FLAGS_VIRTUAL_DISPATCH_FLAGS) != 0)
     {
@@ -1226,7 +1571,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_coerceValue(sysbvm_context_t *context, sys
     }
 
     // Load references.
-    if(sysbvm_type_isReferenceType(gcFrame.valueType) && !sysbvm_type_isDirectSubtypeOf(gcFrame.valueType, gcFrame.type))
+    if(sysbvm_type_isReferenceType(gcFrame.valueType) && !sysbvm_type_isSubtypeOf(context, gcFrame.valueType, gcFrame.type))
     {
         gcFrame.value = sysbvm_pointerLikeType_load(context, gcFrame.value);
         gcFrame.valueType = sysbvm_tuple_getType(context, gcFrame.value);
@@ -1238,7 +1583,7 @@ SYSBVM_API sysbvm_tuple_t sysbvm_type_coerceValue(sysbvm_context_t *context, sys
         return gcFrame.value;
     }
 
-    if(sysbvm_type_isDirectSubtypeOf(gcFrame.valueType, gcFrame.type))
+    if(sysbvm_type_isSubtypeOf(context, gcFrame.valueType, gcFrame.type))
     {
         SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
         return gcFrame.value;
@@ -1342,6 +1687,79 @@ SYSBVM_API int sysbvm_type_computeDepth(sysbvm_tuple_t type)
     return sysbvm_type_computeDepth(sysbvm_type_getSupertype(type)) + 1;
 }
 
+SYSBVM_API bool sysbvm_type_hasValidSupertypeDisplay(sysbvm_tuple_t type)
+{
+    sysbvm_tuple_t display = ((sysbvm_type_tuple_t *)type)->supertypeDisplay;
+    if(!display) return false;
+
+    // The first element is the hierarchy epoch, followed by the ancestors from the root down to the type itself.
+    size_t displaySize = sysbvm_tuple_getSizeInSlots(display);
+    sysbvm_tuple_t *elements = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(display)->pointers;
+    if(displaySize < 2 || sysbvm_tuple_size_decode(elements[0]) != atomic_load_explicit(&sysbvm_type_supertypeHierarchyEpoch, memory_order_acquire))
+        return false;
+
+    // A root that gains a supertype does not change the epoch, so it is checked explicitly.
+    sysbvm_tuple_t supertype = ((sysbvm_type_tuple_t *)type)->supertype;
+    return elements[displaySize - 1] == type
+        && (displaySize == 2 ? !supertype : elements[displaySize - 2] == supertype)
+        && !((sysbvm_type_tuple_t *)elements[1])->supertype;
+}
+
+SYSBVM_API bool sysbvm_type_isDirectSubtypeOf(sysbvm_tuple_t type, sysbvm_tuple_t supertype)
+{
+    if(!sysbvm_tuple_isNonNullPointer(supertype)) return false;
+    if(!sysbvm_tuple_isNonNullPointer(type)) return false;
+    if(sysbvm_tuple_isDummyValue(type)) return false;
+
+    // Constant time check when both of the displays are available.
+    if(!sysbvm_tuple_isDummyValue(supertype) && sysbvm_type_hasValidSupertypeDisplay(type) && sysbvm_type_hasValidSupertypeDisplay(supertype))
+    {
+        sysbvm_tuple_t typeDisplay = ((sysbvm_type_tuple_t *)type)->supertypeDisplay;
+        size_t supertypeDisplayIndex = sysbvm_tuple_getSizeInSlots(((sysbvm_type_tuple_t *)supertype)->supertypeDisplay) - 1;
+        return supertypeDisplayIndex < sysbvm_tuple_getSizeInSlots(typeDisplay)
+            && SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(typeDisplay)->pointers[supertypeDisplayIndex] == supertype;
+    }
+
+    while(type)
+    {
+        if(type == supertype)
+            return true;
+
+        type = ((sysbvm_type_tuple_t *)type)->supertype;
+    }
+
+    return false;
+}
+
+SYSBVM_API void sysbvm_type_ensureSupertypeDisplay(sysbvm_context_t *context, sysbvm_tuple_t type)
+{
+    if(!sysbvm_tuple_isNonNullPointer(type) || sysbvm_tuple_isDummyValue(type)) return;
+    if(sysbvm_type_hasValidSupertypeDisplay(type)) return;
+
+    // The epoch is read first, so that a concurrent re-parenting leaves this display invalid.
+    size_t epoch = atomic_load_explicit(&sysbvm_type_supertypeHierarchyEpoch, memory_order_acquire);
+    size_t displaySize = 1;
+    for(sysbvm_tuple_t ancestor = type; ancestor; ancestor = sysbvm_type_getSupertype(ancestor))
+        ++displaySize;
+
+    // Allocating does not trigger a collection, so the ancestors can be stored without rooting them.
+    sysbvm_tuple_t display = sysbvm_array_create(context, displaySize);
+    sysbvm_tuple_t *elements = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(display)->pointers;
+    elements[0] = sysbvm_tuple_size_encode(context, epoch);
+    size_t displayIndex = displaySize;
+    for(sysbvm_tuple_t ancestor = type; ancestor; ancestor = sysbvm_type_getSupertype(ancestor))
+        elements[--displayIndex] = ancestor;
+
+    ((sysbvm_type_tuple_t*)type)->supertypeDisplay = display;
+}
+
+SYSBVM_API bool sysbvm_type_isSubtypeOf(sysbvm_context_t *context, sysbvm_tuple_t type, sysbvm_tuple_t supertype)
+{
+    sysbvm_type_ensureSupertypeDisplay(context, type);
+    sysbvm_type_ensureSupertypeDisplay(context, supertype);
+    return sysbvm_type_isDirectSubtypeOf(type, supertype);
+}
+
 SYSBVM_API sysbvm_tuple_t sysbvm_type_computeLCA(sysbvm_tuple_t leftType, sysbvm_tuple_t rightType)
 {
     // Bring them onto the same depth.
@@ -1377,29 +1795,28 @@ static sysbvm_tuple_t sysbvm_type_primitive_flushLookupSelector(sysbvm_context_t
     (void)closure;
     if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
 
-    //sysbvm_tuple_t *type = &arguments[0];
+    sysbvm_tuple_t *type = &arguments[0];
     sysbvm_tuple_t *selector = &arguments[1];
 
-    for(size_t i = 0; i < GLOBAL_LOOKUP_CACHE_ENTRY_COUNT; ++i)
-    {
-        sysbvm_globalLookupCacheEntry_t *cacheEntry = context->roots.globalMethodLookupCache + i;
-        if(cacheEntry->selector == *selector)
-            memset(cacheEntry, 0, sizeof(sysbvm_globalLookupCacheEntry_t));
-    }
+    sysbvm_type_flushLookupSelector(context, *type, *selector);
+    return SYSBVM_VOID_TUPLE;
+}
 
-    {
-        sysbvm_chunkedAllocatorIterator_t iterator;
-        for(sysbvm_chunkedAllocatorIterator_begin(&context->heap.picTableAllocator, &iterator);
-            sysbvm_chunkedAllocatorIterator_isValid(&iterator);
-            sysbvm_chunkedAllocatorIterator_advance(&iterator))
-        {
-            size_t picCount = iterator.size / sizeof(sysbvm_pic_t);
-            sysbvm_pic_t *pics = (sysbvm_pic_t*)iterator.data;
-            for(size_t i = 0; i < picCount; ++i)
-                sysbvm_pic_flushSelector(pics + i, *selector);
-        }
-    }
+static sysbvm_tuple_t sysbvm_type_primitive_setSupertype(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
+
+    sysbvm_type_setSupertype(context, arguments[0], arguments[1]);
+    return SYSBVM_VOID_TUPLE;
+}
+
+static sysbvm_tuple_t sysbvm_type_primitive_setMethodDictionary(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    if(argumentCount != 2) sysbvm_error_argumentCountMismatch(2, argumentCount);
 
+    sysbvm_type_setMethodDictionary(context, arguments[0], arguments[1]);
     return SYSBVM_VOID_TUPLE;
 }
 
@@ -1624,6 +2041,8 @@ void sysbvm_type_registerPrimitives(void)
 
     sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_coerceASTNodeWithEnvironment, "Type::coerceASTNode:withEnvironment:");
 
+    sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_setSupertype, "Type::supertype:");
+    sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_setMethodDictionary, "Type::methodDictionary:");
     sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_flushLookupSelector, "Type::flushLookupSelector:");
     sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_flushMacroLookupSelector, "Type::flushMacroLookupSelector:");
     sysbvm_primitiveTable_registerFunction(sysbvm_type_primitive_flushFallbackLookupSelector, "Type::flushFallbackLookupSelector:");
@@ -1650,6 +2069,8 @@ void sysbvm_type_setupPrimitives(sysbvm_context_t *context)
     
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "coerceASTNode:withEnvironment:", 3, SYSBVM_FUNCTION_FLAGS_NONE, NULL, sysbvm_type_primitive_coerceASTNodeWithEnvironment);
 
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "supertype:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_type_primitive_setSupertype);
+    sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "methodDictionary:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE | SYSBVM_FUNCTION_FLAGS_FINAL, NULL, sysbvm_type_primitive_setMethodDictionary);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "flushLookupSelector:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE, NULL, sysbvm_type_primitive_flushLookupSelector);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "flushMacroLookupSelector:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE, NULL, sysbvm_type_primitive_flushMacroLookupSelector);
     sysbvm_context_setIntrinsicPrimitiveMethod(context, context->roots.typeType, "flushFallbackLookupSelector:", 2, SYSBVM_FUNCTION_FLAGS_CORE_PRIMITIVE, NULL, sysbvm_type_primitive_flushFallbackLookupSelector);
@@ -48,6 +48,7 @@
 #include "orderedCollection.c"
 #include "orderedOffsetTable.c"
 #include "parser.c"
+#include "perf.c"
 #include "pic.c"
 #include "pragma.c"
 #include "primitiveIntegers.c"
@@ -58,6 +59,7 @@
 #include "sourcePosition.c"
 #include "stackFrame.c"
 #include "string.c"
+#include "stringSearch.c"
 #include "stringStream.c"
 #include "sysmelParser.c"
 #include "system.c"
@@ -0,0 +1,220 @@
+#include "TestMacros.h"
+#include "sysbvm/dictionary.h"
+#include "sysbvm/association.h"
+#include "sysbvm/array.h"
+#include "sysbvm/gc.h"
+#include "sysbvm/stackFrame.h"
+#include "sysbvm/string.h"
+#include <stdio.h>
+
+#define TEST_DICTIONARY_KEY_COUNT 200
+
+static sysbvm_tuple_t testKeyAt(const char *prefix, size_t index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%s%d", prefix, (int)index);
+    return sysbvm_symbol_internWithCString(sysbvm_test_context, name);
+}
+
+// The same mutations as MethodDictionary>>removeAll and MethodDictionary>>untypedAt:put: in the Sysmel side.
+static void sysmelMethodDictionaryRemoveAll(sysbvm_tuple_t dictionary)
+{
+    sysbvm_methodDictionary_t *dictionaryObject = (sysbvm_methodDictionary_t*)dictionary;
+    size_t storageSize = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage);
+    for(size_t i = 0; i < storageSize; ++i)
+        sysbvm_array_atPut(dictionaryObject->storage, i, SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE);
+    dictionaryObject->size = sysbvm_tuple_size_encode(sysbvm_test_context, 0);
+    dictionaryObject->controlBytes = SYSBVM_NULL_TUPLE;
+}
+
+static void sysmelMethodDictionaryAtPut(sysbvm_tuple_t dictionary, sysbvm_tuple_t key, sysbvm_tuple_t value, bool discardControlBytes)
+{
+    sysbvm_methodDictionary_t *dictionaryObject = (sysbvm_methodDictionary_t*)dictionary;
+    if(discardControlBytes)
+        dictionaryObject->controlBytes = SYSBVM_NULL_TUPLE;
+
+    size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage) / 2;
+    size_t index = sysbvm_tuple_identityHash(key) % capacity;
+    while(sysbvm_array_at(dictionaryObject->storage, index*2) != SYSBVM_HASHTABLE_EMPTY_ELEMENT_TUPLE && sysbvm_array_at(dictionaryObject->storage, index*2) != key)
+        index = (index + 1) % capacity;
+
+    if(sysbvm_array_at(dictionaryObject->storage, index*2) != key)
+        dictionaryObject->size = sysbvm_tuple_size_encode(sysbvm_test_context, sysbvm_tuple_size_decode(dictionaryObject->size) + 1);
+    sysbvm_array_atPut(dictionaryObject->storage, index*2, key);
+    sysbvm_array_atPut(dictionaryObject->storage, index*2 + 1, value);
+}
+
+static size_t methodDictionaryOccurrencesOf(sysbvm_tuple_t dictionary, sysbvm_tuple_t key)
+{
+    sysbvm_methodDictionary_t *dictionaryObject = (sysbvm_methodDictionary_t*)dictionary;
+    size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->storage) / 2;
+    size_t count = 0;
+    for(size_t i = 0; i < capacity; ++i)
+        count += sysbvm_array_at(dictionaryObject->storage, i*2) == key;
+    return count;
+}
+
+TEST_SUITE(MethodDictionary)
+{
+    TEST_CASE_WITH_FIXTURE(AtPutAndFind, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t dictionary = sysbvm_methodDictionary_create(sysbvm_test_context);
+        for(size_t i = 0; i < TEST_DICTIONARY_KEY_COUNT; ++i)
+            sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("key", i), sysbvm_tuple_size_encode(sysbvm_test_context, i));
+
+        for(size_t i = 0; i < TEST_DICTIONARY_KEY_COUNT; ++i)
+        {
+            sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+            TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("key", i), &value));
+            TEST_ASSERT_EQUALS(i, sysbvm_tuple_size_decode(value));
+        }
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        TEST_ASSERT(!sysbvm_methodDictionary_find(dictionary, testKeyAt("missing", 0), &value));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(RemoveAllThenRefillToTheSameSize, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t dictionary = sysbvm_methodDictionary_createWithCapacity(sysbvm_test_context, 64);
+        for(size_t i = 0; i < 32; ++i)
+            sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("old", i), SYSBVM_TRUE_TUPLE);
+
+        // The element count is the same afterwards, so only the discarded control bytes tell the C side that they are stale.
+        sysmelMethodDictionaryRemoveAll(dictionary);
+        for(size_t i = 0; i < 32; ++i)
+            sysmelMethodDictionaryAtPut(dictionary, testKeyAt("new", i), SYSBVM_FALSE_TUPLE, true);
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        for(size_t i = 0; i < 32; ++i)
+        {
+            TEST_ASSERT(!sysbvm_methodDictionary_find(dictionary, testKeyAt("old", i), &value));
+            TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("new", i), &value));
+            TEST_ASSERT_EQUALS(SYSBVM_FALSE_TUPLE, value);
+        }
+
+        // Inserting from the C side rebuilds the control bytes, without duplicating the keys inserted by the Sysmel side.
+        for(size_t i = 0; i < 32; ++i)
+            sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("new", i), SYSBVM_TRUE_TUPLE);
+        sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("old", 0), SYSBVM_TRUE_TUPLE);
+        TEST_ASSERT_EQUALS(33, sysbvm_tuple_size_decode(((sysbvm_methodDictionary_t*)dictionary)->size));
+        for(size_t i = 0; i < 32; ++i)
+        {
+            TEST_ASSERT_EQUALS(1, methodDictionaryOccurrencesOf(dictionary, testKeyAt("new", i)));
+            TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("new", i), &value));
+            TEST_ASSERT_EQUALS(SYSBVM_TRUE_TUPLE, value);
+        }
+        TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("old", 0), &value));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(InsertionThatKeepsTheControlBytes, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t dictionary = sysbvm_methodDictionary_createWithCapacity(sysbvm_test_context, 64);
+        for(size_t i = 0; i < 16; ++i)
+            sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("old", i), SYSBVM_TRUE_TUPLE);
+
+        // Even if a mutation forgets to discard the control bytes, a different element count invalidates them.
+        for(size_t i = 0; i < 16; ++i)
+            sysmelMethodDictionaryAtPut(dictionary, testKeyAt("new", i), SYSBVM_FALSE_TUPLE, false);
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        for(size_t i = 0; i < 16; ++i)
+        {
+            TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("old", i), &value));
+            TEST_ASSERT(sysbvm_methodDictionary_find(dictionary, testKeyAt("new", i), &value));
+            sysbvm_methodDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("new", i), SYSBVM_TRUE_TUPLE);
+            TEST_ASSERT_EQUALS(1, methodDictionaryOccurrencesOf(dictionary, testKeyAt("new", i)));
+        }
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+}
+
+TEST_SUITE(IdentityDictionary)
+{
+    TEST_CASE_WITH_FIXTURE(AtPutAndFind, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t dictionary = sysbvm_identityDictionary_create(sysbvm_test_context);
+        for(size_t i = 0; i < TEST_DICTIONARY_KEY_COUNT; ++i)
+            sysbvm_identityDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("key", i), sysbvm_tuple_size_encode(sysbvm_test_context, i));
+
+        for(size_t i = 0; i < TEST_DICTIONARY_KEY_COUNT; ++i)
+        {
+            sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+            TEST_ASSERT(sysbvm_identityDictionary_find(dictionary, testKeyAt("key", i), &value));
+            TEST_ASSERT_EQUALS(i, sysbvm_tuple_size_decode(value));
+        }
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        TEST_ASSERT(!sysbvm_identityDictionary_find(dictionary, testKeyAt("missing", 0), &value));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(ClearThenRefillToTheSameSize, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t dictionary = sysbvm_identityDictionary_create(sysbvm_test_context);
+        for(size_t i = 0; i < 32; ++i)
+            sysbvm_identityDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("old", i), SYSBVM_TRUE_TUPLE);
+
+        // Clear the storage and refill it with linear probing, as the Sysmel side does after discarding the control bytes.
+        sysbvm_identityDictionary_t *dictionaryObject = (sysbvm_identityDictionary_t*)dictionary;
+        size_t capacity = sysbvm_tuple_getSizeInSlots(dictionaryObject->super.storage);
+        for(size_t i = 0; i < capacity; ++i)
+            sysbvm_array_atPut(dictionaryObject->super.storage, i, SYSBVM_NULL_TUPLE);
+        dictionaryObject->controlBytes = SYSBVM_NULL_TUPLE;
+        for(size_t i = 0; i < 32; ++i)
+        {
+            sysbvm_tuple_t key = testKeyAt("new", i);
+            size_t index = sysbvm_tuple_identityHash(key) % capacity;
+            while(sysbvm_array_at(dictionaryObject->super.storage, index))
+                index = (index + 1) % capacity;
+            sysbvm_array_atPut(dictionaryObject->super.storage, index, sysbvm_association_create(sysbvm_test_context, key, SYSBVM_FALSE_TUPLE));
+        }
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        for(size_t i = 0; i < 32; ++i)
+        {
+            TEST_ASSERT(!sysbvm_identityDictionary_find(dictionary, testKeyAt("old", i), &value));
+            TEST_ASSERT(sysbvm_identityDictionary_find(dictionary, testKeyAt("new", i), &value));
+            TEST_ASSERT_EQUALS(SYSBVM_FALSE_TUPLE, value);
+        }
+
+        sysbvm_identityDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("old", 0), SYSBVM_TRUE_TUPLE);
+        for(size_t i = 0; i < 32; ++i)
+        {
+            sysbvm_identityDictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("new", i), SYSBVM_TRUE_TUPLE);
+            TEST_ASSERT(sysbvm_identityDictionary_find(dictionary, testKeyAt("new", i), &value));
+            TEST_ASSERT_EQUALS(SYSBVM_TRUE_TUPLE, value);
+        }
+        TEST_ASSERT_EQUALS(33, sysbvm_tuple_size_decode(dictionaryObject->super.size));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+}
+
+TEST_SUITE(Dictionary)
+{
+    TEST_CASE_WITH_FIXTURE(GrowingKeepsTheStackFrameBalanced, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_stackFrameRecord_t *activeRecord = sysbvm_stackFrame_getActiveRecord();
+        sysbvm_tuple_t dictionary = sysbvm_dictionary_create(sysbvm_test_context);
+        sysbvm_tuple_t weakValueDictionary = sysbvm_weakValueDictionary_create(sysbvm_test_context);
+        for(size_t i = 0; i < TEST_DICTIONARY_KEY_COUNT; ++i)
+        {
+            sysbvm_dictionary_atPut(sysbvm_test_context, dictionary, testKeyAt("key", i), sysbvm_tuple_size_encode(sysbvm_test_context, i));
+            sysbvm_weakValueDictionary_atPut(sysbvm_test_context, weakValueDictionary, testKeyAt("key", i), testKeyAt("value", i));
+            TEST_ASSERT_EQUALS(activeRecord, sysbvm_stackFrame_getActiveRecord());
+        }
+
+        sysbvm_tuple_t value = SYSBVM_NULL_TUPLE;
+        TEST_ASSERT(!sysbvm_dictionary_find(sysbvm_test_context, dictionary, testKeyAt("missing", 0), &value));
+        TEST_ASSERT(!sysbvm_weakValueDictionary_find(sysbvm_test_context, weakValueDictionary, testKeyAt("missing", 0), &value));
+        TEST_ASSERT_EQUALS(activeRecord, sysbvm_stackFrame_getActiveRecord());
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+}
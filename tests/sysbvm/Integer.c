@@ -180,4 +180,11 @@ TEST_SUITE(Integer)
         TEST_ASSERT_INTEGER_TOSTRING_EQUALS("30414093201713378043612608166064768844377641568960512000000000000", sysbvm_integer_factorial(sysbvm_test_context, INTEGER("50")));
         TEST_ASSERT_INTEGER_TOSTRING_EQUALS("93326215443944152681699238856266700490715968264381621468592963895217599993229915608941463976156518286253697920827223758251185210916864000000000000000000000000", sysbvm_integer_factorial(sysbvm_test_context, INTEGER("100")));
     }
+    TEST_CASE_WITH_FIXTURE(LargeIntegerPrintString, TuuvmCore)
+    {
+        TEST_ASSERT_INTEGER_TOSTRING_EQUALS("4294967296", INTEGER("4294967296"));
+        TEST_ASSERT_INTEGER_TOSTRING_EQUALS("18446744073709551616", INTEGER("18446744073709551616"));
+        TEST_ASSERT_INTEGER_TOSTRING_EQUALS("1000000000000000000001", INTEGER("1000000000000000000001"));
+        TEST_ASSERT_INTEGER_TOSTRING_EQUALS("-123456789012345678901234567890", INTEGER("-123456789012345678901234567890"));
+    }
 }
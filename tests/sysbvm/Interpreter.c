@@ -3,6 +3,11 @@
 #include "sysbvm/environment.h"
 #include "sysbvm/string.h"
 #include "sysbvm/gc.h"
+#include "sysbvm/function.h"
+#include "sysbvm/bytecode.h"
+#include "sysbvm/array.h"
+#include "sysbvm/stackFrame.h"
+#include "sysbvm/type.h"
 
 static sysbvm_tuple_t testAnalyzeAndEvaluate(const char *sourceCode)
 {
@@ -18,6 +23,24 @@ static sysbvm_tuple_t testAnalyzeAndEvaluateSysmel(const char *sourceCode)
         sourceCode, "test", "sysmel");
 }
 
+static sysbvm_tuple_t testCollectGarbagePrimitive(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)closure;
+    (void)argumentCount;
+    (void)arguments;
+    sysbvm_gc_collect(context);
+    return SYSBVM_VOID_TUPLE;
+}
+
+static sysbvm_tuple_t testDoNothingPrimitive(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)context;
+    (void)closure;
+    (void)argumentCount;
+    (void)arguments;
+    return SYSBVM_VOID_TUPLE;
+}
+
 TEST_SUITE(Interpreter)
 {
     TEST_CASE_WITH_FIXTURE(EmptyString, TuuvmCore)
@@ -104,4 +127,149 @@ TEST_SUITE(Interpreter)
         TEST_ASSERT_EQUALS(SYSBVM_FALSE_TUPLE, testAnalyzeAndEvaluateSysmel("let: #myvar with: false. myvar"));
         TEST_ASSERT_EQUALS(SYSBVM_FALSE_TUPLE, testAnalyzeAndEvaluateSysmel("let: #myfunction with: {| false}. myfunction()"));
     }
+
+    TEST_CASE_WITH_FIXTURE(CallWithManyArguments, TuuvmCore)
+    {
+        // The call instruction needs more operands than its opcode can encode, so its count is extended.
+        TEST_ASSERT_EQUALS(testAnalyzeAndEvaluateSysmel("19"), testAnalyzeAndEvaluateSysmel(
+            "let: #lastOf with: {:a0 :a1 :a2 :a3 :a4 :a5 :a6 :a7 :a8 :a9 :a10 :a11 :a12 :a13 :a14 :a15 :a16 :a17 :a18 :a19 | a19}.\n"
+            "let: #caller with: {| lastOf(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19)}.\n"
+            "caller()"));
+    }
+
+    TEST_CASE_WITH_FIXTURE(ForwardConditionalJumpIsNotABackEdge, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t function = testAnalyzeAndEvaluateSysmel(
+            "let: #choose with: {:condition | if: condition then: 1 else: 2}.\n"
+            "choose(false).\n"
+            "choose");
+        TEST_ASSERT(sysbvm_tuple_isFunction(sysbvm_test_context, function));
+
+        sysbvm_functionDefinition_t *definition = (sysbvm_functionDefinition_t*)((sysbvm_function_t*)function)->definition;
+        TEST_ASSERT(definition->bytecode);
+        if(definition->bytecode)
+            TEST_ASSERT_EQUALS(0, sysbvm_tuple_uint32_decode(((sysbvm_functionBytecode_t*)definition->bytecode)->backEdgeCount));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(ReplacingTheDefinitionOfAnExecutingFunction, TuuvmCore)
+    {
+        struct {
+            sysbvm_tuple_t function;
+            sysbvm_tuple_t replacement;
+            sysbvm_tuple_t collectGarbage;
+            sysbvm_tuple_t doNothing;
+            sysbvm_tuple_t executingBytecode;
+        } gcFrame = {0};
+        SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
+
+        gcFrame.function = testAnalyzeAndEvaluateSysmel("let: #function with: {:self :replacement :hook | self adoptDefinitionOf: replacement. hook(). 42}. function");
+        gcFrame.replacement = testAnalyzeAndEvaluateSysmel("let: #replacement with: {:self :replacement :hook | 0}. replacement");
+        sysbvm_primitiveTable_registerFunction(testCollectGarbagePrimitive, "Test::collectGarbage");
+        sysbvm_primitiveTable_registerFunction(testDoNothingPrimitive, "Test::doNothing");
+        gcFrame.collectGarbage = sysbvm_function_createPrimitive(sysbvm_test_context, 0, SYSBVM_FUNCTION_FLAGS_NONE, NULL, testCollectGarbagePrimitive);
+        gcFrame.doNothing = sysbvm_function_createPrimitive(sysbvm_test_context, 0, SYSBVM_FUNCTION_FLAGS_NONE, NULL, testDoNothingPrimitive);
+
+        // Make the function hot enough for the JIT.
+        for(int i = 0; i < 4; ++i)
+            sysbvm_function_apply3(sysbvm_test_context, gcFrame.function, gcFrame.function, gcFrame.function, gcFrame.doNothing);
+
+        // The bytecode that is running must survive the collection that happens after its definition is replaced.
+        sysbvm_functionDefinition_t *definition = (sysbvm_functionDefinition_t*)((sysbvm_function_t*)gcFrame.function)->definition;
+        gcFrame.executingBytecode = sysbvm_weakArray_create(sysbvm_test_context, 1);
+        sysbvm_array_atPut(gcFrame.executingBytecode, 0, definition->bytecode);
+
+        sysbvm_tuple_t result = sysbvm_function_apply3(sysbvm_test_context, gcFrame.function, gcFrame.function, gcFrame.replacement, gcFrame.collectGarbage);
+        TEST_ASSERT_EQUALS(42, sysbvm_tuple_integer_decodeSmall(result));
+        TEST_ASSERT(sysbvm_array_at(gcFrame.executingBytecode, 0) != SYSBVM_TOMBSTONE_TUPLE);
+        TEST_ASSERT_EQUALS(0, sysbvm_tuple_integer_decodeSmall(sysbvm_function_apply3(sysbvm_test_context, gcFrame.function, gcFrame.function, gcFrame.replacement, gcFrame.doNothing)));
+        SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+    }
+
+    TEST_CASE_WITH_FIXTURE(InlineCachedMethodAdoptingAnotherDefinition, TuuvmCore)
+    {
+        struct {
+            sysbvm_tuple_t type;
+            sysbvm_tuple_t receiver;
+            sysbvm_tuple_t method;
+            sysbvm_tuple_t replacement;
+            sysbvm_tuple_t adoptDefinition;
+            sysbvm_tuple_t caller;
+        } gcFrame = {0};
+        SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
+
+        gcFrame.type = sysbvm_type_createAnonymous(sysbvm_test_context);
+        gcFrame.receiver = (sysbvm_tuple_t)sysbvm_context_allocatePointerTuple(sysbvm_test_context, gcFrame.type, 0);
+        gcFrame.method = testAnalyzeAndEvaluateSysmel("{:self | 1}");
+        gcFrame.replacement = testAnalyzeAndEvaluateSysmel("{:self | 2}");
+        gcFrame.adoptDefinition = testAnalyzeAndEvaluateSysmel("{:function :replacement | function adoptDefinitionOf: replacement}");
+        gcFrame.caller = testAnalyzeAndEvaluateSysmel("{:receiver | receiver testInlineCachedMethod}");
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, gcFrame.type, sysbvm_symbol_internWithCString(sysbvm_test_context, "testInlineCachedMethod"), gcFrame.method);
+
+        // Make the caller and the method hot enough for the JIT, and fill the inline cache of the caller.
+        for(int i = 0; i < 4; ++i)
+            TEST_ASSERT_EQUALS(1, sysbvm_tuple_integer_decodeSmall(sysbvm_function_apply1(sysbvm_test_context, gcFrame.caller, gcFrame.receiver)));
+
+        // The cached method is the same object, but the sends must reach its new definition.
+        sysbvm_function_apply2(sysbvm_test_context, gcFrame.adoptDefinition, gcFrame.method, gcFrame.replacement);
+        TEST_ASSERT_EQUALS(2, sysbvm_tuple_integer_decodeSmall(sysbvm_function_apply1(sysbvm_test_context, gcFrame.caller, gcFrame.receiver)));
+        SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+    }
+
+    TEST_CASE_WITH_FIXTURE(DroppingTheCallerReleasesTheInlineCachedCode, TuuvmCore)
+    {
+        struct {
+            sysbvm_tuple_t type;
+            sysbvm_tuple_t receiver;
+            sysbvm_tuple_t method;
+            sysbvm_tuple_t replacement;
+            sysbvm_tuple_t adoptDefinition;
+            sysbvm_tuple_t caller;
+            sysbvm_tuple_t cachedBytecode;
+        } gcFrame = {0};
+        SYSBVM_STACKFRAME_PUSH_GC_ROOTS(gcFrameRecord, gcFrame);
+
+        gcFrame.type = sysbvm_type_createAnonymous(sysbvm_test_context);
+        gcFrame.receiver = (sysbvm_tuple_t)sysbvm_context_allocatePointerTuple(sysbvm_test_context, gcFrame.type, 0);
+        gcFrame.method = testAnalyzeAndEvaluateSysmel("{:self | 1}");
+        gcFrame.replacement = testAnalyzeAndEvaluateSysmel("{:self | 2}");
+        gcFrame.adoptDefinition = testAnalyzeAndEvaluateSysmel("{:function :replacement | function adoptDefinitionOf: replacement}");
+        gcFrame.caller = testAnalyzeAndEvaluateSysmel("{:receiver | receiver testDroppedInlineCachedMethod}");
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, gcFrame.type, sysbvm_symbol_internWithCString(sysbvm_test_context, "testDroppedInlineCachedMethod"), gcFrame.method);
+
+        for(int i = 0; i < 4; ++i)
+            sysbvm_function_apply1(sysbvm_test_context, gcFrame.caller, gcFrame.receiver);
+
+        // Once the method adopts another definition, its old bytecode is only referenced by the inline cache of the caller.
+        sysbvm_functionDefinition_t *definition = (sysbvm_functionDefinition_t*)((sysbvm_function_t*)gcFrame.method)->definition;
+        gcFrame.cachedBytecode = sysbvm_weakArray_create(sysbvm_test_context, 1);
+        sysbvm_array_atPut(gcFrame.cachedBytecode, 0, definition->bytecode);
+        sysbvm_function_apply2(sysbvm_test_context, gcFrame.adoptDefinition, gcFrame.method, gcFrame.replacement);
+
+        sysbvm_gc_collect(sysbvm_test_context);
+        TEST_ASSERT(sysbvm_array_at(gcFrame.cachedBytecode, 0) != SYSBVM_TOMBSTONE_TUPLE);
+
+        // The pending analysis of the caller also references it.
+        sysbvm_analysisQueue_waitPendingAnalysis(sysbvm_test_context, sysbvm_analysisQueue_getDefault(sysbvm_test_context));
+        gcFrame.caller = SYSBVM_NULL_TUPLE;
+        sysbvm_gc_collect(sysbvm_test_context);
+        TEST_ASSERT_EQUALS(SYSBVM_TOMBSTONE_TUPLE, sysbvm_array_at(gcFrame.cachedBytecode, 0));
+        SYSBVM_STACKFRAME_POP_GC_ROOTS(gcFrameRecord);
+    }
+
+    TEST_CASE_WITH_FIXTURE(SourceCodeStringsStayMutable, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t text = sysbvm_string_createWithCString(sysbvm_test_context, "(define myvar false) myvar");
+        sysbvm_tuple_t directory = sysbvm_string_createWithCString(sysbvm_test_context, "");
+        sysbvm_tuple_t name = sysbvm_string_createWithCString(sysbvm_test_context, "test");
+        TEST_ASSERT_EQUALS(SYSBVM_FALSE_TUPLE, sysbvm_interpreter_analyzeAndEvaluateStringWithEnvironment(sysbvm_test_context,
+            sysbvm_environment_createDefaultForEvaluation(sysbvm_test_context),
+            text, directory, name, sysbvm_symbol_internWithCString(sysbvm_test_context, "tlisp")));
+        TEST_ASSERT(!sysbvm_tuple_isImmutable(text));
+        TEST_ASSERT(!sysbvm_tuple_isImmutable(directory));
+        TEST_ASSERT(!sysbvm_tuple_isImmutable(name));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
 }
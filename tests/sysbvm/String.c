@@ -1,5 +1,7 @@
 #include "TestMacros.h"
 #include "sysbvm/string.h"
+#include "sysbvm/hash.h"
+#include <string.h>
 
 TEST_SUITE(String)
 {
@@ -16,6 +18,80 @@ TEST_SUITE(String)
         TEST_ASSERT(sysbvm_tuple_isBytes(string));
         TEST_ASSERT_EQUALS(12, sysbvm_tuple_getSizeInBytes(string));
     }
+
+    TEST_CASE_WITH_FIXTURE(Hash, TuuvmCore)
+    {
+        const char *text = "The quick brown fox jumps over the lazy dog, several times over.";
+        for(size_t size = 0; size <= strlen(text); ++size)
+        {
+            size_t expectedHash = sysbvm_hashMultiply(1);
+            for(size_t i = 0; i < size; ++i)
+                expectedHash = sysbvm_hashConcatenate(expectedHash, (uint8_t)text[i]);
+
+            sysbvm_tuple_t string = sysbvm_string_createWithString(sysbvm_test_context, size, text);
+            TEST_ASSERT_EQUALS(expectedHash, sysbvm_string_hash(string));
+
+            sysbvm_tuple_markImmutable(string);
+            TEST_ASSERT_EQUALS(expectedHash, sysbvm_string_hashWithCache(sysbvm_test_context, string));
+            TEST_ASSERT_EQUALS(expectedHash, sysbvm_string_hashWithCache(sysbvm_test_context, string));
+        }
+    }
+
+    TEST_CASE_WITH_FIXTURE(SearchBytes, TuuvmCore)
+    {
+        uint8_t text[100];
+        for(size_t i = 0; i < sizeof(text); ++i)
+            text[i] = (uint8_t)('a' + i % 7);
+        text[90] = 'X';
+
+        for(size_t size = 0; size <= sizeof(text); ++size)
+        {
+            intptr_t expectedFirst = -1;
+            intptr_t expectedLast = -1;
+            size_t expectedCount = 0;
+            for(size_t i = 0; i < size; ++i)
+            {
+                if(text[i] != 'c')
+                    continue;
+
+                if(expectedFirst < 0)
+                    expectedFirst = (intptr_t)i;
+                expectedLast = (intptr_t)i;
+                ++expectedCount;
+            }
+
+            TEST_ASSERT_EQUALS(expectedFirst, sysbvm_string_indexOfByte(size, text, 'c', 0));
+            TEST_ASSERT_EQUALS(expectedLast, sysbvm_string_lastIndexOfByte(size, text, 'c'));
+            TEST_ASSERT_EQUALS(expectedCount, sysbvm_string_countByte(size, text, 'c'));
+            TEST_ASSERT_EQUALS(size > 91 ? 90 : -1, sysbvm_string_indexOfSubstring(size, text, 2, (const uint8_t*)"Xa", 0));
+            intptr_t expectedLastSubstring = -1;
+            if(size >= 3)
+                expectedLastSubstring = (intptr_t)(size - 3 - (size - 3) % 7);
+            TEST_ASSERT_EQUALS(expectedLastSubstring, sysbvm_string_lastIndexOfSubstring(size, text, 3, (const uint8_t*)"abc"));
+        }
+
+        TEST_ASSERT_EQUALS(7, sysbvm_string_indexOfSubstring(sizeof(text), text, 3, (const uint8_t*)"abc", 1));
+        TEST_ASSERT_EQUALS(90, sysbvm_string_indexOfByteInClass(sizeof(text), text, 2, (const uint8_t*)"XY", true, 0));
+        TEST_ASSERT_EQUALS(7, sysbvm_string_indexOfByteInClass(sizeof(text), text, 6, (const uint8_t*)"bcdefg", false, 1));
+        TEST_ASSERT_EQUALS(-1, sysbvm_string_indexOfByteInClass(sizeof(text), text, 8, (const uint8_t*)"abcdefgX", false, 0));
+    }
+
+    TEST_CASE_WITH_FIXTURE(CompareBytes, TuuvmCore)
+    {
+        const char *first = "The quick brown fox jumps over the lazy dog.";
+        const char *second = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG.";
+        size_t size = strlen(first);
+
+        TEST_ASSERT_EQUALS(size, sysbvm_string_mismatchIndex(size, (const uint8_t*)first, (const uint8_t*)first));
+        TEST_ASSERT_EQUALS(1, sysbvm_string_mismatchIndex(size, (const uint8_t*)first, (const uint8_t*)second));
+        TEST_ASSERT_EQUALS(0, sysbvm_string_compareBytes(size, (const uint8_t*)first, size, (const uint8_t*)first));
+        TEST_ASSERT_EQUALS(1, sysbvm_string_compareBytes(size, (const uint8_t*)first, size, (const uint8_t*)second));
+        TEST_ASSERT_EQUALS(-1, sysbvm_string_compareBytes(size, (const uint8_t*)second, size, (const uint8_t*)first));
+        TEST_ASSERT_EQUALS(-1, sysbvm_string_compareBytes(size - 4, (const uint8_t*)first, size, (const uint8_t*)first));
+        TEST_ASSERT_EQUALS(1, sysbvm_string_compareBytes(size, (const uint8_t*)first, size - 4, (const uint8_t*)first));
+        TEST_ASSERT(sysbvm_string_equalsIgnoringCase(size, (const uint8_t*)first, (const uint8_t*)second));
+        TEST_ASSERT(!sysbvm_string_equalsIgnoringCase(size, (const uint8_t*)first, (const uint8_t*)"The quick brown fox jumps over the lazy dog!"));
+    }
 }
 
 
@@ -0,0 +1,41 @@
+#include "TestMacros.h"
+#include "sysbvm/stringStream.h"
+#include <string.h>
+
+TEST_SUITE(StringStream)
+{
+    TEST_CASE_WITH_FIXTURE(Empty, TuuvmCore)
+    {
+        sysbvm_tuple_t stringStream = sysbvm_stringStream_create(sysbvm_test_context);
+        TEST_ASSERT_EQUALS(0, sysbvm_stringStream_getSize(stringStream));
+        TEST_ASSERT_EQUALS(0, sysbvm_tuple_getSizeInBytes(sysbvm_stringStream_asString(sysbvm_test_context, stringStream)));
+    }
+
+    TEST_CASE_WITH_FIXTURE(SeveralChunks, TuuvmCore)
+    {
+        sysbvm_tuple_t stringStream = sysbvm_stringStream_create(sysbvm_test_context);
+        const char *text = "0123456789abcdefghijklmnopqrstuvwxyz";
+        size_t textSize = strlen(text);
+        for(size_t i = 0; i < 10000; ++i)
+        {
+            sysbvm_stringStream_nextPutStringWithSize(sysbvm_test_context, stringStream, i % textSize, text);
+            sysbvm_stringStream_nextPut(sysbvm_test_context, stringStream, '.');
+        }
+
+        sysbvm_tuple_t string = sysbvm_stringStream_asString(sysbvm_test_context, stringStream);
+        size_t size = sysbvm_tuple_getSizeInBytes(string);
+        TEST_ASSERT_EQUALS(sysbvm_stringStream_getSize(stringStream), size);
+        TEST_ASSERT(sysbvm_stringStream_getCapacity(stringStream) >= size);
+
+        const uint8_t *bytes = SYSBVM_CAST_OOP_TO_OBJECT_TUPLE(string)->bytes;
+        size_t offset = 0;
+        for(size_t i = 0; i < 10000; ++i)
+        {
+            size_t pieceSize = i % textSize;
+            TEST_ASSERT(memcmp(bytes + offset, text, pieceSize) == 0);
+            TEST_ASSERT_EQUALS('.', bytes[offset + pieceSize]);
+            offset += pieceSize + 1;
+        }
+        TEST_ASSERT_EQUALS(size, offset);
+    }
+}
@@ -0,0 +1,124 @@
+#include "TestMacros.h"
+#include "sysbvm/type.h"
+#include "sysbvm/dictionary.h"
+#include "sysbvm/function.h"
+#include "sysbvm/gc.h"
+#include "sysbvm/stackFrame.h"
+#include "sysbvm/string.h"
+
+static sysbvm_tuple_t testMethodEntryPoint(sysbvm_context_t *context, sysbvm_tuple_t closure, size_t argumentCount, sysbvm_tuple_t *arguments)
+{
+    (void)context;
+    (void)closure;
+    (void)argumentCount;
+    (void)arguments;
+    return SYSBVM_VOID_TUPLE;
+}
+
+static sysbvm_tuple_t testMethod(void)
+{
+    return sysbvm_function_createPrimitive(sysbvm_test_context, 1, SYSBVM_FUNCTION_FLAGS_NONE, NULL, testMethodEntryPoint);
+}
+
+TEST_SUITE(Type)
+{
+    TEST_CASE_WITH_FIXTURE(ReparentingDiscardsCachedLookups, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t selector = sysbvm_symbol_internWithCString(sysbvm_test_context, "testReparentedSelector");
+        sysbvm_tuple_t a = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t b = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t c = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t d = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_type_setSupertype(sysbvm_test_context, a, b);
+        sysbvm_type_setSupertype(sysbvm_test_context, b, c);
+
+        sysbvm_tuple_t methodInC = testMethod();
+        sysbvm_tuple_t methodInD = testMethod();
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, c, selector, methodInC);
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, d, selector, methodInD);
+        TEST_ASSERT_EQUALS(methodInC, sysbvm_type_lookupSelector(sysbvm_test_context, a, selector));
+        TEST_ASSERT_EQUALS(methodInC, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, a, selector, 0));
+
+        sysbvm_type_setSupertype(sysbvm_test_context, b, d);
+        TEST_ASSERT_EQUALS(methodInD, sysbvm_type_lookupSelector(sysbvm_test_context, a, selector));
+        TEST_ASSERT_EQUALS(methodInD, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, a, selector, 0));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(OverridingAMethodDiscardsTheDispatchTableSlotsOfTheSubtypes, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t selector = sysbvm_symbol_internWithCString(sysbvm_test_context, "testOverriddenVirtualSelector");
+        sysbvm_tuple_t a = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t b = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t c = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t d = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_type_setSupertype(sysbvm_test_context, a, b);
+        sysbvm_type_setSupertype(sysbvm_test_context, b, c);
+        sysbvm_type_setSupertype(sysbvm_test_context, d, c);
+
+        sysbvm_tuple_t methodInC = testMethod();
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, c, selector, methodInC);
+        TEST_ASSERT_EQUALS(methodInC, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, a, selector, 1));
+        TEST_ASSERT_EQUALS(methodInC, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, d, selector, 1));
+
+        sysbvm_tuple_t methodInB = testMethod();
+        sysbvm_type_setMethodWithSelector(sysbvm_test_context, b, selector, methodInB);
+        TEST_ASSERT_EQUALS(methodInB, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, a, selector, 1));
+        TEST_ASSERT_EQUALS(methodInB, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, b, selector, 1));
+        TEST_ASSERT_EQUALS(methodInC, sysbvm_type_lookupSelectorWithVirtualTableIndex(sysbvm_test_context, d, selector, 1));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(ReparentingAnAncestorUpdatesTheSupertypeDisplays, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t a = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t b = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t c = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t d = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_type_setSupertype(sysbvm_test_context, a, b);
+        sysbvm_type_setSupertype(sysbvm_test_context, b, c);
+        TEST_ASSERT(sysbvm_type_isSubtypeOf(sysbvm_test_context, a, c));
+        TEST_ASSERT(!sysbvm_type_isSubtypeOf(sysbvm_test_context, a, d));
+
+        sysbvm_type_setSupertype(sysbvm_test_context, b, d);
+        TEST_ASSERT(!sysbvm_type_isSubtypeOf(sysbvm_test_context, a, c));
+        TEST_ASSERT(sysbvm_type_isSubtypeOf(sysbvm_test_context, a, d));
+        TEST_ASSERT(sysbvm_type_isSubtypeOf(sysbvm_test_context, a, b));
+        TEST_ASSERT(sysbvm_type_isSubtypeOf(sysbvm_test_context, a, sysbvm_type_getSupertype(d)));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+
+    TEST_CASE_WITH_FIXTURE(ReplacingTheMethodDictionaryDiscardsCachedLookups, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_tuple_t selector = sysbvm_symbol_internWithCString(sysbvm_test_context, "testReplacedDictionarySelector");
+        sysbvm_tuple_t a = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t b = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_type_setSupertype(sysbvm_test_context, a, b);
+        TEST_ASSERT_EQUALS(SYSBVM_NULL_TUPLE, sysbvm_type_lookupSelector(sysbvm_test_context, a, selector));
+
+        sysbvm_tuple_t method = testMethod();
+        sysbvm_tuple_t methodDictionary = sysbvm_methodDictionary_create(sysbvm_test_context);
+        sysbvm_methodDictionary_atPut(sysbvm_test_context, methodDictionary, selector, method);
+        sysbvm_type_setMethodDictionary(sysbvm_test_context, b, methodDictionary);
+        TEST_ASSERT_EQUALS(method, sysbvm_type_lookupSelector(sysbvm_test_context, a, selector));
+
+        sysbvm_type_setMethodDictionary(sysbvm_test_context, b, sysbvm_methodDictionary_create(sysbvm_test_context));
+        TEST_ASSERT_EQUALS(SYSBVM_NULL_TUPLE, sysbvm_type_lookupSelector(sysbvm_test_context, a, selector));
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+    TEST_CASE_WITH_FIXTURE(ReferenceTypeCreationKeepsTheStackFrameBalanced, TuuvmCore)
+    {
+        sysbvm_gc_lock(sysbvm_test_context);
+        sysbvm_stackFrameRecord_t *activeRecord = sysbvm_stackFrame_getActiveRecord();
+        sysbvm_tuple_t baseType = sysbvm_type_createAnonymous(sysbvm_test_context);
+        sysbvm_tuple_t addressSpace = sysbvm_genericAddressSpace_uniqueInstance(sysbvm_test_context);
+        TEST_ASSERT(sysbvm_type_createReferenceType(sysbvm_test_context, baseType, addressSpace) != SYSBVM_NULL_TUPLE);
+        TEST_ASSERT(sysbvm_type_createTemporaryReferenceType(sysbvm_test_context, baseType, addressSpace) != SYSBVM_NULL_TUPLE);
+        TEST_ASSERT_EQUALS(activeRecord, sysbvm_stackFrame_getActiveRecord());
+        sysbvm_gc_unlock(sysbvm_test_context);
+    }
+}